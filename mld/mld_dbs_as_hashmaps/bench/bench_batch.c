@@ -0,0 +1,58 @@
+/*
+xmalloc/xfree one object at a time against xmalloc_batch/xfree_batch for N objects, three rounds
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_batch bench/bench_batch.c mld.c -lm -lpthread -ldl
+    /tmp/bench_batch 1000000
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+typedef struct Student {
+    char stud_name[32];
+    unsigned int rollno;
+    unsigned int age;
+    float aggregate;
+    struct Student *best_colleague;
+} Student;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv){
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo student_fields[] = {
+        FIELD_INFO(Student, stud_name, CHAR_TYPE, 0),
+        FIELD_INFO(Student, rollno, UINT32_TYPE, 0),
+        FIELD_INFO(Student, age, UINT32_TYPE, 0),
+        FIELD_INFO(Student, aggregate, FLOAT_TYPE, 0),
+        FIELD_INFO(Student, best_colleague, OBJECT_pointer_TYPE, Student)
+    };
+    REGISTER_STRUCTURE(struct_db, Student, student_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+
+    void **pointers = malloc((size_t)n * sizeof(void *));
+    for(int round = 0; round < 3; round++){
+        double t0 = now();
+        for(int i = 0; i < n; i++) pointers[i] = xmalloc(object_db, "Student", 1);
+        double t1 = now();
+        for(int i = 0; i < n; i++) xfree("Student", object_db, pointers[i]);
+        double t2 = now();
+        if(xmalloc_batch(object_db, "Student", n, pointers) != n){
+            printf("xmalloc_batch failed\n");
+            return 1;
+        }
+        double t3 = now();
+        xfree_batch(object_db, pointers, n);
+        double t4 = now();
+        printf("%d objects, loop alloc %.3fs free %.3fs | batch alloc %.3fs free %.3fs\n", n, t1 - t0, t2 - t1, t3 - t2, t4 - t3);
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+candidate filter throughput per kernel over pointer sparse & pointer dense word arrays
+the kernel is picked once per process, run once per kernel:
+    gcc -O2 -o /tmp/bench_candidate_filter bench/bench_candidate_filter.c mld.c -lm -lpthread -ldl
+    for k in scalar sse4.2 avx2; do MLD_FILTER_KERNEL=$k /tmp/bench_candidate_filter; done
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+#define OBJECTS 100000
+#define WORDS (1 << 22)
+#define ROUNDS 20
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//ns per word over ROUNDS passes, percent is the share of words which are live object addresses
+static double bench(const MldCandidateFilter *filter, void **objects, int percent, size_t *kept){
+    static uintptr_t words[WORDS], out[WORDS];
+    unsigned long long seed = 88172645463325252ULL;
+    for(size_t i = 0; i < WORDS; i++){
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        words[i] = (int)(seed % 100) < percent ? (uintptr_t)objects[seed % OBJECTS] : (uintptr_t)(seed >> 20);
+    }
+    double start = now();
+    for(int round = 0; round < ROUNDS; round++) *kept = mld_filter_candidates(filter, words, WORDS, out);
+    return (now() - start) / ((double)WORDS * ROUNDS) * 1e9;
+}
+
+int main(void){
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+
+    static void *objects[OBJECTS];
+    xmalloc_batch(object_db, "int", OBJECTS, objects);
+    MldCandidateFilter filter;
+    mld_candidate_filter_build(object_db, &filter);
+
+    printf("kernel %s\n", mld_filter_kernel_name());
+    int percents[] = {0, 1, 10, 50, 100};
+    for(int p = 0; p < 5; p++){
+        size_t kept;
+        double ns = bench(&filter, objects, percents[p], &kept);
+        printf("%3d%% pointers: %.2f ns/word, %zu kept of %d\n", percents[p], ns, kept, WORDS);
+    }
+    mld_candidate_filter_free(&filter);
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+xmalloc + xfree cost with & without the debug heap, for redzoned 48 byte blocks & guarded 64 KiB blocks
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_debug_heap bench/bench_debug_heap.c mld.c -lm -lpthread -ldl
+    /tmp/bench_debug_heap
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+typedef struct Small {
+    char bytes[48];
+} Small;
+
+typedef struct Big {
+    char bytes[65536];
+} Big;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static ObjectDb *make_object_db(MldBoolean debug){
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo small_fields[] = {FIELD_INFO(Small, bytes, CHAR_TYPE, 0)};
+    REGISTER_STRUCTURE(struct_db, Small, small_fields);
+    static FieldInfo big_fields[] = {FIELD_INFO(Big, bytes, CHAR_TYPE, 0)};
+    REGISTER_STRUCTURE(struct_db, Big, big_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+    if(debug) mld_enable_debug_heap(object_db, 16384, 1 << 20);
+    return object_db;
+}
+
+//ns per xmalloc + xfree pair
+static double bench(ObjectDb *object_db, char *structure_name, int n){
+    void **pointers = malloc((size_t)n * sizeof(void *));
+    double start = now();
+    for(int i = 0; i < n; i++) pointers[i] = xmalloc(object_db, structure_name, 1);
+    for(int i = 0; i < n; i++) xfree(structure_name, object_db, pointers[i]);
+    double elapsed = now() - start;
+    free(pointers);
+    return elapsed / n * 1e9;
+}
+
+int main(void){
+    ObjectDb *plain = make_object_db(MLD_FALSE), *debug = make_object_db(MLD_TRUE);
+    for(int round = 0; round < 3; round++){
+        printf("48 B:   plain %.0f ns, debug %.0f ns per xmalloc + xfree\n", bench(plain, "Small", 200000), bench(debug, "Small", 200000));
+        printf("64 KiB: plain %.0f ns, debug %.0f ns per xmalloc + xfree\n", bench(plain, "Big", 5000), bench(debug, "Big", 5000));
+    }
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+minor against full scan time with 90% of N objects old & 10% young
+young objects hang off old nodes via MLD_STORE, are chained from a young root or leak (45%, 45%, 10%)
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_generations bench/bench_generations.c mld.c -lm -lpthread -ldl
+    /tmp/bench_generations 1000000
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+typedef struct Node {
+    struct Node *left, *right, *young;
+    int value;
+} Node;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned long leaked_objects(ObjectDb *object_db){
+    unsigned long leaked = 0;
+    for(unsigned int i = 0; i < object_db->table_size; i++)
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next) leaked += !obj_rec->is_visited;
+    return leaked;
+}
+
+int main(int argc, char **argv){
+    long n = argc > 1 ? atol(argv[1]) : 1000000, old = n * 9 / 10, young = n - old;
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, left, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, right, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, young, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+
+    Node **tree = malloc((size_t)old * sizeof(Node *));
+    for(long i = 0; i < old; i++){
+        tree[i] = xcalloc(object_db, "Node", 1);
+        if(i && i % 2) tree[(i - 1) / 2]->left = tree[i];
+        else if(i) tree[(i - 1) / 2]->right = tree[i];
+    }
+    set_dynamic_object_as_root("Node", object_db, tree[0]);
+    mld_enable_generations(object_db, 2, 8);
+    run_mld_algorithm(object_db);
+    run_mld_algorithm(object_db);
+
+    unsigned long long seed = 88172645463325252ULL;
+    Node *young_root = xcalloc(object_db, "Node", 1), *tail = young_root;
+    set_dynamic_object_as_root("Node", object_db, young_root);
+    long expected_leaks = 0;
+    for(long i = 1; i < young; i++){
+        Node *node = xcalloc(object_db, "Node", 1);
+        if(i % 20 < 9){
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            Node *owner = tree[seed % old];
+            node->young = owner->young;
+            MLD_STORE(object_db, owner, owner->young, node);
+        }else if(i % 20 < 18){
+            tail->young = node;
+            tail = node;
+        }else{
+            expected_leaks++;
+        }
+    }
+    object_db->generations->promote_after = 1000; //keeps the young set fixed while timing
+
+    printf("%ld objects, %u young\n", n, object_db->generations->young_count);
+    for(int round = 0; round < 3; round++){
+        double t0 = now();
+        mld_run_minor_scan(object_db);
+        double t1 = now();
+        unsigned long minor_leaks = leaked_objects(object_db);
+        double t2 = now();
+        mld_run_full_scan(object_db);
+        double t3 = now();
+        printf("minor %.1f ms leaked %lu | full %.1f ms leaked %lu | expected %ld, remembered %u\n",
+               (t1 - t0) * 1e3, minor_leaks, (t3 - t2) * 1e3, leaked_objects(object_db), expected_leaks,
+               object_db->generations->remembered_count);
+    }
+    return 0;
+}
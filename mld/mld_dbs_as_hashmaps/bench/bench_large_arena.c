@@ -0,0 +1,99 @@
+/*
+large block allocation & scan throughput with libc, the large object arena & the arena with huge pages (mode 0, 1, 2)
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_large_arena bench/bench_large_arena.c mld.c -lm -lpthread -ldl
+    for m in 0 1 2; do /tmp/bench_large_arena $m; done
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+#define NODES 1024
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+typedef struct Slot { //pointer dense
+    Node *node;
+} Slot;
+
+typedef struct Record { //one pointer per 32 bytes
+    Node *node;
+    long a, b, c;
+} Record;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv){
+    int mode = argc > 1 ? atoi(argv[1]) : 1;
+    const char *names[] = {"libc", "arena", "arena+thp"};
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    static FieldInfo slot_fields[] = {FIELD_INFO(Slot, node, OBJECT_pointer_TYPE, Node)};
+    REGISTER_STRUCTURE(struct_db, Slot, slot_fields);
+    static FieldInfo record_fields[] = {
+        FIELD_INFO(Record, node, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Record, a, UINT32_TYPE, 0),
+        FIELD_INFO(Record, b, UINT32_TYPE, 0),
+        FIELD_INFO(Record, c, UINT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Record, record_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+    if(mode) mld_enable_large_arena(object_db, 0, mode == 2);
+
+    size_t sizes[] = {1u << 20, 16u << 20, 256u << 20};
+    for(int s = 0; s < 3; s++){
+        size_t size = sizes[s];
+        int rounds = (int)((4ull << 30) / size);
+        if(rounds > 200) rounds = 200;
+        unsigned int slot_count = size / sizeof(Slot), record_count = size / sizeof(Record);
+
+        double t0 = now();
+        for(int r = 0; r < rounds; r++) xfree("Slot", object_db, xcalloc(object_db, "Slot", slot_count));
+        double t1 = now();
+        for(int r = 0; r < (rounds + 3) / 4; r++){
+            char *bytes = xcalloc(object_db, "Slot", slot_count);
+            for(size_t o = 0; o < size; o += 4096) bytes[o] = 1;
+            xfree("Slot", object_db, bytes);
+        }
+        double t2 = now();
+
+        //1 in 64 slots & 1 in 16 records point to one of NODES tracked nodes
+        Node *nodes[NODES];
+        for(int i = 0; i < NODES; i++) nodes[i] = xcalloc(object_db, "Node", 1);
+        Slot *slots = xcalloc(object_db, "Slot", slot_count);
+        for(unsigned int i = 0; i < slot_count; i += 64) slots[i].node = nodes[i / 64 % NODES];
+        set_dynamic_object_as_root("Slot", object_db, slots);
+        double t3 = now();
+        run_mld_algorithm(object_db);
+        double t4 = now();
+        xfree("Slot", object_db, slots);
+
+        Record *records = xcalloc(object_db, "Record", record_count);
+        for(unsigned int i = 0; i < record_count; i += 16) records[i].node = nodes[i / 16 % NODES];
+        set_dynamic_object_as_root("Record", object_db, records);
+        double t5 = now();
+        run_mld_algorithm(object_db);
+        double t6 = now();
+        xfree("Record", object_db, records);
+        for(int i = 0; i < NODES; i++) xfree("Node", object_db, nodes[i]);
+
+        printf("%-9s %4zu MB  calloc+free %8.1f us  calloc+touch+free %6.2f GB/s  scan dense %6.2f GB/s  scan 1 ptr/32 B %6.2f GB/s\n",
+               names[mode], size >> 20, (t1 - t0) / rounds * 1e6, size * (double)((rounds + 3) / 4) / (t2 - t1) / 1e9,
+               size / (t4 - t3) / 1e9, size / (t6 - t5) / 1e9);
+    }
+    return 0;
+}
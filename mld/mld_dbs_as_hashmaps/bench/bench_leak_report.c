@@ -0,0 +1,76 @@
+/*
+streaming leak report writer against report_leaked_objects, N leaked objects written to /dev/null
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_leak_report bench/bench_leak_report.c mld.c -lm -lpthread -ldl
+    /tmp/bench_leak_report 1000000
+*/
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "../mld.h"
+
+typedef struct Student {
+    char stud_name[32];
+    unsigned int rollno;
+    unsigned int age;
+    float aggregate;
+    struct Student *best_colleague;
+} Student;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv){
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo student_fields[] = {
+        FIELD_INFO(Student, stud_name, CHAR_TYPE, 0),
+        FIELD_INFO(Student, rollno, UINT32_TYPE, 0),
+        FIELD_INFO(Student, age, UINT32_TYPE, 0),
+        FIELD_INFO(Student, aggregate, FLOAT_TYPE, 0),
+        FIELD_INFO(Student, best_colleague, OBJECT_pointer_TYPE, Student)
+    };
+    REGISTER_STRUCTURE(struct_db, Student, student_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+
+    void **pointers = malloc((size_t)n * sizeof(void *));
+    xmalloc_batch(object_db, "Student", n, pointers);
+    for(int i = 0; i < n; i++){
+        memset(pointers[i], 0, sizeof(Student));
+        strcpy(((Student *)pointers[i])->stud_name, "Jo\"hn");
+    }
+    run_mld_algorithm(object_db);
+
+    int fd = open("/dev/null", O_WRONLY);
+    double t0 = now();
+    long jsonl = mld_write_leak_report(object_db, fd, MLD_REPORT_JSONL, MLD_FALSE, MLD_FALSE);
+    double t1 = now();
+    long csv = mld_write_leak_report(object_db, fd, MLD_REPORT_CSV, MLD_FALSE, MLD_TRUE);
+    double t2 = now();
+    long aggregate = mld_write_leak_report(object_db, fd, MLD_REPORT_JSONL, MLD_TRUE, MLD_FALSE);
+    double t3 = now();
+    close(fd);
+
+    //report_leaked_objects prints to stdout, which is sent to /dev/null for the measurement
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    if(!freopen("/dev/null", "w", stdout)) return 1;
+    double t4 = now();
+    report_leaked_objects(object_db);
+    fflush(stdout);
+    double t5 = now();
+    dup2(saved_stdout, 1);
+
+    fprintf(stderr, "%d leaked objects\n", n);
+    fprintf(stderr, "jsonl %ld records %.3fs | csv with fields %ld records %.3fs | aggregate %ld records %.3fs\n",
+            jsonl, t1 - t0, csv, t2 - t1, aggregate, t3 - t2);
+    fprintf(stderr, "report_leaked_objects %.3fs\n", t5 - t4);
+    return 0;
+}
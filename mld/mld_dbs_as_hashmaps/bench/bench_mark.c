@@ -0,0 +1,59 @@
+/*
+mark throughput of run_mld_algorithm on a random graph of N objects with two pointers each, one root
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_mark bench/bench_mark.c mld.c -lm -lpthread -ldl
+    /tmp/bench_mark 4000000
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+typedef struct Node {
+    struct Node *left, *right;
+    int value;
+} Node;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv){
+    long n = argc > 1 ? atol(argv[1]) : 4000000;
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, left, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, right, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+
+    Node **nodes = malloc((size_t)n * sizeof(Node *));
+    for(long i = 0; i < n; i++) nodes[i] = xcalloc(object_db, "Node", 1);
+    unsigned long long seed = 88172645463325252ULL;
+    for(long i = 0; i < n; i++){
+        for(int c = 0; c < 2; c++){
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            if(c) nodes[i]->right = nodes[seed % n];
+            else nodes[i]->left = nodes[seed % n];
+        }
+    }
+    set_dynamic_object_as_root("Node", object_db, nodes[0]);
+
+    double start = now();
+    run_mld_algorithm(object_db);
+    double elapsed = now() - start;
+
+    unsigned long reached = 0;
+    for(unsigned int i = 0; i < object_db->table_size; i++)
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next) reached += obj_rec->is_visited;
+    printf("%u objects, %lu reached, mark %.3fs, %.2f M edges/s\n", object_db->count, reached, elapsed, 2.0 * reached / elapsed / 1e6);
+    return 0;
+}
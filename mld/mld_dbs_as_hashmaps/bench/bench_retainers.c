@@ -0,0 +1,53 @@
+/*
+mld_compute_top_retainers on a heap shaped binary tree of N nodes, with back edges from the leaves into a subtree to form cycles
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_retainers bench/bench_retainers.c mld.c -lm -lpthread -ldl
+    /tmp/bench_retainers 10000000
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+typedef struct Node {
+    int value;
+    struct Node *left, *right;
+} Node;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv){
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, value, INT32_TYPE, 0),
+        FIELD_INFO(Node, left, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, right, OBJECT_pointer_TYPE, Node)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+
+    Node **nodes = malloc((size_t)n * sizeof(Node *));
+    xmalloc_batch(object_db, "Node", n, (void **)nodes);
+    for(int i = 0; i < n; i++){
+        nodes[i]->value = i;
+        nodes[i]->left = 2L * i + 1 < n ? nodes[2 * i + 1] : NULL;
+        nodes[i]->right = 2L * i + 2 < n ? nodes[2 * i + 2] : NULL;
+    }
+    for(int i = 5; i < n; i += 3) if(!nodes[i]->left) nodes[i]->left = nodes[2];
+    set_dynamic_object_as_root("Node", object_db, nodes[0]);
+
+    MldRetainer top[5];
+    double start = now();
+    int count = mld_compute_top_retainers(object_db, top, 5);
+    double elapsed = now() - start;
+    print_top_retainers(top, count);
+    printf("%d objects, %.3fs\n", n, elapsed);
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+allocation, free & scan of N small objects of two types with & without the slab heap (mode 0 libc, mode 1 slabs)
+80% of the objects are chained from two roots, half of the other 20% are freed, the rest leak
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_slab_heap bench/bench_slab_heap.c mld.c -lm -lpthread -ldl
+    for m in 0 1; do /tmp/bench_slab_heap $m 10000000; done
+*/
+
+#include <sys/resource.h>
+#include <time.h>
+#include "../mld.h"
+
+typedef struct Employee {
+    char emp_name[30];
+    unsigned int emp_id;
+    unsigned int age;
+    struct Employee *mgr;
+    float salary;
+} Employee;
+
+typedef struct Student {
+    char stud_name[32];
+    unsigned int rollno;
+    unsigned int age;
+    float aggregate;
+    struct Student *best_colleague;
+} Student;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static unsigned long leaked_objects(ObjectDb *object_db){
+    unsigned long leaked = mld_slab_leaked_objects(object_db);
+    for(unsigned int i = 0; i < object_db->table_size; i++)
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next) leaked += !obj_rec->is_visited;
+    return leaked;
+}
+
+int main(int argc, char **argv){
+    int slabs = argc > 1 && atoi(argv[1]);
+    long n = argc > 2 ? atol(argv[2]) : 10000000;
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo emp_fields[] = {
+        FIELD_INFO(Employee, emp_name, CHAR_TYPE, 0),
+        FIELD_INFO(Employee, emp_id, UINT32_TYPE, 0),
+        FIELD_INFO(Employee, age, UINT32_TYPE, 0),
+        FIELD_INFO(Employee, mgr, OBJECT_pointer_TYPE, Employee),
+        FIELD_INFO(Employee, salary, FLOAT_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Employee, emp_fields);
+    static FieldInfo student_fields[] = {
+        FIELD_INFO(Student, stud_name, CHAR_TYPE, 0),
+        FIELD_INFO(Student, rollno, UINT32_TYPE, 0),
+        FIELD_INFO(Student, age, UINT32_TYPE, 0),
+        FIELD_INFO(Student, aggregate, FLOAT_TYPE, 0),
+        FIELD_INFO(Student, best_colleague, OBJECT_pointer_TYPE, Student)
+    };
+    REGISTER_STRUCTURE(struct_db, Student, student_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+    if(slabs) mld_enable_slab_heap(object_db);
+
+    void **lost = malloc((size_t)(n / 5 + 1) * sizeof(void *));
+    long lost_count = 0;
+    Employee *last_employee = NULL;
+    Student *last_student = NULL;
+
+    double t0 = now();
+    for(long i = 0; i < n; i++){
+        if(i & 1){
+            Student *student = xmalloc(object_db, "Student", 1);
+            student->rollno = i;
+            student->best_colleague = NULL;
+            if(i % 10 != 9){
+                student->best_colleague = last_student;
+                last_student = student;
+            }else{
+                lost[lost_count++] = student;
+            }
+        }else{
+            Employee *employee = xmalloc(object_db, "Employee", 1);
+            employee->emp_id = i;
+            employee->mgr = NULL;
+            if(i % 10 != 8){
+                employee->mgr = last_employee;
+                last_employee = employee;
+            }else{
+                lost[lost_count++] = employee;
+            }
+        }
+    }
+    double t1 = now();
+    for(long i = 0; i < lost_count; i += 2) xfree(NULL, object_db, lost[i]);
+    double t2 = now();
+    set_dynamic_object_as_root("Student", object_db, last_student);
+    set_dynamic_object_as_root("Employee", object_db, last_employee);
+    double t3 = now();
+    run_mld_algorithm(object_db);
+    double t4 = now();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%s %ld objects, alloc %.2fs (%.0f ns/object) free %.3fs scan %.2fs, leaked %lu (expected %ld), records %u, maxrss %ld MiB\n",
+           slabs ? "slab " : "libc ", n, t1 - t0, (t1 - t0) / n * 1e9, t2 - t1, t4 - t3, leaked_objects(object_db),
+           lost_count / 2, object_db->count, usage.ru_maxrss / 1024);
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+heap snapshot write, open & offline mark for N objects, a chain through 90% of them hangs off one root, the rest leak
+build & run from mld/mld_dbs_as_hashmaps:
+    gcc -O2 -o /tmp/bench_snapshot bench/bench_snapshot.c mld.c -lm -lpthread -ldl
+    /tmp/bench_snapshot 1000000 /tmp/bench.mld
+*/
+
+#include <time.h>
+#include "../mld.h"
+
+typedef struct Student {
+    char stud_name[32];
+    unsigned int rollno;
+    unsigned int age;
+    float aggregate;
+    struct Student *best_colleague;
+} Student;
+
+static double now(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv){
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    const char *path = argc > 2 ? argv[2] : "/tmp/bench_snapshot.mld";
+
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo student_fields[] = {
+        FIELD_INFO(Student, stud_name, CHAR_TYPE, 0),
+        FIELD_INFO(Student, rollno, UINT32_TYPE, 0),
+        FIELD_INFO(Student, age, UINT32_TYPE, 0),
+        FIELD_INFO(Student, aggregate, FLOAT_TYPE, 0),
+        FIELD_INFO(Student, best_colleague, OBJECT_pointer_TYPE, Student)
+    };
+    REGISTER_STRUCTURE(struct_db, Student, student_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    object_db->struct_db = struct_db;
+
+    Student **students = malloc((size_t)n * sizeof(Student *));
+    xmalloc_batch(object_db, "Student", n, (void **)students);
+    for(int i = 0; i < n; i++) memset(students[i], 0, sizeof(Student));
+    int reachable = n - n / 10;
+    for(int i = 0; i + 1 < reachable; i++) students[i]->best_colleague = students[i + 1];
+    set_dynamic_object_as_root("Student", object_db, students[0]);
+
+    double t0 = now();
+    if(mld_snapshot_write(object_db, path, MLD_TRUE) != 0){
+        printf("mld_snapshot_write failed\n");
+        return 1;
+    }
+    double t1 = now();
+    MldSnapshot snapshot;
+    if(mld_snapshot_open(path, &snapshot) != 0){
+        printf("mld_snapshot_open failed\n");
+        return 1;
+    }
+    double t2 = now();
+    unsigned long leaked = mld_snapshot_run_mld_algorithm(&snapshot);
+    double t3 = now();
+
+    printf("%d objects, %zu MB, write %.3fs open %.6fs mark %.3fs, leaked %lu (expected %d)\n",
+           n, snapshot.size >> 20, t1 - t0, t2 - t1, t3 - t2, leaked, n - reachable);
+    mld_snapshot_close(&snapshot);
+    remove(path);
+    return 0;
+}
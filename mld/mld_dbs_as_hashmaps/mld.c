@@ -1,14 +1,23 @@
 //implementing the functions declared in mld.h
 
+#define _GNU_SOURCE //mremap
 #include "mld.h"
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <signal.h>
+#include <semaphore.h>
+#include <link.h>
+#include <limits.h>
 
 /*
 as dbs are modeled as hashmaps, the functions to add a structure to the db, lookup a structure in the db, print a structure record, print the db, are implemented here
 */
 
-//table size is a prime number
-#define TABLE_SIZE 101
-
 //hash function is a polynomial rolling hash function, given string as input, returns a hash value which is an integer
 unsigned int polynonial_rolling_hash(const char *key){
     unsigned int hash = 0;
@@ -21,6 +30,49 @@ unsigned int polynonial_rolling_hash(const char *key){
     return hash;
 }
 
+//object db hash, key is the object address, low bits are dropped as malloc'd blocks are at least 16 byte aligned
+//the bucket is taken from the high, well mixed bits of the product, as many as the table size needs, table must exist
+unsigned int object_db_hash_pointer(ObjectDb *object_db, void *pointer){
+    uint64_t key = (uintptr_t)pointer >> 4;
+    key ^= key >> 17;
+    return (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (object_db->table_size - 1);
+}
+
+/*
+makes room for count records, the table doubles until it has at least one bucket per record, so chains stay short
+records are relinked into the new table, never copied, pointers to them stay valid
+a pending sweep walks buckets by index, the table does not grow until it is done
+*/
+static void mld_object_table_reserve(ObjectDb *object_db, unsigned long count){
+    unsigned int old_size = object_db->table_size;
+    if(old_size && (count <= old_size || object_db->sweep.pending)) return;
+
+    unsigned int size = old_size ? old_size : MLD_OBJECT_TABLE_MIN;
+    while(size < count && size < (1u << 31)) size *= 2;
+    ObjectDbRecord **old_table = object_db->object_db_arr;
+    ObjectDbRecord **table = calloc(size, sizeof(ObjectDbRecord *));
+    if(!table){
+        //a full table is only slower
+        if(old_size) return;
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    object_db->object_db_arr = table;
+    object_db->table_size = size;
+    for(unsigned int i = 0; i < old_size; i++){
+        ObjectDbRecord *obj_rec = old_table[i];
+        while(obj_rec){
+            ObjectDbRecord *next = obj_rec->next;
+            unsigned int hash = object_db_hash_pointer(object_db, obj_rec->pointer);
+            obj_rec->next = table[hash];
+            table[hash] = obj_rec;
+            obj_rec = next;
+        }
+    }
+    free(old_table);
+}
+
 char *DataTypes[] = {
     "UINT8_TYPE",
     "UINT32_TYPE",
@@ -30,7 +82,9 @@ char *DataTypes[] = {
     "DOUBLE_TYPE",
     "OBJECT_pointer_TYPE",
     "OBJECT_STRUCT_TYPE",
-    "VOID_pointer_TYPE"
+    "VOID_pointer_TYPE",
+    "OBJECT_pointer_ARRAY_TYPE",
+    "OBJECT_pointer_DYNAMIC_ARRAY_TYPE"
 };
 
 void print_structure_record(StructureDbRecord *structure_record) {
@@ -60,7 +114,10 @@ void print_structure_record(StructureDbRecord *structure_record) {
                (field->data_type == FLOAT_TYPE) ? "FLOAT" :
                (field->data_type == DOUBLE_TYPE) ? "DOUBLE" :
                (field->data_type == OBJECT_pointer_TYPE) ? "OBJ_PTR" :
-               (field->data_type == VOID_pointer_TYPE) ? "VOID_PTR" : "UNKNOWN",
+               (field->data_type == OBJECT_STRUCT_TYPE) ? "OBJ_STRUCT" :
+               (field->data_type == VOID_pointer_TYPE) ? "VOID_PTR" :
+               (field->data_type == OBJECT_pointer_ARRAY_TYPE) ? "OBJ_PTR_ARRAY" :
+               (field->data_type == OBJECT_pointer_DYNAMIC_ARRAY_TYPE) ? "OBJ_PTR_DYNARR" : "UNKNOWN",
                field->size,
                field->offset,
                field->nested_structure_name[0] ? field->nested_structure_name : "N/A");
@@ -75,7 +132,7 @@ void print_structure_database(StructureDb *struct_db){
     printf("Printing STRUCTURE DATABASE\n");
 
     //iterate through the hash table of structure db, to print all the structure records
-    for(int i = 0; i<TABLE_SIZE-1; i++){
+    for(int i = 0; i<TABLE_SIZE; i++){
         StructureDbRecord *structure_record = struct_db->structutre_db_arr[i];
         for(; structure_record; structure_record = structure_record->next){
             print_structure_record(structure_record);
@@ -85,7 +142,111 @@ void print_structure_database(StructureDb *struct_db){
     printf("End of STRUCTURE DATABASE\n");
 }
 
+//leak statistics, per thread counter blocks chained on a global list, see mld.h
+typedef struct MldThreadStats MldThreadStats;
+
+struct MldThreadStats {
+    MldThreadStats *next;
+    unsigned long allocs;
+    unsigned long frees;
+    long live_objects[MLD_MAX_STATS_TYPES];
+    long live_bytes[MLD_MAX_STATS_TYPES];
+};
+
+static MldThreadStats *mld_all_thread_stats;
+static __thread MldThreadStats *mld_thread_stats __attribute__((tls_model("initial-exec")));
+static StructureDbRecord *mld_stats_types[MLD_MAX_STATS_TYPES];
+static unsigned int mld_stats_type_count;
+static long mld_stats_peak_bytes;
+
+/*
+flattened pointer offsets, the marker scans a unit as one loop over these instead of walking FieldInfo
+OBJECT_STRUCT_TYPE members are expanded in place, an embedded array of n structs contributes n copies of the nested offsets
+a fixed pointer array contributes one offset per element, dynamic pointer arrays go to a separate list
+nesting deeper than MLD_MAX_NESTING_DEPTH is taken as a cycle & cut off
+*/
+#define MLD_MAX_NESTING_DEPTH 32
+
+typedef struct MldOffsetList {
+    unsigned int *offsets;
+    unsigned int count;
+    unsigned int capacity;
+} MldOffsetList;
+
+static void mld_offset_list_push(MldOffsetList *list, unsigned int offset){
+    if(list->count == list->capacity){
+        list->capacity = list->capacity ? list->capacity * 2 : 8;
+        list->offsets = realloc(list->offsets, list->capacity * sizeof(unsigned int));
+        if(!list->offsets){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    list->offsets[list->count++] = offset;
+}
+
+//returns MLD_TRUE if some nested structure could not be resolved
+static MldBoolean mld_flatten_pointer_fields(StructureDb *struct_db, StructureDbRecord *structure_record,
+                                             unsigned int base, int depth, MldOffsetList *list, StructureDbRecord *flat){
+    MldBoolean pending = MLD_FALSE;
+    if(depth > MLD_MAX_NESTING_DEPTH) return pending;
+
+    for(unsigned int i = 0; i<structure_record->field_count; i++){
+        FieldInfo *field = &structure_record->fields[i];
+        if(field->data_type == OBJECT_pointer_TYPE || field->data_type == VOID_pointer_TYPE){
+            mld_offset_list_push(list, base + field->offset);
+        }else if(field->data_type == OBJECT_pointer_ARRAY_TYPE){
+            for(unsigned int element = 0; element < field->size / sizeof(void *); element++)
+                mld_offset_list_push(list, base + field->offset + element * sizeof(void *));
+        }else if(field->data_type == OBJECT_pointer_DYNAMIC_ARRAY_TYPE){
+            flat->pointer_arrays = realloc(flat->pointer_arrays, (flat->pointer_array_count + 1) * sizeof(MldPointerArrayField));
+            if(!flat->pointer_arrays){
+                printf("Memory allocation failed.\n");
+                exit(1);
+            }
+            MldPointerArrayField *array = &flat->pointer_arrays[flat->pointer_array_count++];
+            array->offset = base + field->offset;
+            array->length_offset = base + field->length_offset;
+            array->length_size = field->length_size;
+        }else if(field->data_type == OBJECT_STRUCT_TYPE){
+            StructureDbRecord *nested = struct_db_lookup(struct_db, field->nested_structure_name);
+            if(!nested){
+                pending = MLD_TRUE;
+                continue;
+            }
+            if(!nested->structure_size) continue;
+            for(unsigned int element = 0; element < field->size / nested->structure_size; element++){
+                if(mld_flatten_pointer_fields(struct_db, nested, base + field->offset + element * nested->structure_size,
+                                              depth + 1, list, flat))
+                    pending = MLD_TRUE;
+            }
+        }
+    }
+    return pending;
+}
+
+static void mld_build_pointer_offsets(StructureDb *struct_db, StructureDbRecord *structure_record){
+    MldOffsetList list = {structure_record->pointer_offsets, 0, structure_record->pointer_offset_count};
+    structure_record->pointer_array_count = 0;
+    structure_record->pointer_offsets_pending = mld_flatten_pointer_fields(struct_db, structure_record, 0, 0, &list, structure_record);
+    structure_record->pointer_offsets = list.offsets;
+    structure_record->pointer_offset_count = list.count;
+
+    MldBoolean dense = structure_record->structure_size && list.count * sizeof(uintptr_t) == structure_record->structure_size;
+    for(unsigned int k = 0; dense && k < list.count; k++) dense = list.offsets[k] == k * sizeof(uintptr_t);
+    structure_record->pointer_dense = dense;
+}
+
 int add_structure_to_database(StructureDb *struct_db, StructureDbRecord *structure_record){
+    //a frozen db is read lock free, it can not take new structures
+    if(struct_db->frozen) return -1;
+
+    //reserve a statistics slot, the last slot is never owned, every type past the others shares it
+    unsigned int stats_index = __atomic_fetch_add(&mld_stats_type_count, 1, __ATOMIC_RELAXED);
+    if(stats_index >= MLD_STATS_OVERFLOW_SLOT) stats_index = MLD_STATS_OVERFLOW_SLOT;
+    else __atomic_store_n(&mld_stats_types[stats_index], structure_record, __ATOMIC_RELEASE);
+    structure_record->stats_index = stats_index;
+
     //get the hash value of the structure name
     unsigned int hash = polynonial_rolling_hash(structure_record->structure_name);
 
@@ -97,6 +258,17 @@ int add_structure_to_database(StructureDb *struct_db, StructureDbRecord *structu
         struct_db->structutre_db_arr[hash] = structure_record;
     }
     struct_db->count++;
+
+    //flatten this structure, and every structure which was waiting for one of its nested types
+    structure_record->pointer_offsets = NULL;
+    structure_record->pointer_offset_count = 0;
+    structure_record->pointer_arrays = NULL;
+    mld_build_pointer_offsets(struct_db, structure_record);
+    for(int i = 0; i<TABLE_SIZE; i++){
+        for(StructureDbRecord *record = struct_db->structutre_db_arr[i]; record; record = record->next){
+            if(record->pointer_offsets_pending) mld_build_pointer_offsets(struct_db, record);
+        }
+    }
     return 0;
 }
 
@@ -106,7 +278,159 @@ if the hash value is already occupied, then the new structure record is added to
 if the hash value is not occupied, then the new structure record is added to the hash table
 */
 
+void mld_struct_db_install_perfect_hash(StructureDb *struct_db, StructureDbRecord **slots, uint32_t slot_count,
+                                        const uint32_t *seeds, uint32_t bucket_count){
+    assert(slot_count && bucket_count);
+    struct_db->perfect_slots = slots;
+    struct_db->perfect_seeds = seeds;
+    struct_db->perfect_slot_count = slot_count;
+    struct_db->perfect_bucket_count = bucket_count;
+    struct_db->perfect_count = struct_db->count;
+}
+
+/*
+hash & displace, names are grouped into buckets by mld_struct_name_hash(name) % bucket_count,
+buckets are placed largest first, each gets the first seed which sends all its names to free slots
+slot count starts at the name count (minimal), it grows only if some bucket finds no seed
+*/
+void mld_build_perfect_hash(char **names, uint32_t count, int **slots_out, uint32_t *slot_count_out,
+                            uint32_t **seeds_out, uint32_t *bucket_count_out){
+    uint32_t bucket_count = count / 2 + 1;
+    uint32_t *bucket_of = calloc(count, sizeof(uint32_t));
+    uint32_t *bucket_size = calloc(bucket_count, sizeof(uint32_t));
+    uint32_t *order = calloc(bucket_count, sizeof(uint32_t));
+    uint32_t *seeds = calloc(bucket_count, sizeof(uint32_t));
+    uint32_t *trial = calloc(count + 1, sizeof(uint32_t));
+    uint64_t *hashes = calloc(count + 1, sizeof(uint64_t));
+    uint32_t *bucket_start = calloc(bucket_count + 1, sizeof(uint32_t));
+    uint32_t *members = calloc(count + 1, sizeof(uint32_t));
+    if(!bucket_of || !bucket_size || !order || !seeds || !trial || !hashes || !bucket_start || !members){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    for(uint32_t i = 0; i<count; i++){
+        hashes[i] = mld_struct_name_hash(names[i]);
+        bucket_of[i] = hashes[i] % bucket_count;
+        bucket_size[bucket_of[i]]++;
+    }
+    //names grouped by bucket, members[bucket_start[b] .. bucket_start[b + 1])
+    for(uint32_t b = 0; b<bucket_count; b++) bucket_start[b + 1] = bucket_start[b] + bucket_size[b];
+    for(uint32_t i = 0; i<count; i++) members[bucket_start[bucket_of[i]] + --bucket_size[bucket_of[i]]] = i;
+    for(uint32_t b = 0; b<bucket_count; b++) bucket_size[b] = bucket_start[b + 1] - bucket_start[b];
+    for(uint32_t b = 0; b<bucket_count; b++) order[b] = b;
+    //largest buckets first, insertion sort is fine for a few hundred buckets
+    for(uint32_t b = 1; b<bucket_count; b++){
+        uint32_t key = order[b], j = b;
+        for(; j > 0 && bucket_size[order[j - 1]] < bucket_size[key]; j--) order[j] = order[j - 1];
+        order[j] = key;
+    }
+
+    for(uint32_t slot_count = count ? count : 1; ; slot_count++){
+        int *slots = malloc(slot_count * sizeof(int));
+        if(!slots){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        for(uint32_t s = 0; s<slot_count; s++) slots[s] = -1;
+
+        int placed_all = 1;
+        for(uint32_t o = 0; o<bucket_count && placed_all; o++){
+            uint32_t b = order[o];
+            seeds[b] = 0;
+            if(!bucket_size[b]) continue;
+
+            int placed = 0;
+            for(uint32_t seed = 1; seed < MLD_PERFECT_HASH_SEED_TRIES && !placed; seed++){
+                uint32_t n = 0;
+                placed = 1;
+                for(uint32_t m = bucket_start[b]; m<bucket_start[b + 1] && placed; m++){
+                    uint32_t slot = mld_struct_name_slot(hashes[members[m]], seed, slot_count);
+                    if(slots[slot] != -1) placed = 0;
+                    for(uint32_t k = 0; k<n && placed; k++){
+                        if(trial[k] == slot) placed = 0;
+                    }
+                    trial[n++] = slot;
+                }
+                if(placed){
+                    seeds[b] = seed;
+                    for(uint32_t k = 0; k<n; k++) slots[trial[k]] = (int)members[bucket_start[b] + k];
+                }
+            }
+            placed_all = placed;
+        }
+
+        if(placed_all){
+            *slots_out = slots;
+            *slot_count_out = slot_count;
+            *seeds_out = seeds;
+            *bucket_count_out = bucket_count;
+            break;
+        }
+        free(slots);
+    }
+
+    free(bucket_of);
+    free(bucket_size);
+    free(order);
+    free(trial);
+    free(hashes);
+    free(bucket_start);
+    free(members);
+}
+
+void mld_struct_db_freeze(StructureDb *struct_db){
+    assert(!struct_db->frozen);
+    unsigned int count = struct_db->count;
+
+    StructureDbRecord **records = calloc(count ? count : 1, sizeof(StructureDbRecord *));
+    char **names = calloc(count ? count : 1, sizeof(char *));
+    if(!records || !names){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    unsigned int n = 0;
+    for(int i = 0; i<TABLE_SIZE; i++){
+        for(StructureDbRecord *record = struct_db->structutre_db_arr[i]; record; record = record->next){
+            records[n] = record;
+            names[n++] = record->structure_name;
+        }
+    }
+    assert(n == count);
+
+    int *slot_of;
+    uint32_t slot_count, *seeds, bucket_count;
+    mld_build_perfect_hash(names, count, &slot_of, &slot_count, &seeds, &bucket_count);
+
+    //slots point at the registered records themselves, so finalizers & stats set later reach every object
+    StructureDbRecord **slots = calloc(slot_count, sizeof(StructureDbRecord *));
+    if(!slots){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t s = 0; s<slot_count; s++){
+        if(slot_of[s] >= 0) slots[s] = records[slot_of[s]];
+    }
+
+    mld_struct_db_install_perfect_hash(struct_db, slots, slot_count, seeds, bucket_count);
+    struct_db->frozen = 1;
+
+    free(slot_of);
+    free(names);
+    free(records);
+}
+
 StructureDbRecord *struct_db_lookup(StructureDb *struct_db, char *structure_name){
+    //perfect hash, one slot probe & one compare, valid only if nothing was registered after it was installed
+    if(struct_db->perfect_slots && struct_db->perfect_count == struct_db->count){
+        uint64_t hash = mld_struct_name_hash(structure_name);
+        uint32_t seed = struct_db->perfect_seeds[hash % struct_db->perfect_bucket_count];
+        StructureDbRecord *record = struct_db->perfect_slots[mld_struct_name_slot(hash, seed, struct_db->perfect_slot_count)];
+        if(record && strncmp(record->structure_name, structure_name, MAX_STRUCTURE_NAME_LENGTH) == 0)
+            return record;
+        return NULL;
+    }
+
     //get the hash value of the structure name
     unsigned int hash = polynonial_rolling_hash(structure_name);
 
@@ -123,8 +447,11 @@ StructureDbRecord *struct_db_lookup(StructureDb *struct_db, char *structure_name
 }
 
 ObjectDbRecord *object_db_lookup(char *structure_name, ObjectDb *object_db, void *pointer){
-    //get the hash value of the structure name
-    unsigned int hash = polynonial_rolling_hash(structure_name);
+    //records are hashed by address, structure_name is kept so existing callers still compile
+    (void)structure_name;
+    if(!object_db->table_size) return NULL;
+
+    unsigned int hash = object_db_hash_pointer(object_db, pointer);
 
     //lookup the object record in the hash table
     ObjectDbRecord *head = object_db->object_db_arr[hash];
@@ -139,175 +466,862 @@ ObjectDbRecord *object_db_lookup(char *structure_name, ObjectDb *object_db, void
 
 }
 
-#ifdef TRACE
+static MldThreadStats *mld_get_thread_stats(void){
+    if(mld_thread_stats) return mld_thread_stats;
 
-void add_object_to_object_db_with_trace(char *structure_name, ObjectDb *object_db, void *pointer, unsigned int units, StructureDbRecord *struct_rec, MldBoolean boolean_is_root, const char *file, int line){
-    ObjectDbRecord *obj_rec = object_db_lookup(structure_name, object_db, pointer);
-    obj_rec = calloc(1, sizeof(ObjectDbRecord));
-    obj_rec->next = NULL;
-    obj_rec->pointer = pointer;
-    obj_rec->units = units;
-    obj_rec->structure_record = struct_rec;
-    obj_rec->is_root = boolean_is_root;
+    MldThreadStats *thread_stats = calloc(1, sizeof(MldThreadStats));
+    assert(thread_stats);
 
-    //get the hash value of the structure name
-    unsigned int hash = polynonial_rolling_hash(struct_rec->structure_name);//here object_name shall be used
+    //push on the global list, blocks are never removed, so counts of exited threads stay in the sums
+    thread_stats->next = __atomic_load_n(&mld_all_thread_stats, __ATOMIC_RELAXED);
+    while(!__atomic_compare_exchange_n(&mld_all_thread_stats, &thread_stats->next, thread_stats,
+                                       MLD_TRUE, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    mld_thread_stats = thread_stats;
+    return thread_stats;
+}
 
-    //add the object record to the hash table
-    if(object_db->object_db_arr[hash]){
-        obj_rec->next = object_db->object_db_arr[hash];
-        object_db->object_db_arr[hash] = obj_rec;
-    }else{
-        object_db->object_db_arr[hash] = obj_rec;
-    }
-    object_db->count++;
-    printf("[OBJECT ADDED] %s : Line %d - Added object %p (%s) to database\n",
-        file, line, pointer, struct_rec->structure_name);
+//single writer per block, relaxed stores are enough for the reader to see whole values
+#define MLD_STATS_ADD(field, value) \
+    __atomic_store_n(&(field), (field) + (value), __ATOMIC_RELAXED)
+
+void mld_stats_record_alloc(StructureDbRecord *struct_rec, unsigned int units){
+    MldThreadStats *thread_stats = mld_get_thread_stats();
+    MLD_STATS_ADD(thread_stats->allocs, 1);
+    MLD_STATS_ADD(thread_stats->live_objects[struct_rec->stats_index], 1);
+    MLD_STATS_ADD(thread_stats->live_bytes[struct_rec->stats_index], (long)units * struct_rec->structure_size);
 }
 
-void *xcalloc_with_trace(ObjectDb *object_db, char *structure_name, int units, const char *file, int line){
+void mld_stats_record_free(StructureDbRecord *struct_rec, unsigned int units){
+    MldThreadStats *thread_stats = mld_get_thread_stats();
+    MLD_STATS_ADD(thread_stats->frees, 1);
+    MLD_STATS_ADD(thread_stats->live_objects[struct_rec->stats_index], -1);
+    MLD_STATS_ADD(thread_stats->live_bytes[struct_rec->stats_index], -(long)units * struct_rec->structure_size);
+}
 
-    StructureDbRecord *struct_rec = struct_db_lookup(object_db->struct_db, structure_name);
-    void *pointer = calloc(units, struct_rec->structure_size);
-    if(!pointer) {
-        printf("Memory allocation failed.\n");
-        exit(1);
+void mld_stats_record_resize(StructureDbRecord *struct_rec, unsigned int old_units, unsigned int new_units){
+    MldThreadStats *thread_stats = mld_get_thread_stats();
+    MLD_STATS_ADD(thread_stats->live_bytes[struct_rec->stats_index],
+                  ((long)new_units - (long)old_units) * struct_rec->structure_size);
+}
+
+void mld_get_stats(MldStats *stats){
+    memset(stats, 0, sizeof(MldStats));
+
+    unsigned int type_count = __atomic_load_n(&mld_stats_type_count, __ATOMIC_RELAXED);
+    stats->type_count = type_count <= MLD_STATS_OVERFLOW_SLOT ? type_count : MLD_MAX_STATS_TYPES;
+    for(unsigned int i = 0; i < stats->type_count; i++){
+        StructureDbRecord *struct_rec = __atomic_load_n(&mld_stats_types[i], __ATOMIC_ACQUIRE);
+        stats->types[i].structure_name = struct_rec ? struct_rec->structure_name : "";
     }
+    if(stats->type_count == MLD_MAX_STATS_TYPES) stats->types[MLD_STATS_OVERFLOW_SLOT].structure_name = MLD_STATS_OVERFLOW_NAME;
 
-    // Add object to db
-    add_object_to_object_db_with_trace(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE, file, line);
-    printf("[ALLOC] %s : Line %d - Allocated %d units for %s at %p\n",
-           file, line, units, structure_name, pointer);
-    return pointer;
+    MldThreadStats *thread_stats = __atomic_load_n(&mld_all_thread_stats, __ATOMIC_ACQUIRE);
+    for(; thread_stats; thread_stats = thread_stats->next){
+        stats->total_allocs += __atomic_load_n(&thread_stats->allocs, __ATOMIC_RELAXED);
+        stats->total_frees += __atomic_load_n(&thread_stats->frees, __ATOMIC_RELAXED);
+        for(unsigned int i = 0; i < stats->type_count; i++){
+            stats->types[i].live_objects += __atomic_load_n(&thread_stats->live_objects[i], __ATOMIC_RELAXED);
+            stats->types[i].live_bytes += __atomic_load_n(&thread_stats->live_bytes[i], __ATOMIC_RELAXED);
+        }
+    }
+
+    for(unsigned int i = 0; i < stats->type_count; i++){
+        stats->live_objects += stats->types[i].live_objects;
+        stats->live_bytes += stats->types[i].live_bytes;
+    }
+
+    //sampled peak, raised with a cas loop so concurrent readers never lower it
+    long peak = __atomic_load_n(&mld_stats_peak_bytes, __ATOMIC_RELAXED);
+    while(stats->live_bytes > peak &&
+          !__atomic_compare_exchange_n(&mld_stats_peak_bytes, &peak, stats->live_bytes,
+                                       MLD_TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    stats->peak_bytes = stats->live_bytes > peak ? stats->live_bytes : peak;
 }
 
-void *xmalloc_with_trace(ObjectDb *object_db, char *structure_name, int units, const char *file, int line){
+/*debug heap*/
 
-    StructureDbRecord *struct_rec = struct_db_lookup(object_db->struct_db, structure_name);
-    void *pointer = malloc(units * struct_rec->structure_size);
-    if(!pointer) {
-        printf("Memory allocation failed.\n");
-        exit(1);
+#define MLD_ROUND_UP(value, to) (((value) + (to) - 1) & ~((size_t)(to) - 1))
+
+//mapping of a guarded block, canary slack in front, user bytes rounded to 16, then the guard page
+static size_t mld_guarded_length(const MldDebugHeap *debug_heap, size_t size){
+    return MLD_ROUND_UP(MLD_ROUND_UP(size, 16) + MLD_REDZONE_SIZE, debug_heap->page_size) + debug_heap->page_size;
+}
+
+static char *mld_guarded_base(const MldDebugHeap *debug_heap, void *pointer, size_t size){
+    return (char *)pointer + MLD_ROUND_UP(size, 16) + debug_heap->page_size - mld_guarded_length(debug_heap, size);
+}
+
+//canary bytes in front of & behind a block
+static void mld_block_redzones(const MldDebugHeap *debug_heap, void *pointer, size_t size,
+                               unsigned char **front, size_t *front_size, unsigned char **back, size_t *back_size){
+    if(size >= debug_heap->guard_threshold){
+        *front = (unsigned char *)mld_guarded_base(debug_heap, pointer, size);
+        *back_size = MLD_ROUND_UP(size, 16) - size;
+    }else{
+        *front = (unsigned char *)pointer - MLD_REDZONE_SIZE;
+        *back_size = MLD_ROUND_UP(size, 16) - size + MLD_REDZONE_SIZE;
     }
+    *front_size = (unsigned char *)pointer - *front;
+    *back = (unsigned char *)pointer + size;
+}
 
-    // Add object to db
-    add_object_to_object_db_with_trace(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE, file, line);
-    printf("[ALLOC] %s : Line %d - Allocated %d units for %s at %p\n",
-        file, line, units, structure_name, pointer);
-    return pointer;
+//no early exit, so the compare vectorizes
+static MldBoolean mld_bytes_are(const unsigned char *bytes, size_t size, unsigned char value){
+    unsigned char diff = 0;
+    for(size_t i = 0; i < size; i++) diff |= bytes[i] ^ value;
+    return diff ? MLD_FALSE : MLD_TRUE;
 }
 
-void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *obj_rec, const char *file, int line){
-    assert(obj_rec);
+static void mld_report_corruption(MldDebugHeap *debug_heap, const char *what, void *pointer, size_t size,
+                                  const char *structure_name, const char *where){
+    debug_heap->corruptions++;
+    fprintf(stderr, "[MLD] %s of block %p (%s, %zu bytes) detected in %s\n",
+            what, pointer, structure_name ? structure_name : "freed", size, where);
+}
 
-    //get the hash value of the structure name
-    unsigned int hash = polynonial_rolling_hash(obj_rec->structure_record->structure_name); //object_name shall be used
+//a corrupted redzone is reported & re-armed, so each corruption is reported once
+static void mld_check_block(MldDebugHeap *debug_heap, void *pointer, size_t size, const char *structure_name, const char *where){
+    unsigned char *front, *back;
+    size_t front_size, back_size;
+    mld_block_redzones(debug_heap, pointer, size, &front, &front_size, &back, &back_size);
+    if(!mld_bytes_are(front, front_size, MLD_REDZONE_BYTE)){
+        mld_report_corruption(debug_heap, "underflow", pointer, size, structure_name, where);
+        memset(front, MLD_REDZONE_BYTE, front_size);
+    }
+    if(!mld_bytes_are(back, back_size, MLD_REDZONE_BYTE)){
+        mld_report_corruption(debug_heap, "overflow", pointer, size, structure_name, where);
+        memset(back, MLD_REDZONE_BYTE, back_size);
+    }
+}
 
-    //delete the object record from the hash table
-    ObjectDbRecord *head = object_db->object_db_arr[hash];
-    ObjectDbRecord *prev = NULL;
+static void mld_check_record(ObjectDb *object_db, ObjectDbRecord *obj_rec, const char *where){
+    if(obj_rec->heap_kind != MLD_HEAP_DEBUG) return;
+    mld_check_block(object_db->debug_heap, obj_rec->pointer, (size_t)obj_rec->units * obj_rec->structure_record->structure_size,
+                    obj_rec->structure_record->structure_name, where);
+}
 
-    for(; head; prev = head, head = head->next){
-        if(head == obj_rec){
-            if(prev){
-                prev->next = head->next;
-            }else{
-                object_db->object_db_arr[hash] = head->next;
-            }
-            free(head);
-            object_db->count--;
-            printf("[OBJECT REMOVED] %s : Line %d - Freed object %p\n", file, line, obj_rec->pointer);
-            return;
-        }
+static void mld_release_block(MldDebugHeap *debug_heap, void *pointer, size_t size){
+    if(size >= debug_heap->guard_threshold){
+        munmap(mld_guarded_base(debug_heap, pointer, size), mld_guarded_length(debug_heap, size));
+    }else{
+        free((char *)pointer - MLD_REDZONE_SIZE);
     }
 }
 
-void xfree_with_trace(char *structure_name, ObjectDb *object_db, void *pointer, const char *file, int line){
-    if(!pointer) return;
+//oldest quarantined block is checked & released, a small block whose freed fill changed was written after xfree
+static void mld_quarantine_evict(MldDebugHeap *debug_heap){
+    MldQuarantineEntry entry = debug_heap->quarantine[debug_heap->quarantine_head];
+    debug_heap->quarantine_head = (debug_heap->quarantine_head + 1) % MLD_QUARANTINE_SLOTS;
+    debug_heap->quarantine_count--;
+    debug_heap->quarantine_bytes -= entry.size;
 
-    ObjectDbRecord *obj_rec = object_db_lookup(structure_name, object_db, pointer);
-    assert(obj_rec);
+    if(entry.size < debug_heap->guard_threshold){
+        if(!mld_bytes_are(entry.pointer, entry.size, MLD_FREED_BYTE))
+            mld_report_corruption(debug_heap, "use after free write", entry.pointer, entry.size, NULL, "quarantine");
+        mld_check_block(debug_heap, entry.pointer, entry.size, NULL, "quarantine");
+    }
+    mld_release_block(debug_heap, entry.pointer, entry.size);
+}
 
-    free(obj_rec->pointer);
-    obj_rec->pointer = NULL;
+/*large object arena*/
 
-    delete_object_record_from_object_db(object_db, obj_rec, file, line);
+static void *mld_large_map(MldLargeArena *large_arena, size_t size, size_t *length_out){
+    size_t length = MLD_ROUND_UP(size ? size : 1, large_arena->page_size);
+    if(!large_arena->huge_pages || length < MLD_HUGE_PAGE_SIZE){
+        void *pointer = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(pointer == MAP_FAILED) return NULL;
+        *length_out = length;
+        return pointer;
+    }
 
-    printf("[FREE] %s : Line %d - Freed object %p\n", file, line, pointer);
+    //over map by one huge page, then trim head & tail so the block starts on a huge page boundary
+    length = MLD_ROUND_UP(size, MLD_HUGE_PAGE_SIZE);
+    char *raw = mmap(NULL, length + MLD_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(raw == MAP_FAILED) return NULL;
+    char *pointer = (char *)MLD_ROUND_UP((uintptr_t)raw, MLD_HUGE_PAGE_SIZE);
+    size_t head = pointer - raw;
+    if(head) munmap(raw, head);
+    if(head < MLD_HUGE_PAGE_SIZE) munmap(pointer + length, MLD_HUGE_PAGE_SIZE - head);
+    madvise(pointer, length, MADV_HUGEPAGE);
+    *length_out = length;
+    return pointer;
+}
 
+//index of the region starting at pointer, or of the first region above it
+static unsigned int mld_large_region_search(const MldLargeArena *large_arena, void *pointer){
+    unsigned int low = 0, high = large_arena->count;
+    while(low < high){
+        unsigned int mid = (low + high) / 2;
+        if((uintptr_t)large_arena->regions[mid].pointer < (uintptr_t)pointer) low = mid + 1;
+        else high = mid;
+    }
+    return low;
 }
 
-void mld_dump_object_rec_detail_with_trace(ObjectDbRecord *object_Record, const char *file, int line){
-    if(!object_Record || object_Record->structure_record==0) return;
-    printf("object_Record: %p\n", object_Record);
-    printf("object_Record->structure_record: %p\n", object_Record->structure_record);
-    printf("object_Record->structure_record->structure_name: %s\n", object_Record->structure_record->structure_name);
-    printf("object_Record->structure_record->structure_size: %d\n", object_Record->structure_record->structure_size);
-    printf("object_Record->structure_record->field_count: %d\n", object_Record->structure_record->field_count);
-    printf("object_Record->pointer: %p\n", object_Record->pointer);
-    printf("object_Record->units: %d\n", object_Record->units);
-    printf("object_Record->is_visited: %d\n", object_Record->is_visited);
-    printf("object_Record->is_root: %d\n", object_Record->is_root);
+static MldLargeRegion *mld_large_region_find(MldLargeArena *large_arena, void *pointer){
+    unsigned int index = mld_large_region_search(large_arena, pointer);
+    assert(index < large_arena->count && large_arena->regions[index].pointer == pointer);
+    return &large_arena->regions[index];
+}
 
-    int field_count = object_Record->structure_record->field_count;
-    printf("Field count: %d\n", field_count);
-    FieldInfo *field = NULL;
+static void mld_large_region_insert(MldLargeArena *large_arena, void *pointer, size_t length){
+    if(large_arena->count == large_arena->capacity){
+        large_arena->capacity = large_arena->capacity ? large_arena->capacity * 2 : 16;
+        large_arena->regions = realloc(large_arena->regions, large_arena->capacity * sizeof(MldLargeRegion));
+        if(!large_arena->regions){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    unsigned int index = mld_large_region_search(large_arena, pointer);
+    memmove(&large_arena->regions[index + 1], &large_arena->regions[index], (large_arena->count - index) * sizeof(MldLargeRegion));
+    large_arena->regions[index].pointer = pointer;
+    large_arena->regions[index].length = length;
+    large_arena->count++;
+    large_arena->mapped_bytes += length;
+}
 
-    int units = object_Record->units, obj_index = 0;
+static void mld_large_region_remove(MldLargeArena *large_arena, MldLargeRegion *region){
+    unsigned int index = region - large_arena->regions;
+    large_arena->mapped_bytes -= region->length;
+    large_arena->count--;
+    memmove(region, region + 1, (large_arena->count - index) * sizeof(MldLargeRegion));
+}
 
-    for (; obj_index < units; obj_index++) {
-        // printf("Object index: %d\n", obj_index);
-        char *current_object_ptr = (char *)(object_Record->pointer) +
-                                   (obj_index * object_Record->structure_record->structure_size);
+void mld_enable_large_arena(ObjectDb *object_db, size_t threshold, MldBoolean huge_pages){
+    assert(!object_db->large_arena);
+    MldLargeArena *large_arena = calloc(1, sizeof(MldLargeArena));
+    if(!large_arena){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    large_arena->threshold = threshold ? threshold : MLD_LARGE_OBJECT_THRESHOLD;
+    large_arena->huge_pages = huge_pages;
+    large_arena->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    object_db->large_arena = large_arena;
+}
 
-        printf("  Instance %d Address Range: [%p - %p]\n", obj_index,
-               current_object_ptr,
-               current_object_ptr + object_Record->structure_record->structure_size - 1);
+/*slab heap*/
 
-        for (int field_index = 0; field_index < field_count; field_index++) {
-            field = &object_Record->structure_record->fields[field_index];
-            void *field_addr = (void *)(current_object_ptr + field->offset);
+//returned by mld_slab_slot for an address which is not the start of a slot
+#define MLD_SLAB_NO_SLOT 0xFFFFFFFFu
 
-            switch (field->data_type) {
-                case UINT8_TYPE:
-                case INT32_TYPE:
-                case UINT32_TYPE:
-                    printf("    %-20s : %d\n", field->field_name, *(int *)field_addr);
-                    break;
-                case CHAR_TYPE:
-                    printf("    %-20s : %c\n", field->field_name, *(char *)field_addr);
-                    break;
-                case FLOAT_TYPE:
-                    printf("    %-20s : %.2f\n", field->field_name, *(float *)field_addr);
-                    break;
-                case DOUBLE_TYPE:
-                    printf("    %-20s : %.2lf\n", field->field_name, *(double *)field_addr);
-                    break;
-                case OBJECT_pointer_TYPE:
-                case VOID_pointer_TYPE:
-                    printf("    %-20s : %p\n", field->field_name, *(void **)field_addr);
-                    break;
-                case OBJECT_STRUCT_TYPE:
-                    printf("    %-20s : [Nested Structure: %s] @ %p\n",
-                           field->field_name, field->nested_structure_name, *(void **)field_addr);
-                    break;
-                default:
-                    printf("    %-20s : UNKNOWN DATA TYPE\n", field->field_name);
-            }
-        }
-        printf("\n");
+//slab bases are MLD_SLAB_SIZE aligned, their low bits carry nothing
+static inline unsigned int mld_slab_hash(uintptr_t base, unsigned int table_size){
+    return (unsigned int)(((base >> MLD_SLAB_SHIFT) * 0x9E3779B97F4A7C15ULL) >> 32) & (table_size - 1);
+}
+
+//slab holding address, NULL if address is not inside a slab
+static inline MldSlab *mld_slab_of(const MldSlabHeap *slab_heap, const void *address){
+    uintptr_t base = (uintptr_t)address & ~(uintptr_t)(MLD_SLAB_SIZE - 1);
+    for(unsigned int i = mld_slab_hash(base, slab_heap->table_size); slab_heap->table[i]; i = (i + 1) & (slab_heap->table_size - 1)){
+        if((uintptr_t)slab_heap->table[i]->record.pointer == base) return slab_heap->table[i];
     }
+    return NULL;
 }
 
-#else
+static inline unsigned int mld_slab_slot(const MldSlab *slab, const void *address){
+    size_t offset = (const char *)address - (const char *)slab->record.pointer;
+    size_t size = slab->record.structure_record->structure_size;
+    if(offset % size || offset / size >= slab->record.units) return MLD_SLAB_NO_SLOT;
+    return (unsigned int)(offset / size);
+}
 
-/*
-similar to the structure db, the object db is also implemented as a hashmap, 
-if hash value is already occupied, then the new object record is added to the head of the linked list
-if hash value is not occupied, then the new object record is added to the hash table
-*/
+static inline MldBoolean mld_slab_bit(const uint64_t *bitmap, unsigned int slot){
+    return (bitmap[slot >> 6] >> (slot & 63)) & 1 ? MLD_TRUE : MLD_FALSE;
+}
 
-void add_object_to_object_db(char *structure_name, ObjectDb *object_db, void *pointer, unsigned int units, StructureDbRecord *struct_rec, MldBoolean boolean_is_root){
+static void mld_slab_table_put(MldSlab **table, unsigned int table_size, MldSlab *slab){
+    unsigned int i = mld_slab_hash((uintptr_t)slab->record.pointer, table_size);
+    while(table[i]) i = (i + 1) & (table_size - 1);
+    table[i] = slab;
+}
+
+//slab is added to the list of all slabs & to the table, the table is doubled to stay at most half full
+static void mld_slab_register(MldSlabHeap *slab_heap, MldSlab *slab){
+    if(slab_heap->slab_count == slab_heap->slab_capacity){
+        slab_heap->slab_capacity = slab_heap->slab_capacity ? slab_heap->slab_capacity * 2 : 64;
+        slab_heap->slabs = realloc(slab_heap->slabs, slab_heap->slab_capacity * sizeof(MldSlab *));
+        if(!slab_heap->slabs){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    slab_heap->slabs[slab_heap->slab_count++] = slab;
+
+    if(2 * slab_heap->slab_count > slab_heap->table_size){
+        unsigned int table_size = slab_heap->table_size * 2;
+        MldSlab **table = calloc(table_size, sizeof(MldSlab *));
+        if(!table){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        for(unsigned int i = 0; i < slab_heap->slab_count - 1; i++) mld_slab_table_put(table, table_size, slab_heap->slabs[i]);
+        free(slab_heap->table);
+        slab_heap->table = table;
+        slab_heap->table_size = table_size;
+    }
+    mld_slab_table_put(slab_heap->table, slab_heap->table_size, slab);
+}
+
+static MldSlab *mld_slab_create(MldSlabHeap *slab_heap, StructureDbRecord *struct_rec){
+    MldSlab *slab = calloc(1, sizeof(MldSlab));
+    void *base = aligned_alloc(MLD_SLAB_SIZE, MLD_SLAB_SIZE);
+    if(!slab || !base){
+        free(slab);
+        free(base);
+        return NULL;
+    }
+    unsigned int capacity = MLD_SLAB_SIZE / struct_rec->structure_size;
+    slab->record.pointer = base;
+    slab->record.units = capacity;
+    slab->record.structure_record = struct_rec;
+    slab->record.heap_kind = MLD_HEAP_SLAB;
+    for(unsigned int slot = capacity; slot < MLD_SLAB_BITMAP_WORDS * 64; slot++) slab->live[slot >> 6] |= 1ULL << (slot & 63);
+    mld_slab_register(slab_heap, slab);
+    return slab;
+}
+
+static inline MldBoolean mld_slab_eligible(ObjectDb *object_db, StructureDbRecord *struct_rec, int units){
+    return object_db->slab_heap && !object_db->debug_heap && units == 1 &&
+           struct_rec->structure_size >= sizeof(void *) && struct_rec->structure_size <= MLD_SLAB_MAX_OBJECT &&
+           struct_rec->stats_index < MLD_SLAB_MAX_TYPES ? MLD_TRUE : MLD_FALSE;
+}
+
+//first free slot of the first partial slab of the type, a new slab is made when the type has none
+static void *mld_slab_alloc(ObjectDb *object_db, StructureDbRecord *struct_rec, MldBoolean zero){
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+    MldSlab *slab = slab_heap->partial[struct_rec->stats_index];
+    if(!slab){
+        slab = mld_slab_create(slab_heap, struct_rec);
+        if(!slab) return NULL;
+        slab->on_partial = MLD_TRUE;
+        slab_heap->partial[struct_rec->stats_index] = slab;
+    }
+
+    unsigned int w = slab->free_hint;
+    while(!~slab->live[w]) w++;
+    unsigned int slot = w * 64 + __builtin_ctzll(~slab->live[w]);
+    slab->live[w] |= 1ULL << (slot & 63);
+    if(object_db->sweep.pending) slab->marked[w] |= 1ULL << (slot & 63);
+    slab->free_hint = w;
+    if(++slab->live_count == slab->record.units){
+        slab_heap->partial[struct_rec->stats_index] = slab->next_partial;
+        slab->next_partial = NULL;
+        slab->on_partial = MLD_FALSE;
+    }
+    slab_heap->live_objects++;
+    mld_stats_record_alloc(struct_rec, 1);
+
+    char *pointer = (char *)slab->record.pointer + (size_t)slot * struct_rec->structure_size;
+    if(zero) memset(pointer, 0, struct_rec->structure_size);
+    return pointer;
+}
+
+//returns MLD_FALSE & frees nothing if pointer is not a live object of the slab
+static MldBoolean mld_slab_free(MldSlabHeap *slab_heap, MldSlab *slab, void *pointer){
+    unsigned int slot = mld_slab_slot(slab, pointer);
+    if(slot == MLD_SLAB_NO_SLOT || !mld_slab_bit(slab->live, slot)) return MLD_FALSE;
+
+    unsigned int w = slot >> 6;
+    uint64_t bit = 1ULL << (slot & 63);
+    slab->live[w] &= ~bit;
+    if(slab->roots[w] & bit){
+        slab->roots[w] &= ~bit;
+        slab->root_count--;
+    }
+    if(w < slab->free_hint) slab->free_hint = w;
+    slab->live_count--;
+    slab_heap->live_objects--;
+    mld_stats_record_free(slab->record.structure_record, 1);
+
+    if(!slab->on_partial){
+        StructureDbRecord *struct_rec = slab->record.structure_record;
+        slab->next_partial = slab_heap->partial[struct_rec->stats_index];
+        slab_heap->partial[struct_rec->stats_index] = slab;
+        slab->on_partial = MLD_TRUE;
+    }
+    return MLD_TRUE;
+}
+
+//stand in record for one object of a slab, for code which reports objects through their records
+static void mld_slab_unit_record(MldSlab *slab, unsigned int slot, ObjectDbRecord *unit_rec){
+    *unit_rec = slab->record;
+    unit_rec->next = NULL;
+    unit_rec->pointer = (char *)slab->record.pointer + (size_t)slot * slab->record.structure_record->structure_size;
+    unit_rec->units = 1;
+    unit_rec->is_visited = mld_slab_bit(slab->marked, slot);
+    unit_rec->is_root = mld_slab_bit(slab->roots, slot);
+}
+
+//next live & unmarked slab object from the cursor (slab_index, slot) on, MLD_FALSE once all slabs are walked
+static MldBoolean mld_slab_next_leaked(MldSlabHeap *slab_heap, unsigned int *slab_index, unsigned int *slot, ObjectDbRecord *unit_rec){
+    if(!slab_heap) return MLD_FALSE;
+    for(; *slab_index < slab_heap->slab_count; (*slab_index)++, *slot = 0){
+        MldSlab *slab = slab_heap->slabs[*slab_index];
+        while(*slot < slab->record.units){
+            unsigned int w = *slot >> 6;
+            uint64_t leaked = (slab->live[w] & ~slab->marked[w]) >> (*slot & 63);
+            if(!leaked){
+                *slot = (w + 1) << 6;
+                continue;
+            }
+            unsigned int found = *slot + __builtin_ctzll(leaked);
+            if(found >= slab->record.units) break;
+            *slot = found + 1;
+            mld_slab_unit_record(slab, found, unit_rec);
+            return MLD_TRUE;
+        }
+    }
+    return MLD_FALSE;
+}
+
+void mld_enable_slab_heap(ObjectDb *object_db){
+    assert(!object_db->slab_heap && !object_db->generations);
+    MldSlabHeap *slab_heap = calloc(1, sizeof(MldSlabHeap));
+    if(slab_heap) slab_heap->table = calloc(64, sizeof(MldSlab *));
+    if(!slab_heap || !slab_heap->table){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    slab_heap->table_size = 64;
+    object_db->slab_heap = slab_heap;
+}
+
+//bits past the capacity of a slab are live & never marked, they are taken off the count
+unsigned long mld_slab_leaked_objects(ObjectDb *object_db){
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+    if(!slab_heap) return 0;
+
+    unsigned long leaked = 0;
+    for(unsigned int s = 0; s < slab_heap->slab_count; s++){
+        MldSlab *slab = slab_heap->slabs[s];
+        for(unsigned int w = 0; w < MLD_SLAB_BITMAP_WORDS; w++) leaked += __builtin_popcountll(slab->live[w] & ~slab->marked[w]);
+        leaked -= MLD_SLAB_BITMAP_WORDS * 64 - slab->record.units;
+    }
+    return leaked;
+}
+
+/*
+heap layer under xmalloc/xcalloc/xrealloc/xfree, plain libc calls unless the debug heap or the large object arena is enabled
+size is the block size in bytes, the kind of a block is kept in its object record & tells free & realloc where it came from
+*/
+static void *mld_heap_alloc(ObjectDb *object_db, size_t size, MldBoolean zero, MldHeapKind *kind){
+    MldDebugHeap *debug_heap = object_db->debug_heap;
+    MldLargeArena *large_arena = object_db->large_arena;
+    *kind = MLD_HEAP_LIBC;
+
+    if(!debug_heap){
+        if(large_arena && size >= large_arena->threshold){
+            size_t length;
+            void *pointer = mld_large_map(large_arena, size, &length);
+            if(!pointer) return NULL;
+            mld_large_region_insert(large_arena, pointer, length);
+            *kind = MLD_HEAP_LARGE;
+            return pointer;
+        }
+        return zero ? calloc(1, size) : malloc(size);
+    }
+
+    char *pointer;
+    size_t rounded = MLD_ROUND_UP(size, 16);
+    if(size >= debug_heap->guard_threshold){
+        size_t length = mld_guarded_length(debug_heap, size);
+        char *base = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(base == MAP_FAILED) return NULL;
+        mprotect(base + length - debug_heap->page_size, debug_heap->page_size, PROT_NONE);
+        pointer = base + length - debug_heap->page_size - rounded;
+        memset(base, MLD_REDZONE_BYTE, pointer - base);
+        memset(pointer + size, MLD_REDZONE_BYTE, rounded - size);
+    }else{
+        char *base = malloc(MLD_REDZONE_SIZE + rounded + MLD_REDZONE_SIZE);
+        if(!base) return NULL;
+        pointer = base + MLD_REDZONE_SIZE;
+        memset(base, MLD_REDZONE_BYTE, MLD_REDZONE_SIZE);
+        memset(pointer + size, MLD_REDZONE_BYTE, rounded - size + MLD_REDZONE_SIZE);
+        if(zero) memset(pointer, 0, size);
+    }
+    *kind = MLD_HEAP_DEBUG;
+    return pointer;
+}
+
+static void mld_heap_free(ObjectDb *object_db, void *pointer, size_t size, MldHeapKind kind){
+    if(kind == MLD_HEAP_LIBC){
+        free(pointer);
+        return;
+    }
+    if(kind == MLD_HEAP_LARGE){
+        MldLargeRegion *region = mld_large_region_find(object_db->large_arena, pointer);
+        munmap(pointer, region->length);
+        mld_large_region_remove(object_db->large_arena, region);
+        return;
+    }
+
+    MldDebugHeap *debug_heap = object_db->debug_heap;
+    if(size > debug_heap->quarantine_limit){
+        mld_release_block(debug_heap, pointer, size);
+        return;
+    }
+
+    if(size >= debug_heap->guard_threshold){
+        char *base = mld_guarded_base(debug_heap, pointer, size);
+        mprotect(base, mld_guarded_length(debug_heap, size) - debug_heap->page_size, PROT_NONE);
+    }else{
+        memset(pointer, MLD_FREED_BYTE, size);
+    }
+
+    while(debug_heap->quarantine_count == MLD_QUARANTINE_SLOTS ||
+          (debug_heap->quarantine_count && debug_heap->quarantine_bytes + size > debug_heap->quarantine_limit))
+        mld_quarantine_evict(debug_heap);
+
+    unsigned int tail = (debug_heap->quarantine_head + debug_heap->quarantine_count) % MLD_QUARANTINE_SLOTS;
+    debug_heap->quarantine[tail].pointer = pointer;
+    debug_heap->quarantine[tail].size = size;
+    debug_heap->quarantine_count++;
+    debug_heap->quarantine_bytes += size;
+}
+
+/*
+a block keeps its kind across realloc
+a large block is remapped, pages are moved rather than copied & grown memory is zero filled
+a debug block is never resized in place, the old block goes through quarantine like any other freed block
+*/
+static void *mld_heap_realloc(ObjectDb *object_db, void *pointer, size_t old_size, size_t new_size, MldHeapKind kind){
+    if(kind == MLD_HEAP_LIBC) return realloc(pointer, new_size);
+    if(kind == MLD_HEAP_LARGE){
+        MldLargeArena *large_arena = object_db->large_arena;
+        MldLargeRegion *region = mld_large_region_find(large_arena, pointer);
+        size_t length = MLD_ROUND_UP(new_size ? new_size : 1, large_arena->page_size);
+        void *new_pointer = mremap(pointer, region->length, length, MREMAP_MAYMOVE);
+        if(new_pointer == MAP_FAILED) return NULL;
+        mld_large_region_remove(large_arena, region);
+        mld_large_region_insert(large_arena, new_pointer, length);
+        return new_pointer;
+    }
+
+    MldHeapKind new_kind;
+    void *new_pointer = mld_heap_alloc(object_db, new_size, MLD_FALSE, &new_kind);
+    if(!new_pointer) return NULL;
+    memcpy(new_pointer, pointer, old_size < new_size ? old_size : new_size);
+    mld_heap_free(object_db, pointer, old_size, MLD_HEAP_DEBUG);
+    return new_pointer;
+}
+
+//records are pushed at the head of their bucket, so the record just added for pointer is the bucket head
+static void mld_heap_mark_added(ObjectDb *object_db, void *pointer, MldHeapKind kind){
+    if(kind != MLD_HEAP_LIBC) object_db->object_db_arr[object_db_hash_pointer(object_db, pointer)]->heap_kind = kind;
+}
+
+void mld_enable_debug_heap(ObjectDb *object_db, size_t guard_threshold, size_t quarantine_limit){
+    assert(!object_db->debug_heap);
+    MldDebugHeap *debug_heap = calloc(1, sizeof(MldDebugHeap));
+    if(!debug_heap){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    debug_heap->page_size = (size_t)sysconf(_SC_PAGESIZE);
+    debug_heap->guard_threshold = guard_threshold ? guard_threshold : debug_heap->page_size;
+    debug_heap->quarantine_limit = quarantine_limit;
+    object_db->debug_heap = debug_heap;
+}
+
+unsigned long mld_check_redzones(ObjectDb *object_db){
+    MldDebugHeap *debug_heap = object_db->debug_heap;
+    if(!debug_heap) return 0;
+
+    unsigned long before = debug_heap->corruptions;
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next)
+            mld_check_record(object_db, obj_rec, "scan");
+    }
+    return debug_heap->corruptions - before;
+}
+
+void mld_drain_quarantine(ObjectDb *object_db){
+    MldDebugHeap *debug_heap = object_db->debug_heap;
+    if(!debug_heap) return;
+    while(debug_heap->quarantine_count) mld_quarantine_evict(debug_heap);
+}
+
+/*free error detection*/
+
+void mld_set_free_error_handler(ObjectDb *object_db, MldFreeErrorHandler handler, void *user_data){
+    object_db->free_error_handler = handler;
+    object_db->free_error_data = user_data;
+}
+
+static void mld_remember_freed(ObjectDb *object_db, void *pointer, StructureDbRecord *struct_rec){
+    MldFreedEntry *entry = &object_db->recently_freed[object_db->recently_freed_next];
+    entry->pointer = pointer;
+    entry->structure_record = struct_rec;
+    object_db->recently_freed_next = (object_db->recently_freed_next + 1) % MLD_RECENTLY_FREED_SIZE;
+}
+
+static const char *mld_free_error_names[] = {
+    "double free",
+    "interior free",
+    "invalid free"
+};
+
+//pointer has no object record, classify it & hand it to the handler, the pointer is not freed
+static void mld_report_free_error(ObjectDb *object_db, void *pointer, const char *file, int line, void *caller){
+    MldFreeError error = {MLD_INVALID_FREE, pointer, file, line, caller, NULL, NULL};
+
+    for(unsigned int i = 0; i < MLD_RECENTLY_FREED_SIZE; i++){
+        if(object_db->recently_freed[i].pointer == pointer){
+            error.kind = MLD_DOUBLE_FREE;
+            error.structure_name = object_db->recently_freed[i].structure_record->structure_name;
+            break;
+        }
+    }
+    MldSlab *slab = error.kind == MLD_INVALID_FREE && object_db->slab_heap ? mld_slab_of(object_db->slab_heap, pointer) : NULL;
+    if(slab){
+        size_t size = slab->record.structure_record->structure_size;
+        size_t slot = (size_t)((char *)pointer - (char *)slab->record.pointer) / size;
+        if(slot < slab->record.units && mld_slab_bit(slab->live, (unsigned int)slot)){
+            error.kind = MLD_INTERIOR_FREE;
+            error.structure_name = slab->record.structure_record->structure_name;
+            error.object = (char *)slab->record.pointer + slot * size;
+        }
+    }
+    for(unsigned int i = 0; i < object_db->table_size && error.kind == MLD_INVALID_FREE; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            char *start = obj_rec->pointer;
+            if((char *)pointer > start && (char *)pointer < start + (size_t)obj_rec->units * obj_rec->structure_record->structure_size){
+                error.kind = MLD_INTERIOR_FREE;
+                error.structure_name = obj_rec->structure_record->structure_name;
+                error.object = start;
+                break;
+            }
+        }
+    }
+
+    if(object_db->free_error_handler){
+        object_db->free_error_handler(&error, object_db->free_error_data);
+        return;
+    }
+    if(file){
+        fprintf(stderr, "[MLD] %s of %p at %s:%d", mld_free_error_names[error.kind], pointer, file, line);
+    }else{
+        fprintf(stderr, "[MLD] %s of %p at %p", mld_free_error_names[error.kind], pointer, caller);
+    }
+    if(error.kind == MLD_INTERIOR_FREE){
+        fprintf(stderr, ", %zu bytes into %s %p\n", (size_t)((char *)pointer - (char *)error.object), error.structure_name, error.object);
+    }else if(error.kind == MLD_DOUBLE_FREE){
+        fprintf(stderr, ", %s freed recently\n", error.structure_name);
+    }else{
+        fprintf(stderr, "\n");
+    }
+}
+
+//returns MLD_FALSE if pointer is not inside a slab, otherwise the object is freed or the error is reported
+static MldBoolean mld_slab_release(ObjectDb *object_db, void *pointer, const char *file, int line, void *caller){
+    MldSlab *slab = object_db->slab_heap ? mld_slab_of(object_db->slab_heap, pointer) : NULL;
+    if(!slab) return MLD_FALSE;
+    if(mld_slab_free(object_db->slab_heap, slab, pointer)) mld_remember_freed(object_db, pointer, slab->record.structure_record);
+    else mld_report_free_error(object_db, pointer, file, line, caller);
+    return MLD_TRUE;
+}
+
+/*generational bookkeeping, nothing is done unless generational scanning is enabled*/
+
+static void mld_young_push(MldGenerations *generations, ObjectDbRecord *obj_rec){
+    obj_rec->young_prev = NULL;
+    obj_rec->young_next = generations->young;
+    if(generations->young) generations->young->young_prev = obj_rec;
+    generations->young = obj_rec;
+    generations->young_count++;
+}
+
+static void mld_young_unlink(MldGenerations *generations, ObjectDbRecord *obj_rec){
+    if(obj_rec->young_prev) obj_rec->young_prev->young_next = obj_rec->young_next;
+    else generations->young = obj_rec->young_next;
+    if(obj_rec->young_next) obj_rec->young_next->young_prev = obj_rec->young_prev;
+    obj_rec->young_prev = obj_rec->young_next = NULL;
+    generations->young_count--;
+}
+
+static void mld_remembered_add(MldGenerations *generations, ObjectDbRecord *obj_rec){
+    if(obj_rec->remembered_slot) return;
+    if(generations->remembered_count == generations->remembered_capacity){
+        generations->remembered_capacity = generations->remembered_capacity ? generations->remembered_capacity * 2 : 64;
+        generations->remembered = realloc(generations->remembered, generations->remembered_capacity * sizeof(ObjectDbRecord *));
+        if(!generations->remembered){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    generations->remembered[generations->remembered_count++] = obj_rec;
+    obj_rec->remembered_slot = generations->remembered_count;
+}
+
+//swap remove, the last entry takes the freed slot
+static void mld_remembered_remove(MldGenerations *generations, ObjectDbRecord *obj_rec){
+    unsigned int index = obj_rec->remembered_slot - 1;
+    ObjectDbRecord *last = generations->remembered[--generations->remembered_count];
+    generations->remembered[index] = last;
+    last->remembered_slot = index + 1;
+    obj_rec->remembered_slot = 0;
+}
+
+//new records start young
+static void mld_generations_track(ObjectDb *object_db, ObjectDbRecord *obj_rec){
+    if(object_db->generations) mld_young_push(object_db->generations, obj_rec);
+}
+
+//called before a record is freed
+static void mld_generations_forget(ObjectDb *object_db, ObjectDbRecord *obj_rec){
+    MldGenerations *generations = object_db->generations;
+    if(!generations) return;
+    if(!obj_rec->is_old) mld_young_unlink(generations, obj_rec);
+    else if(obj_rec->remembered_slot) mld_remembered_remove(generations, obj_rec);
+}
+
+/*
+object record of a block which moved (realloc) is re-linked in place, the record itself is kept,
+so the only hash work is one unlink from the old bucket & one push to the new bucket
+*/
+void object_db_move_record(ObjectDb *object_db, ObjectDbRecord *obj_rec, void *new_pointer){
+    unsigned int old_hash = object_db_hash_pointer(object_db, obj_rec->pointer);
+    unsigned int new_hash = object_db_hash_pointer(object_db, new_pointer);
+
+    obj_rec->pointer = new_pointer;
+    //stores logged against the old address can no longer be resolved, so a moved old object is remembered outright
+    if(object_db->generations && obj_rec->is_old) mld_remembered_add(object_db->generations, obj_rec);
+    if(old_hash == new_hash) return;
+
+    ObjectDbRecord **link = &object_db->object_db_arr[old_hash];
+    for(; *link; link = &(*link)->next){
+        if(*link == obj_rec){
+            *link = obj_rec->next;
+            break;
+        }
+    }
+
+    obj_rec->next = object_db->object_db_arr[new_hash];
+    object_db->object_db_arr[new_hash] = obj_rec;
+}
+
+//batch apis work on groups of MLD_BATCH_CHUNK objects, hashes of a group are computed & their buckets prefetched before any bucket is touched
+#define MLD_BATCH_CHUNK 64
+
+/*
+xmalloc_batch allocates count objects of one unit each of type structure_name, pointers are returned in out_ptrs
+structure record is looked up once for the whole batch
+returns the number of objects allocated, which is count unless malloc failed part way
+*/
+int xmalloc_batch(ObjectDb *object_db, char *structure_name, int count, void **out_ptrs){
+    StructureDbRecord *struct_rec = struct_db_lookup(object_db->struct_db, structure_name);
+    assert(struct_rec);
+    if(object_db->sweep.pending) mld_sweep_step(object_db, MLD_SWEEP_STEP);
+
+    if(mld_slab_eligible(object_db, struct_rec, 1)){
+        for(int i = 0; i < count; i++){
+            out_ptrs[i] = mld_slab_alloc(object_db, struct_rec, MLD_FALSE);
+            if(!out_ptrs[i]) return i;
+        }
+        return count;
+    }
+
+    unsigned int hashes[MLD_BATCH_CHUNK];
+    MldHeapKind kinds[MLD_BATCH_CHUNK];
+
+    for(int base = 0; base < count; base += MLD_BATCH_CHUNK){
+        int chunk = count - base < MLD_BATCH_CHUNK ? count - base : MLD_BATCH_CHUNK;
+        mld_object_table_reserve(object_db, (unsigned long)object_db->count + chunk);
+
+        int allocated = 0;
+        for(; allocated < chunk; allocated++){
+            void *pointer = mld_heap_alloc(object_db, struct_rec->structure_size, MLD_FALSE, &kinds[allocated]);
+            if(!pointer) break;
+            out_ptrs[base + allocated] = pointer;
+            hashes[allocated] = object_db_hash_pointer(object_db, pointer);
+            __builtin_prefetch(&object_db->object_db_arr[hashes[allocated]], 1);
+        }
+
+        //objects allocated before a failure are recorded too, the caller owns all of them
+        for(int i = 0; i < allocated; i++){
+            ObjectDbRecord *obj_rec = calloc(1, sizeof(ObjectDbRecord));
+            if(!obj_rec){
+                printf("Memory allocation failed.\n");
+                exit(1);
+            }
+            obj_rec->pointer = out_ptrs[base + i];
+            obj_rec->units = 1;
+            obj_rec->structure_record = struct_rec;
+            obj_rec->heap_kind = kinds[i];
+            obj_rec->is_visited = object_db->sweep.pending;
+            obj_rec->next = object_db->object_db_arr[hashes[i]];
+            object_db->object_db_arr[hashes[i]] = obj_rec;
+            mld_generations_track(object_db, obj_rec);
+            mld_stats_record_alloc(struct_rec, 1);
+        }
+        object_db->count += allocated;
+        if(allocated < chunk) return base + allocated;
+    }
+    return count;
+}
+
+/*
+xfree_batch frees count tracked objects, NULL entries are skipped
+buckets of a group are prefetched first, then each record is unlinked & freed along with its object
+*/
+void xfree_batch(ObjectDb *object_db, void **ptrs, int count){
+    unsigned int hashes[MLD_BATCH_CHUNK];
+    //with nothing tracked yet every pointer is a slab object or a free error, the empty table answers that
+    mld_object_table_reserve(object_db, 0);
+
+    for(int base = 0; base < count; base += MLD_BATCH_CHUNK){
+        int chunk = count - base < MLD_BATCH_CHUNK ? count - base : MLD_BATCH_CHUNK;
+
+        for(int i = 0; i < chunk; i++){
+            hashes[i] = object_db_hash_pointer(object_db, ptrs[base + i]);
+            __builtin_prefetch(&object_db->object_db_arr[hashes[i]], 1);
+        }
+
+        for(int i = 0; i < chunk; i++){
+            void *pointer = ptrs[base + i];
+            if(!pointer || mld_slab_release(object_db, pointer, NULL, 0, __builtin_return_address(0))) continue;
+
+            ObjectDbRecord **link = &object_db->object_db_arr[hashes[i]];
+            for(; *link && (*link)->pointer != pointer; link = &(*link)->next);
+            if(!*link){
+                mld_report_free_error(object_db, pointer, NULL, 0, __builtin_return_address(0));
+                continue;
+            }
+
+            ObjectDbRecord *obj_rec = *link;
+            MldHeapKind kind = obj_rec->heap_kind;
+            size_t size = (size_t)obj_rec->units * obj_rec->structure_record->structure_size;
+            mld_check_record(object_db, obj_rec, "xfree_batch");
+            mld_remember_freed(object_db, pointer, obj_rec->structure_record);
+            *link = obj_rec->next;
+            mld_generations_forget(object_db, obj_rec);
+            mld_stats_record_free(obj_rec->structure_record, obj_rec->units);
+            free(obj_rec);
+            object_db->count--;
+            mld_heap_free(object_db, pointer, size, kind);
+        }
+    }
+}
+
+//object being resized is still in use, it is marked so the sweep step taken by xrealloc keeps it
+static void mld_sweep_step_keeping(ObjectDb *object_db, void *pointer){
+    if(!object_db->sweep.pending) return;
+    MldSlab *slab = object_db->slab_heap ? mld_slab_of(object_db->slab_heap, pointer) : NULL;
+    if(slab){
+        unsigned int slot = mld_slab_slot(slab, pointer);
+        if(slot != MLD_SLAB_NO_SLOT) slab->marked[slot >> 6] |= 1ULL << (slot & 63);
+    }else{
+        ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, pointer);
+        if(obj_rec) obj_rec->is_visited = MLD_TRUE;
+    }
+    mld_sweep_step(object_db, MLD_SWEEP_STEP);
+}
+
+#ifdef TRACE
+
+void add_object_to_object_db_with_trace(char *structure_name, ObjectDb *object_db, void *pointer, unsigned int units, StructureDbRecord *struct_rec, MldBoolean boolean_is_root, const char *file, int line){
     ObjectDbRecord *obj_rec = object_db_lookup(structure_name, object_db, pointer);
     obj_rec = calloc(1, sizeof(ObjectDbRecord));
     obj_rec->next = NULL;
@@ -315,9 +1329,13 @@ void add_object_to_object_db(char *structure_name, ObjectDb *object_db, void *po
     obj_rec->units = units;
     obj_rec->structure_record = struct_rec;
     obj_rec->is_root = boolean_is_root;
+    obj_rec->is_visited = object_db->sweep.pending;
+    obj_rec->alloc_file = file;
+    obj_rec->alloc_line = line;
 
-    //get the hash value of the structure name
-    unsigned int hash = polynonial_rolling_hash(struct_rec->structure_name);//here object_name shall be used
+    //get the hash value of the object address
+    mld_object_table_reserve(object_db, (unsigned long)object_db->count + 1);
+    unsigned int hash = object_db_hash_pointer(object_db, pointer);
 
     //add the object record to the hash table
     if(object_db->object_db_arr[hash]){
@@ -327,44 +1345,67 @@ void add_object_to_object_db(char *structure_name, ObjectDb *object_db, void *po
         object_db->object_db_arr[hash] = obj_rec;
     }
     object_db->count++;
+    mld_generations_track(object_db, obj_rec);
+    mld_stats_record_alloc(struct_rec, units);
+    printf("[OBJECT ADDED] %s : Line %d - Added object %p (%s) to database\n",
+        file, line, pointer, struct_rec->structure_name);
 }
 
-
-
-void *xcalloc(ObjectDb *object_db, char *structure_name, int units){
+void *xcalloc_with_trace(ObjectDb *object_db, char *structure_name, int units, const char *file, int line){
 
     StructureDbRecord *struct_rec = struct_db_lookup(object_db->struct_db, structure_name);
-    void *pointer = calloc(units, struct_rec->structure_size);
+    MldHeapKind kind;
+    void *pointer;
+    if(object_db->sweep.pending) mld_sweep_step(object_db, MLD_SWEEP_STEP);
+    if(mld_slab_eligible(object_db, struct_rec, units) && (pointer = mld_slab_alloc(object_db, struct_rec, MLD_TRUE))){
+        printf("[ALLOC] %s : Line %d - Allocated %d units for %s at %p (slab)\n",
+            file, line, units, structure_name, pointer);
+        return pointer;
+    }
+    pointer = mld_heap_alloc(object_db, (size_t)units * struct_rec->structure_size, MLD_TRUE, &kind);
     if(!pointer) {
         printf("Memory allocation failed.\n");
         exit(1);
     }
 
     // Add object to db
-    add_object_to_object_db(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE);
-
+    add_object_to_object_db_with_trace(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE, file, line);
+    mld_heap_mark_added(object_db, pointer, kind);
+    printf("[ALLOC] %s : Line %d - Allocated %d units for %s at %p\n",
+           file, line, units, structure_name, pointer);
     return pointer;
 }
 
-void *xmalloc(ObjectDb *object_db, char *structure_name, int units){
+void *xmalloc_with_trace(ObjectDb *object_db, char *structure_name, int units, const char *file, int line){
 
     StructureDbRecord *struct_rec = struct_db_lookup(object_db->struct_db, structure_name);
-    void *pointer = malloc(units * struct_rec->structure_size);
+    MldHeapKind kind;
+    void *pointer;
+    if(object_db->sweep.pending) mld_sweep_step(object_db, MLD_SWEEP_STEP);
+    if(mld_slab_eligible(object_db, struct_rec, units) && (pointer = mld_slab_alloc(object_db, struct_rec, MLD_FALSE))){
+        printf("[ALLOC] %s : Line %d - Allocated %d units for %s at %p (slab)\n",
+            file, line, units, structure_name, pointer);
+        return pointer;
+    }
+    pointer = mld_heap_alloc(object_db, (size_t)units * struct_rec->structure_size, MLD_FALSE, &kind);
     if(!pointer) {
         printf("Memory allocation failed.\n");
         exit(1);
     }
 
     // Add object to db
-    add_object_to_object_db(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE);
+    add_object_to_object_db_with_trace(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE, file, line);
+    mld_heap_mark_added(object_db, pointer, kind);
+    printf("[ALLOC] %s : Line %d - Allocated %d units for %s at %p\n",
+        file, line, units, structure_name, pointer);
     return pointer;
 }
 
-void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *obj_rec){
+void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *obj_rec, const char *file, int line){
     assert(obj_rec);
 
-    //get the hash value of the structure name
-    unsigned int hash = polynonial_rolling_hash(obj_rec->structure_record->structure_name); //object_name shall be used
+    //get the hash value of the object address
+    unsigned int hash = object_db_hash_pointer(object_db, obj_rec->pointer);
 
     //delete the object record from the hash table
     ObjectDbRecord *head = object_db->object_db_arr[hash];
@@ -377,6 +1418,9 @@ void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *ob
             }else{
                 object_db->object_db_arr[hash] = head->next;
             }
+            printf("[OBJECT REMOVED] %s : Line %d - Freed object %p\n", file, line, head->pointer);
+            mld_generations_forget(object_db, head);
+            mld_stats_record_free(head->structure_record, head->units);
             free(head);
             object_db->count--;
             return;
@@ -384,19 +1428,85 @@ void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *ob
     }
 }
 
-void xfree(char *structure_name, ObjectDb *object_db, void *pointer){
+void xfree_with_trace(char *structure_name, ObjectDb *object_db, void *pointer, const char *file, int line){
     if(!pointer) return;
+    if(mld_slab_release(object_db, pointer, file, line, __builtin_return_address(0))){
+        printf("[FREE] %s : Line %d - Freed object %p (slab)\n", file, line, pointer);
+        return;
+    }
 
     ObjectDbRecord *obj_rec = object_db_lookup(structure_name, object_db, pointer);
+    if(!obj_rec){
+        mld_report_free_error(object_db, pointer, file, line, __builtin_return_address(0));
+        return;
+    }
+
+    MldHeapKind kind = obj_rec->heap_kind;
+    size_t size = (size_t)obj_rec->units * obj_rec->structure_record->structure_size;
+    mld_check_record(object_db, obj_rec, "xfree");
+    mld_remember_freed(object_db, pointer, obj_rec->structure_record);
+
+    //record is unlinked first, its bucket is derived from the object address
+    delete_object_record_from_object_db(object_db, obj_rec, file, line);
+    mld_heap_free(object_db, pointer, size, kind);
+
+    printf("[FREE] %s : Line %d - Freed object %p\n", file, line, pointer);
+
+}
+
+void *xrealloc_with_trace(ObjectDb *object_db, char *structure_name, void *pointer, int new_units, const char *file, int line){
+    assert(new_units >= 0);
+    if(!pointer) return new_units ? xmalloc_with_trace(object_db, structure_name, new_units, file, line) : NULL;
+    if(!new_units){
+        xfree_with_trace(structure_name, object_db, pointer, file, line);
+        return NULL;
+    }
+    mld_sweep_step_keeping(object_db, pointer);
+
+    MldSlab *slab = object_db->slab_heap ? mld_slab_of(object_db->slab_heap, pointer) : NULL;
+    if(slab){
+        unsigned int slot = mld_slab_slot(slab, pointer);
+        assert(slot != MLD_SLAB_NO_SLOT && mld_slab_bit(slab->live, slot));
+        if(new_units == 1) return pointer;
+        StructureDbRecord *struct_rec = slab->record.structure_record;
+        MldHeapKind kind;
+        void *new_pointer = mld_heap_alloc(object_db, (size_t)new_units * struct_rec->structure_size, MLD_FALSE, &kind);
+        if(!new_pointer) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        memcpy(new_pointer, pointer, struct_rec->structure_size);
+        add_object_to_object_db_with_trace(struct_rec->structure_name, object_db, new_pointer, new_units, struct_rec, MLD_FALSE, file, line);
+        mld_heap_mark_added(object_db, new_pointer, kind);
+        mld_slab_free(object_db->slab_heap, slab, pointer);
+        printf("[REALLOC] %s : Line %d - Moved %s at %p out of its slab to %d units at %p\n",
+            file, line, struct_rec->structure_name, pointer, new_units, new_pointer);
+        return new_pointer;
+    }
+
+    ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, pointer);
     assert(obj_rec);
 
-    free(obj_rec->pointer);
-    obj_rec->pointer = NULL;
+    size_t structure_size = obj_rec->structure_record->structure_size;
+    mld_check_record(object_db, obj_rec, "xrealloc");
+    void *new_pointer = mld_heap_realloc(object_db, pointer, (size_t)obj_rec->units * structure_size,
+                                         (size_t)new_units * structure_size, obj_rec->heap_kind);
+    if(!new_pointer) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
 
-    delete_object_record_from_object_db(object_db, obj_rec);
+    mld_stats_record_resize(obj_rec->structure_record, obj_rec->units, new_units);
+    obj_rec->units = new_units;
+    if(new_pointer != pointer){
+        object_db_move_record(object_db, obj_rec, new_pointer);
+    }
+    printf("[REALLOC] %s : Line %d - Resized %s at %p to %d units at %p\n",
+        file, line, obj_rec->structure_record->structure_name, pointer, new_units, new_pointer);
+    return new_pointer;
 }
 
-void mld_dump_object_rec_detail(ObjectDbRecord *object_Record){
+void mld_dump_object_rec_detail_with_trace(ObjectDbRecord *object_Record, const char *file, int line){
     if(!object_Record || object_Record->structure_record==0) return;
     printf("object_Record: %p\n", object_Record);
     printf("object_Record->structure_record: %p\n", object_Record->structure_record);
@@ -444,6 +1554,8 @@ void mld_dump_object_rec_detail(ObjectDbRecord *object_Record){
                     break;
                 case OBJECT_pointer_TYPE:
                 case VOID_pointer_TYPE:
+                case OBJECT_pointer_ARRAY_TYPE:
+                case OBJECT_pointer_DYNAMIC_ARRAY_TYPE:
                     printf("    %-20s : %p\n", field->field_name, *(void **)field_addr);
                     break;
                 case OBJECT_STRUCT_TYPE:
@@ -458,26 +1570,266 @@ void mld_dump_object_rec_detail(ObjectDbRecord *object_Record){
     }
 }
 
-#endif
+#else
 
-void print_object_record(ObjectDbRecord *object_record) {
+/*
+similar to the structure db, the object db is also implemented as a hashmap, 
+if hash value is already occupied, then the new object record is added to the head of the linked list
+if hash value is not occupied, then the new object record is added to the hash table
+*/
 
-    if (!object_record || object_record->structure_record==0) return;
+void add_object_to_object_db(char *structure_name, ObjectDb *object_db, void *pointer, unsigned int units, StructureDbRecord *struct_rec, MldBoolean boolean_is_root){
+    ObjectDbRecord *obj_rec = object_db_lookup(structure_name, object_db, pointer);
+    obj_rec = calloc(1, sizeof(ObjectDbRecord));
+    obj_rec->next = NULL;
+    obj_rec->pointer = pointer;
+    obj_rec->units = units;
+    obj_rec->structure_record = struct_rec;
+    obj_rec->is_root = boolean_is_root;
+    obj_rec->is_visited = object_db->sweep.pending;
 
-    // Dump object details
-    mld_dump_object_rec_detail(object_record);
+    //get the hash value of the object address
+    mld_object_table_reserve(object_db, (unsigned long)object_db->count + 1);
+    unsigned int hash = object_db_hash_pointer(object_db, pointer);
 
-    printf("|------------------------------------------------------------------------------------------------------|\n\n");
+    //add the object record to the hash table
+    if(object_db->object_db_arr[hash]){
+        obj_rec->next = object_db->object_db_arr[hash];
+        object_db->object_db_arr[hash] = obj_rec;
+    }else{
+        object_db->object_db_arr[hash] = obj_rec;
+    }
+    object_db->count++;
+    mld_generations_track(object_db, obj_rec);
+    mld_stats_record_alloc(struct_rec, units);
 }
 
-void print_object_database(ObjectDb *object_db){
-    if(!object_db) return;
 
-    printf("Printing OBJECT DATABASE\n");
 
-    //iterate through the hash table of object db, to print all the object records
-    for(int i = 0; i<TABLE_SIZE; i++){
-        ObjectDbRecord *object_record = object_db->object_db_arr[i];
+void *xcalloc(ObjectDb *object_db, char *structure_name, int units){
+
+    StructureDbRecord *struct_rec = struct_db_lookup(object_db->struct_db, structure_name);
+    MldHeapKind kind;
+    void *pointer;
+    if(object_db->sweep.pending) mld_sweep_step(object_db, MLD_SWEEP_STEP);
+    if(mld_slab_eligible(object_db, struct_rec, units) && (pointer = mld_slab_alloc(object_db, struct_rec, MLD_TRUE))) return pointer;
+    pointer = mld_heap_alloc(object_db, (size_t)units * struct_rec->structure_size, MLD_TRUE, &kind);
+    if(!pointer) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    // Add object to db
+    add_object_to_object_db(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE);
+    mld_heap_mark_added(object_db, pointer, kind);
+
+    return pointer;
+}
+
+void *xmalloc(ObjectDb *object_db, char *structure_name, int units){
+
+    StructureDbRecord *struct_rec = struct_db_lookup(object_db->struct_db, structure_name);
+    MldHeapKind kind;
+    void *pointer;
+    if(object_db->sweep.pending) mld_sweep_step(object_db, MLD_SWEEP_STEP);
+    if(mld_slab_eligible(object_db, struct_rec, units) && (pointer = mld_slab_alloc(object_db, struct_rec, MLD_FALSE))) return pointer;
+    pointer = mld_heap_alloc(object_db, (size_t)units * struct_rec->structure_size, MLD_FALSE, &kind);
+    if(!pointer) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    // Add object to db
+    add_object_to_object_db(structure_name, object_db, pointer, units, struct_rec, MLD_FALSE);
+    mld_heap_mark_added(object_db, pointer, kind);
+    return pointer;
+}
+
+void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *obj_rec){
+    assert(obj_rec);
+
+    //get the hash value of the object address
+    unsigned int hash = object_db_hash_pointer(object_db, obj_rec->pointer);
+
+    //delete the object record from the hash table
+    ObjectDbRecord *head = object_db->object_db_arr[hash];
+    ObjectDbRecord *prev = NULL;
+
+    for(; head; prev = head, head = head->next){
+        if(head == obj_rec){
+            if(prev){
+                prev->next = head->next;
+            }else{
+                object_db->object_db_arr[hash] = head->next;
+            }
+            mld_generations_forget(object_db, head);
+            mld_stats_record_free(head->structure_record, head->units);
+            free(head);
+            object_db->count--;
+            return;
+        }
+    }
+}
+
+void xfree(char *structure_name, ObjectDb *object_db, void *pointer){
+    if(!pointer) return;
+    if(mld_slab_release(object_db, pointer, NULL, 0, __builtin_return_address(0))) return;
+
+    ObjectDbRecord *obj_rec = object_db_lookup(structure_name, object_db, pointer);
+    if(!obj_rec){
+        mld_report_free_error(object_db, pointer, NULL, 0, __builtin_return_address(0));
+        return;
+    }
+
+    MldHeapKind kind = obj_rec->heap_kind;
+    size_t size = (size_t)obj_rec->units * obj_rec->structure_record->structure_size;
+    mld_check_record(object_db, obj_rec, "xfree");
+    mld_remember_freed(object_db, pointer, obj_rec->structure_record);
+
+    //record is unlinked first, its bucket is derived from the object address
+    delete_object_record_from_object_db(object_db, obj_rec);
+    mld_heap_free(object_db, pointer, size, kind);
+}
+
+/*
+xrealloc resizes a tracked object to new_units units of its own structure type,
+the existing object record is updated in place, it is re-indexed only when realloc moved the block
+like realloc, a NULL pointer is an xmalloc of structure_name & 0 units is an xfree returning NULL,
+structure_name is not used otherwise
+*/
+void *xrealloc(ObjectDb *object_db, char *structure_name, void *pointer, int new_units){
+    assert(new_units >= 0);
+    if(!pointer) return new_units ? xmalloc(object_db, structure_name, new_units) : NULL;
+    if(!new_units){
+        xfree(structure_name, object_db, pointer);
+        return NULL;
+    }
+    mld_sweep_step_keeping(object_db, pointer);
+
+    //a slab object keeps its slot while it stays one unit, otherwise it moves to a tracked block & its slot is freed
+    MldSlab *slab = object_db->slab_heap ? mld_slab_of(object_db->slab_heap, pointer) : NULL;
+    if(slab){
+        unsigned int slot = mld_slab_slot(slab, pointer);
+        assert(slot != MLD_SLAB_NO_SLOT && mld_slab_bit(slab->live, slot));
+        if(new_units == 1) return pointer;
+        StructureDbRecord *struct_rec = slab->record.structure_record;
+        MldHeapKind kind;
+        void *new_pointer = mld_heap_alloc(object_db, (size_t)new_units * struct_rec->structure_size, MLD_FALSE, &kind);
+        if(!new_pointer) {
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        memcpy(new_pointer, pointer, struct_rec->structure_size);
+        add_object_to_object_db(struct_rec->structure_name, object_db, new_pointer, new_units, struct_rec, MLD_FALSE);
+        mld_heap_mark_added(object_db, new_pointer, kind);
+        mld_slab_free(object_db->slab_heap, slab, pointer);
+        return new_pointer;
+    }
+
+    ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, pointer);
+    assert(obj_rec);
+
+    size_t structure_size = obj_rec->structure_record->structure_size;
+    mld_check_record(object_db, obj_rec, "xrealloc");
+    void *new_pointer = mld_heap_realloc(object_db, pointer, (size_t)obj_rec->units * structure_size,
+                                         (size_t)new_units * structure_size, obj_rec->heap_kind);
+    if(!new_pointer) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    mld_stats_record_resize(obj_rec->structure_record, obj_rec->units, new_units);
+    obj_rec->units = new_units;
+    if(new_pointer != pointer){
+        object_db_move_record(object_db, obj_rec, new_pointer);
+    }
+    return new_pointer;
+}
+
+void mld_dump_object_rec_detail(ObjectDbRecord *object_Record){
+    if(!object_Record || object_Record->structure_record==0) return;
+    printf("object_Record: %p\n", object_Record);
+    printf("object_Record->structure_record: %p\n", object_Record->structure_record);
+    printf("object_Record->structure_record->structure_name: %s\n", object_Record->structure_record->structure_name);
+    printf("object_Record->structure_record->structure_size: %d\n", object_Record->structure_record->structure_size);
+    printf("object_Record->structure_record->field_count: %d\n", object_Record->structure_record->field_count);
+    printf("object_Record->pointer: %p\n", object_Record->pointer);
+    printf("object_Record->units: %d\n", object_Record->units);
+    printf("object_Record->is_visited: %d\n", object_Record->is_visited);
+    printf("object_Record->is_root: %d\n", object_Record->is_root);
+
+    int field_count = object_Record->structure_record->field_count;
+    printf("Field count: %d\n", field_count);
+    FieldInfo *field = NULL;
+
+    int units = object_Record->units, obj_index = 0;
+
+    for (; obj_index < units; obj_index++) {
+        // printf("Object index: %d\n", obj_index);
+        char *current_object_ptr = (char *)(object_Record->pointer) +
+                                   (obj_index * object_Record->structure_record->structure_size);
+
+        printf("  Instance %d Address Range: [%p - %p]\n", obj_index,
+               current_object_ptr,
+               current_object_ptr + object_Record->structure_record->structure_size - 1);
+
+        for (int field_index = 0; field_index < field_count; field_index++) {
+            field = &object_Record->structure_record->fields[field_index];
+            void *field_addr = (void *)(current_object_ptr + field->offset);
+
+            switch (field->data_type) {
+                case UINT8_TYPE:
+                case INT32_TYPE:
+                case UINT32_TYPE:
+                    printf("    %-20s : %d\n", field->field_name, *(int *)field_addr);
+                    break;
+                case CHAR_TYPE:
+                    printf("    %-20s : %c\n", field->field_name, *(char *)field_addr);
+                    break;
+                case FLOAT_TYPE:
+                    printf("    %-20s : %.2f\n", field->field_name, *(float *)field_addr);
+                    break;
+                case DOUBLE_TYPE:
+                    printf("    %-20s : %.2lf\n", field->field_name, *(double *)field_addr);
+                    break;
+                case OBJECT_pointer_TYPE:
+                case VOID_pointer_TYPE:
+                case OBJECT_pointer_ARRAY_TYPE:
+                case OBJECT_pointer_DYNAMIC_ARRAY_TYPE:
+                    printf("    %-20s : %p\n", field->field_name, *(void **)field_addr);
+                    break;
+                case OBJECT_STRUCT_TYPE:
+                    printf("    %-20s : [Nested Structure: %s] @ %p\n",
+                           field->field_name, field->nested_structure_name, *(void **)field_addr);
+                    break;
+                default:
+                    printf("    %-20s : UNKNOWN DATA TYPE\n", field->field_name);
+            }
+        }
+        printf("\n");
+    }
+}
+
+#endif
+
+void print_object_record(ObjectDbRecord *object_record) {
+
+    if (!object_record || object_record->structure_record==0) return;
+
+    // Dump object details
+    mld_dump_object_rec_detail(object_record);
+
+    printf("|------------------------------------------------------------------------------------------------------|\n\n");
+}
+
+void print_object_database(ObjectDb *object_db){
+    if(!object_db) return;
+
+    printf("Printing OBJECT DATABASE\n");
+
+    //iterate through the hash table of object db, to print all the object records
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        ObjectDbRecord *object_record = object_db->object_db_arr[i];
         for(; object_record && object_record->structure_record!=0; object_record = object_record->next){
             print_object_record(object_record);
         }
@@ -491,14 +1843,26 @@ void register_global_object_as_root(ObjectDb *object_db, void *object_ptr, char
 }
 
 void set_dynamic_object_as_root(char* structure_name, ObjectDb *object_db, void *object_ptr){
+    MldSlab *slab = object_db->slab_heap ? mld_slab_of(object_db->slab_heap, object_ptr) : NULL;
+    if(slab){
+        unsigned int slot = mld_slab_slot(slab, object_ptr);
+        assert(slot != MLD_SLAB_NO_SLOT && mld_slab_bit(slab->live, slot));
+        if(!mld_slab_bit(slab->roots, slot)){
+            slab->roots[slot >> 6] |= 1ULL << (slot & 63);
+            slab->root_count++;
+        }
+        return;
+    }
+
     ObjectDbRecord *obj_rec = object_db_lookup(structure_name, object_db, object_ptr);
     assert(obj_rec);
     obj_rec->is_root = MLD_TRUE;
+    if(object_db->generations && obj_rec->is_old) mld_remembered_add(object_db->generations, obj_rec);
 }
 
 ObjectDbRecord *get_next_root_object(ObjectDb *object_db, ObjectDbRecord *prev_root_obj){
     //iterate through the hash table of object db, to get the next root object
-    for(int i = 0; i<TABLE_SIZE; i++){
+    for(unsigned int i = 0; i < object_db->table_size; i++){
         ObjectDbRecord *object_record = object_db->object_db_arr[i];
         for(; object_record && object_record->structure_record!=0; object_record = object_record->next){
             if(object_record->is_root && object_record != prev_root_obj && !object_record->is_visited){
@@ -511,67 +1875,2696 @@ ObjectDbRecord *get_next_root_object(ObjectDb *object_db, ObjectDbRecord *prev_r
 
 void init_mld_algorithm(ObjectDb *object_db){
     //initialize the mld algorithm, set is_visited = false for all objects
-    for(int i = 0; i<TABLE_SIZE; i++){
+    for(unsigned int i = 0; i < object_db->table_size; i++){
         ObjectDbRecord *object_record = object_db->object_db_arr[i];
         for(; object_record; object_record = object_record->next){
             object_record->is_visited = MLD_FALSE;
         }
     }
+
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+    for(unsigned int s = 0; slab_heap && s < slab_heap->slab_count; s++)
+        memset(slab_heap->slabs[s]->marked, 0, sizeof(slab_heap->slabs[s]->marked));
 }
 
-void mld_explore_objects_recursively(ObjectDb *object_db, ObjectDbRecord *parent_obj_rec){
-    //explore all objects reachable from the parent object recursively
-    for(int i = 0; i<parent_obj_rec->structure_record->field_count; i++){
-        FieldInfo *field = &parent_obj_rec->structure_record->fields[i];
-        if(field->data_type == OBJECT_pointer_TYPE || field->data_type == VOID_pointer_TYPE){
-            void *child_obj_address = (char *)parent_obj_rec->pointer + field->offset;
-            if(!child_obj_address) continue;
+/*candidate pointer filter*/
 
-            ObjectDbRecord *child_obj_rec = object_db_lookup(parent_obj_rec->structure_record->structure_name, object_db, child_obj_address);
-            assert(child_obj_rec);
+//sets bounds & alignment & allocates the page bitmap, returns 0 if there are no objects
+static int mld_candidate_filter_init(MldCandidateFilter *filter, uintptr_t low, uintptr_t high, uintptr_t address_bits){
+    memset(filter, 0, sizeof(MldCandidateFilter));
+    if(!high) return 0;
+    filter->low = low;
+    filter->high = high;
+    filter->align_mask = (address_bits & -address_bits) - 1;
 
-            if(!child_obj_rec->is_visited){
-                child_obj_rec->is_visited = MLD_TRUE;
-                mld_explore_objects_recursively(object_db, child_obj_rec);
-            }
-            else{
-                continue;
-            }
+    //coarse page bitmap, pages are at least 4 KiB & grow until the span fits MLD_PAGE_BITMAP_MAX_BITS bits
+    unsigned int page_shift = 12;
+    while(((high - low) >> page_shift) >= MLD_PAGE_BITMAP_MAX_BITS) page_shift++;
+    size_t bitmap_words = (((high - low) >> page_shift) >> 6) + 1;
+    filter->page_shift = page_shift;
+    filter->page_bitmap = calloc(bitmap_words, sizeof(uint64_t));
+    if(!filter->page_bitmap){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    return 1;
+}
+
+static inline void mld_candidate_filter_add_page(MldCandidateFilter *filter, void *pointer){
+    uintptr_t page = ((uintptr_t)pointer - filter->low) >> filter->page_shift;
+    filter->page_bitmap[page >> 6] |= 1ULL << (page & 63);
+}
+
+void mld_candidate_filter_build(ObjectDb *object_db, MldCandidateFilter *filter){
+    //bounds & common alignment of all live objects
+    uintptr_t low = UINTPTR_MAX, high = 0, address_bits = 0;
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            uintptr_t address = (uintptr_t)obj_rec->pointer;
+            if(address < low) low = address;
+            if(address > high) high = address;
+            address_bits |= address;
         }
     }
+    //slab objects lie at base + slot * size, so a slab adds its base, its last slot & the alignment of its stride
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+    for(unsigned int s = 0; slab_heap && s < slab_heap->slab_count; s++){
+        ObjectDbRecord *slab_rec = &slab_heap->slabs[s]->record;
+        uintptr_t base = (uintptr_t)slab_rec->pointer;
+        uintptr_t last = base + (uintptr_t)(slab_rec->units - 1) * slab_rec->structure_record->structure_size;
+        if(base < low) low = base;
+        if(last > high) high = last;
+        address_bits |= base | slab_rec->structure_record->structure_size;
+    }
+    if(!mld_candidate_filter_init(filter, low, high, address_bits)) return;
+
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next)
+            mld_candidate_filter_add_page(filter, obj_rec->pointer);
+    }
+    for(unsigned int s = 0; slab_heap && s < slab_heap->slab_count; s++){
+        ObjectDbRecord *slab_rec = &slab_heap->slabs[s]->record;
+        char *last = (char *)slab_rec->pointer + (size_t)(slab_rec->units - 1) * slab_rec->structure_record->structure_size;
+        for(char *page = slab_rec->pointer; page < last; page += (size_t)1 << filter->page_shift)
+            mld_candidate_filter_add_page(filter, page);
+        mld_candidate_filter_add_page(filter, last);
+    }
 }
 
-void run_mld_algorithm(ObjectDb *object_db){
-    if(!object_db) return;
-    init_mld_algorithm(object_db);
+//filter over young objects only, a minor scan never looks up an old object
+static void mld_candidate_filter_build_young(MldGenerations *generations, MldCandidateFilter *filter){
+    uintptr_t low = UINTPTR_MAX, high = 0, address_bits = 0;
+    for(ObjectDbRecord *obj_rec = generations->young; obj_rec; obj_rec = obj_rec->young_next){
+        uintptr_t address = (uintptr_t)obj_rec->pointer;
+        if(address < low) low = address;
+        if(address > high) high = address;
+        address_bits |= address;
+    }
+    if(!mld_candidate_filter_init(filter, low, high, address_bits)) return;
 
-    ObjectDbRecord *root_obj = get_next_root_object(object_db, NULL);
+    for(ObjectDbRecord *obj_rec = generations->young; obj_rec; obj_rec = obj_rec->young_next)
+        mld_candidate_filter_add_page(filter, obj_rec->pointer);
+}
 
-    while(root_obj){
-        if(root_obj->is_visited){
-            root_obj = get_next_root_object(object_db, root_obj);
-            continue;
-        }
+void mld_candidate_filter_free(MldCandidateFilter *filter){
+    free(filter->page_bitmap);
+    memset(filter, 0, sizeof(MldCandidateFilter));
+}
 
-        root_obj->is_visited = MLD_TRUE;
-        mld_explore_objects_recursively(object_db, root_obj);
+//stores word & keeps it if pass (0 or 1) is set & its page bit is set, words which do not pass read page 0 harmlessly
+static inline size_t mld_filter_lane(const MldCandidateFilter *filter, uintptr_t word, uintptr_t pass, uintptr_t *out, size_t kept){
+    uintptr_t page = ((word - filter->low) & -pass) >> filter->page_shift;
+    out[kept] = word;
+    return kept + (pass & (filter->page_bitmap[page >> 6] >> (page & 63)));
+}
 
-        root_obj = get_next_root_object(object_db, root_obj);
+static size_t mld_filter_candidates_scalar(const MldCandidateFilter *filter, const uintptr_t *words, size_t count, uintptr_t *out){
+    uintptr_t low = filter->low, span = filter->high - filter->low, align_mask = filter->align_mask;
+    size_t kept = 0;
+
+    //branch free, a mispredicted branch per word costs more than the bitmap read
+    for(size_t i = 0; i<count; i++){
+        uintptr_t word = words[i];
+        kept = mld_filter_lane(filter, word, ((word - low) <= span) & !(word & align_mask), out, kept);
     }
+    return kept;
 }
 
-void report_leaked_objects(ObjectDb *object_db){
-    printf("Leaked Objects Report:\n");
+#if defined(__x86_64__)
+#include <immintrin.h>
 
-    //iterate through the hash table of object db, to print all the leaked object records
-    for(int i = 0; i<TABLE_SIZE; i++){
-        ObjectDbRecord *object_record = object_db->object_db_arr[i];
-        for(; object_record && object_record->structure_record!=0; object_record = object_record->next){
-            if(!object_record->is_visited && object_record->structure_record!=0){
-                mld_dump_object_rec_detail(object_record);
+/*
+range check as one signed compare, (word - low) <= span unsigned is (word - low) ^ sign <= span ^ sign signed
+lanes which pass range & alignment come out of movemask as bits, a block with no bit set is skipped,
+any other block goes through the branch free lane step, so dense & sparse input both avoid mispredicts
+out never overtakes the lane being read, so filtering in place is safe
+*/
+__attribute__((target("avx2")))
+static size_t mld_filter_candidates_avx2(const MldCandidateFilter *filter, const uintptr_t *words, size_t count, uintptr_t *out){
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i low = _mm256_set1_epi64x((long long)filter->low);
+    const __m256i span = _mm256_set1_epi64x((long long)((filter->high - filter->low) ^ (uint64_t)INT64_MIN));
+    const __m256i align_mask = _mm256_set1_epi64x((long long)filter->align_mask);
+    const __m256i zero = _mm256_setzero_si256();
+    size_t kept = 0, i = 0;
+
+    for(; i + 8 <= count; i += 8){
+        __m256i a = _mm256_loadu_si256((const __m256i *)(words + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(words + i + 4));
+        __m256i a_outside = _mm256_cmpgt_epi64(_mm256_xor_si256(_mm256_sub_epi64(a, low), sign), span);
+        __m256i b_outside = _mm256_cmpgt_epi64(_mm256_xor_si256(_mm256_sub_epi64(b, low), sign), span);
+        __m256i a_aligned = _mm256_cmpeq_epi64(_mm256_and_si256(a, align_mask), zero);
+        __m256i b_aligned = _mm256_cmpeq_epi64(_mm256_and_si256(b, align_mask), zero);
+        unsigned int mask = (unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(a_outside, a_aligned))) |
+                            (unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(b_outside, b_aligned))) << 4;
+        if(!mask) continue;
+        for(unsigned int lane = 0; lane < 8; lane++)
+            kept = mld_filter_lane(filter, words[i + lane], (mask >> lane) & 1, out, kept);
+    }
+    return kept + mld_filter_candidates_scalar(filter, words + i, count - i, out + kept);
+}
+
+__attribute__((target("sse4.2")))
+static size_t mld_filter_candidates_sse42(const MldCandidateFilter *filter, const uintptr_t *words, size_t count, uintptr_t *out){
+    const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+    const __m128i low = _mm_set1_epi64x((long long)filter->low);
+    const __m128i span = _mm_set1_epi64x((long long)((filter->high - filter->low) ^ (uint64_t)INT64_MIN));
+    const __m128i align_mask = _mm_set1_epi64x((long long)filter->align_mask);
+    const __m128i zero = _mm_setzero_si128();
+    size_t kept = 0, i = 0;
+
+    for(; i + 4 <= count; i += 4){
+        __m128i a = _mm_loadu_si128((const __m128i *)(words + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(words + i + 2));
+        __m128i a_outside = _mm_cmpgt_epi64(_mm_xor_si128(_mm_sub_epi64(a, low), sign), span);
+        __m128i b_outside = _mm_cmpgt_epi64(_mm_xor_si128(_mm_sub_epi64(b, low), sign), span);
+        __m128i a_aligned = _mm_cmpeq_epi64(_mm_and_si128(a, align_mask), zero);
+        __m128i b_aligned = _mm_cmpeq_epi64(_mm_and_si128(b, align_mask), zero);
+        unsigned int mask = (unsigned int)_mm_movemask_pd(_mm_castsi128_pd(_mm_andnot_si128(a_outside, a_aligned))) |
+                            (unsigned int)_mm_movemask_pd(_mm_castsi128_pd(_mm_andnot_si128(b_outside, b_aligned))) << 2;
+        if(!mask) continue;
+        for(unsigned int lane = 0; lane < 4; lane++)
+            kept = mld_filter_lane(filter, words[i + lane], (mask >> lane) & 1, out, kept);
+    }
+    return kept + mld_filter_candidates_scalar(filter, words + i, count - i, out + kept);
+}
+#endif
+
+typedef size_t (*MldFilterKernel)(const MldCandidateFilter *, const uintptr_t *, size_t, uintptr_t *);
+
+static MldFilterKernel mld_filter_kernel;
+static const char *mld_filter_kernel_label;
+
+//resolved once, racing threads all store the same answer
+static void mld_select_filter_kernel(void){
+    const char *forced = getenv("MLD_FILTER_KERNEL");
+    MldFilterKernel kernel = mld_filter_candidates_scalar;
+    const char *label = "scalar";
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && (!forced || !strcmp(forced, "avx2"))){
+        kernel = mld_filter_candidates_avx2;
+        label = "avx2";
+    }else if(__builtin_cpu_supports("sse4.2") && (!forced || !strcmp(forced, "sse4.2"))){
+        kernel = mld_filter_candidates_sse42;
+        label = "sse4.2";
+    }
+#endif
+    mld_filter_kernel_label = label;
+    __atomic_store_n(&mld_filter_kernel, kernel, __ATOMIC_RELEASE);
+}
+
+size_t mld_filter_candidates(const MldCandidateFilter *filter, const uintptr_t *words, size_t count, uintptr_t *out){
+    if(!filter->high) return 0;
+    MldFilterKernel kernel = __atomic_load_n(&mld_filter_kernel, __ATOMIC_ACQUIRE);
+    if(!kernel){
+        mld_select_filter_kernel();
+        kernel = mld_filter_kernel;
+    }
+    return kernel(filter, words, count, out);
+}
+
+const char *mld_filter_kernel_name(void){
+    if(!__atomic_load_n(&mld_filter_kernel, __ATOMIC_ACQUIRE)) mld_select_filter_kernel();
+    return mld_filter_kernel_label;
+}
+
+typedef struct MldWordBuffer {
+    uintptr_t *words;
+    size_t count;
+    size_t capacity;
+} MldWordBuffer;
+
+static void mld_word_buffer_reserve(MldWordBuffer *buffer, size_t extra){
+    if(buffer->count + extra <= buffer->capacity) return;
+    while(buffer->count + extra > buffer->capacity) buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+    buffer->words = realloc(buffer->words, buffer->capacity * sizeof(uintptr_t));
+    if(!buffer->words){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+}
+
+static uint64_t mld_read_length(const char *address, unsigned int size){
+    switch(size){
+        case 1: return *(const uint8_t *)address;
+        case 2: { uint16_t v; memcpy(&v, address, 2); return v; }
+        case 4: { uint32_t v; memcpy(&v, address, 4); return v; }
+        case 8: { uint64_t v; memcpy(&v, address, 8); return v; }
+        default: return 0;
+    }
+}
+
+/*
+append the candidate children of obj_rec to buffer, words which can not be an object address are dropped by the filter,
+survivors still need an object db lookup
+1. pointer fields of every unit, gathered through the flattened offsets & filtered in place,
+   units of a pointer dense structure are one contiguous word range & are filtered straight from the object
+2. dynamic pointer arrays, the buffer address itself, then its elements filtered straight from the buffer,
+   only a tracked buffer is read & the element count is capped at its size, so a garbage length never reads past it
+*/
+static void mld_gather_units(ObjectDb *object_db, const MldCandidateFilter *filter, ObjectDbRecord *obj_rec,
+                             unsigned int first_unit, unsigned int last_unit, MldWordBuffer *buffer){
+    StructureDbRecord *struct_rec = obj_rec->structure_record;
+    size_t start = buffer->count;
+    const char *first_ptr = (const char *)obj_rec->pointer + (size_t)first_unit * struct_rec->structure_size;
+
+    if(struct_rec->pointer_dense){
+        size_t words = (size_t)(last_unit - first_unit) * struct_rec->pointer_offset_count;
+        mld_word_buffer_reserve(buffer, words);
+        buffer->count += mld_filter_candidates(filter, (const uintptr_t *)first_ptr, words, buffer->words + buffer->count);
+    }else if(struct_rec->pointer_offset_count){
+        const unsigned int *offsets = struct_rec->pointer_offsets;
+        unsigned int offset_count = struct_rec->pointer_offset_count;
+        mld_word_buffer_reserve(buffer, (size_t)(last_unit - first_unit) * offset_count);
+
+        uintptr_t *out = buffer->words + buffer->count;
+        const char *unit_ptr = first_ptr;
+        for(unsigned int unit = first_unit; unit < last_unit; unit++, unit_ptr += struct_rec->structure_size){
+            for(unsigned int k = 0; k < offset_count; k++) memcpy(out++, unit_ptr + offsets[k], sizeof(uintptr_t));
+        }
+        buffer->count = start + mld_filter_candidates(filter, buffer->words + start, out - (buffer->words + start),
+                                                      buffer->words + start);
+    }
+
+    for(unsigned int a = 0; a < struct_rec->pointer_array_count; a++){
+        MldPointerArrayField *array = &struct_rec->pointer_arrays[a];
+        const char *unit_ptr = first_ptr;
+        for(unsigned int unit = first_unit; unit < last_unit; unit++, unit_ptr += struct_rec->structure_size){
+            const uintptr_t *elements;
+            memcpy(&elements, unit_ptr + array->offset, sizeof(elements));
+            uint64_t length = mld_read_length(unit_ptr + array->length_offset, array->length_size);
+            if(!elements || !length) continue;
+
+            //an untracked buffer has no known size, its address is the only candidate
+            ObjectDbRecord *buffer_rec = object_db_lookup(NULL, object_db, (void *)elements);
+            uint64_t capacity = buffer_rec ? (uint64_t)buffer_rec->units * buffer_rec->structure_record->structure_size / sizeof(uintptr_t) : 0;
+            MldSlab *slab = !buffer_rec && object_db->slab_heap ? mld_slab_of(object_db->slab_heap, elements) : NULL;
+            if(slab){
+                unsigned int slot = mld_slab_slot(slab, elements);
+                if(slot != MLD_SLAB_NO_SLOT && mld_slab_bit(slab->live, slot))
+                    capacity = slab->record.structure_record->structure_size / sizeof(uintptr_t);
             }
+            if(length > capacity) length = capacity;
+
+            mld_word_buffer_reserve(buffer, length + 1);
+            buffer->words[buffer->count++] = (uintptr_t)elements;
+            if(length) buffer->count += mld_filter_candidates(filter, elements, length, buffer->words + buffer->count);
+        }
+    }
+}
+
+static void mld_gather_children(ObjectDb *object_db, const MldCandidateFilter *filter, ObjectDbRecord *obj_rec,
+                                MldWordBuffer *buffer){
+    mld_gather_units(object_db, filter, obj_rec, 0, obj_rec->units, buffer);
+}
+
+//marker batching, parents whose children are gathered together & candidate lookups kept in flight at once
+#define MLD_MARK_BATCH 16
+#define MLD_MARK_WINDOW 32
+//candidate words gathered per chunk of a large object
+#define MLD_SCAN_CHUNK_WORDS (1u << 16)
+
+//unit of a stack entry when every unit of the record is scanned
+#define MLD_WHOLE_OBJECT 0xFFFFFFFFu
+
+//a slab object is pushed as its slab record & its slot
+typedef struct MldMarkEntry {
+    ObjectDbRecord *record;
+    unsigned int unit;
+} MldMarkEntry;
+
+typedef struct MldRecordStack {
+    MldMarkEntry *entries;
+    size_t count;
+    size_t capacity;
+} MldRecordStack;
+
+static void mld_record_stack_push(MldRecordStack *stack, ObjectDbRecord *obj_rec, unsigned int unit){
+    if(stack->count == stack->capacity){
+        stack->capacity = stack->capacity ? stack->capacity * 2 : 64;
+        stack->entries = realloc(stack->entries, stack->capacity * sizeof(MldMarkEntry));
+        if(!stack->entries){
+            printf("Memory allocation failed.\n");
+            exit(1);
         }
     }
+    stack->entries[stack->count].record = obj_rec;
+    stack->entries[stack->count].unit = unit;
+    stack->count++;
+}
+
+//a candidate inside a slab is marked if it is the start of a live unmarked object, no chain is walked
+static inline void mld_mark_slab_candidate(MldSlab *slab, uintptr_t word, MldRecordStack *stack){
+    unsigned int slot = mld_slab_slot(slab, (void *)word);
+    if(slot == MLD_SLAB_NO_SLOT || !mld_slab_bit(slab->live, slot) || mld_slab_bit(slab->marked, slot)) return;
+    slab->marked[slot >> 6] |= 1ULL << (slot & 63);
+    __builtin_prefetch((void *)word);
+    mld_record_stack_push(stack, &slab->record, slot);
+}
+
+/*
+resolve a window of candidate words against object db & mark the unvisited ones, in three stages
+1. hash every word & prefetch its bucket slot
+2. load the bucket heads & prefetch the first record of each chain
+3. walk all chains in lockstep, one record per chain per round, prefetching the next record of every chain still open
+so up to MLD_MARK_WINDOW cache misses are in flight instead of one dependent miss per record
+newly marked objects are prefetched too, their pointer fields are read when they are popped
+words inside a slab are resolved in stage 1 & take no bucket
+*/
+static void mld_mark_candidates(ObjectDb *object_db, const uintptr_t *words, size_t count, MldRecordStack *stack){
+    unsigned int hashes[MLD_MARK_WINDOW];
+    ObjectDbRecord *cursors[MLD_MARK_WINDOW];
+    const unsigned int no_bucket = 0xFFFFFFFFu;
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+
+    for(size_t base = 0; base < count; base += MLD_MARK_WINDOW){
+        unsigned int window = count - base < MLD_MARK_WINDOW ? (unsigned int)(count - base) : MLD_MARK_WINDOW;
+        const uintptr_t *batch = words + base;
+
+        for(unsigned int i = 0; i < window; i++){
+            MldSlab *slab = slab_heap ? mld_slab_of(slab_heap, (void *)batch[i]) : NULL;
+            if(slab){
+                mld_mark_slab_candidate(slab, batch[i], stack);
+                hashes[i] = no_bucket;
+                continue;
+            }
+            if(!object_db->table_size){
+                hashes[i] = no_bucket;
+                continue;
+            }
+            hashes[i] = object_db_hash_pointer(object_db, (void *)batch[i]);
+            __builtin_prefetch(&object_db->object_db_arr[hashes[i]]);
+        }
+
+        unsigned int open = 0;
+        for(unsigned int i = 0; i < window; i++){
+            cursors[i] = hashes[i] != no_bucket ? object_db->object_db_arr[hashes[i]] : NULL;
+            if(cursors[i]){
+                __builtin_prefetch(cursors[i]);
+                open++;
+            }
+        }
+
+        while(open){
+            open = 0;
+            for(unsigned int i = 0; i < window; i++){
+                ObjectDbRecord *obj_rec = cursors[i];
+                if(!obj_rec) continue;
+
+                if(obj_rec->pointer != (void *)batch[i]){
+                    cursors[i] = obj_rec->next;
+                    if(cursors[i]){
+                        __builtin_prefetch(cursors[i]);
+                        open++;
+                    }
+                    continue;
+                }
+
+                cursors[i] = NULL;
+                if(obj_rec->is_visited) continue;
+                obj_rec->is_visited = MLD_TRUE;
+                __builtin_prefetch(obj_rec->pointer);
+                mld_record_stack_push(stack, obj_rec, MLD_WHOLE_OBJECT);
+            }
+        }
+    }
+}
+
+/*
+a large object is gathered & marked a chunk of units at a time, so the candidate buffer stays bounded however large the object is,
+pointer dense chunks are filtered straight from the mapping
+*/
+static void mld_scan_large_object(ObjectDb *object_db, const MldCandidateFilter *filter, ObjectDbRecord *obj_rec, MldRecordStack *stack){
+    unsigned int words_per_unit = obj_rec->structure_record->pointer_offset_count + obj_rec->structure_record->pointer_array_count;
+    if(!words_per_unit) return;
+    unsigned int chunk_units = MLD_SCAN_CHUNK_WORDS / words_per_unit ? MLD_SCAN_CHUNK_WORDS / words_per_unit : 1;
+    MldWordBuffer chunk = {0};
+
+    for(unsigned int first = 0; first < obj_rec->units; first += chunk_units){
+        unsigned int last = obj_rec->units - first < chunk_units ? obj_rec->units : first + chunk_units;
+        chunk.count = 0;
+        mld_gather_units(object_db, filter, obj_rec, first, last, &chunk);
+        mld_mark_candidates(object_db, chunk.words, chunk.count, stack);
+    }
+    free(chunk.words);
+}
+
+/*
+explore all objects reachable from the parent object
+every unit of the parent is scanned, pointer values are read from the object & looked up in object db,
+values which are not the address of a tracked object (untracked memory, interior pointers) are ignored
+the marker pipelines gather, prefetch & resolve, children of up to MLD_MARK_BATCH parents are gathered into one buffer,
+then resolved by mld_mark_candidates, so lookups from many parents overlap
+traversal uses an explicit stack, a long linked list would overflow the c stack if explored by recursion
+*/
+static void mld_explore_stack(ObjectDb *object_db, const MldCandidateFilter *filter, MldRecordStack *stack){
+    MldWordBuffer children = {0};
+
+    while(stack->count){
+        children.count = 0;
+        for(unsigned int b = 0; b < MLD_MARK_BATCH && stack->count; b++){
+            MldMarkEntry entry = stack->entries[--stack->count];
+            if(entry.unit != MLD_WHOLE_OBJECT) mld_gather_units(object_db, filter, entry.record, entry.unit, entry.unit + 1, &children);
+            else if(entry.record->heap_kind == MLD_HEAP_LARGE) mld_scan_large_object(object_db, filter, entry.record, stack);
+            else mld_gather_children(object_db, filter, entry.record, &children);
+        }
+
+        mld_mark_candidates(object_db, children.words, children.count, stack);
+    }
+    free(children.words);
+}
+
+void mld_explore_objects_recursively(ObjectDb *object_db, const MldCandidateFilter *filter, ObjectDbRecord *parent_obj_rec){
+    MldRecordStack stack = {0};
+    mld_record_stack_push(&stack, parent_obj_rec, MLD_WHOLE_OBJECT);
+    mld_explore_stack(object_db, filter, &stack);
+    free(stack.entries);
+}
+
+//slab roots have no record, all unmarked ones are marked & explored from one stack
+static void mld_explore_slab_roots(ObjectDb *object_db, const MldCandidateFilter *filter){
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+    if(!slab_heap) return;
+
+    MldRecordStack stack = {0};
+    for(unsigned int s = 0; s < slab_heap->slab_count; s++){
+        MldSlab *slab = slab_heap->slabs[s];
+        if(!slab->root_count) continue;
+        for(unsigned int w = 0; w < MLD_SLAB_BITMAP_WORDS; w++){
+            uint64_t pending = slab->roots[w] & ~slab->marked[w];
+            slab->marked[w] |= pending;
+            for(; pending; pending &= pending - 1)
+                mld_record_stack_push(&stack, &slab->record, w * 64 + __builtin_ctzll(pending));
+        }
+    }
+    mld_explore_stack(object_db, filter, &stack);
+    free(stack.entries);
+}
+
+/*root discovery*/
+
+#ifndef MLD_SUSPEND_SIGNAL
+#define MLD_SUSPEND_SIGNAL SIGPWR
+#endif
+#ifndef MLD_RESUME_SIGNAL
+#define MLD_RESUME_SIGNAL SIGXCPU
+#endif
+
+typedef struct MldThreadRoot MldThreadRoot;
+
+struct MldThreadRoot {
+    MldThreadRoot *next;
+    pthread_t thread;
+    char *stack_high; //stack grows down from here
+    char *stack_limit; //lowest address the stack can grow to
+    char *volatile stack_low; //saved by the thread itself when it is stopped
+};
+
+typedef struct MldRootRange {
+    const char *low, *high;
+} MldRootRange;
+
+typedef struct MldRootRanges {
+    MldRootRange *ranges;
+    unsigned int count;
+    unsigned int capacity;
+} MldRootRanges;
+
+//the registry lock is held while stacks are captured, so threads can not come or go meanwhile
+static pthread_mutex_t mld_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t mld_threads_once = PTHREAD_ONCE_INIT;
+static MldThreadRoot *mld_threads;
+static __thread MldThreadRoot *mld_self_thread __attribute__((tls_model("initial-exec")));
+static sem_t mld_suspend_ack;
+
+//frame of a call made from the caller, everything the caller has on its stack lies above it
+static __attribute__((noinline)) char *mld_stack_pointer(void){
+    return __builtin_frame_address(0);
+}
+
+//lowest address of the application's part of the scanning thread's stack, set by mld_enter_scan
+static __thread char *mld_scan_stack_low __attribute__((tls_model("initial-exec")));
+
+/*
+every public scan runs below this frame, so the stack scanned for roots stops short of MLD's own frames,
+whose locals (the candidate filter bounds, records being explored) would otherwise keep objects alive,
+callee saved registers are spilled into this frame first, the application's values in them are scanned with its stack
+*/
+static __attribute__((noinline)) void mld_enter_scan(ObjectDb *object_db, void (*scan)(ObjectDb *)){
+    __builtin_unwind_init();
+    char *saved = mld_scan_stack_low;
+    if(!saved) mld_scan_stack_low = mld_stack_pointer();
+    scan(object_db);
+    mld_scan_stack_low = saved;
+}
+
+//returns the top of the calling thread's stack, its lowest address goes to limit
+static char *mld_stack_bounds(char **limit){
+    pthread_attr_t attr;
+    void *low;
+    size_t size;
+    if(pthread_getattr_np(pthread_self(), &attr)) return NULL;
+    pthread_attr_getstack(&attr, &low, &size);
+    pthread_attr_destroy(&attr);
+    *limit = low;
+    return (char *)low + size;
+}
+
+//runs on the stopped thread, resume signal is blocked by sa_mask until sigsuspend, so a resume sent early is not lost
+static void mld_suspend_handler(int sig){
+    (void)sig;
+    int saved_errno = errno;
+    MldThreadRoot *self = mld_self_thread;
+    if(self){
+        self->stack_low = mld_stack_pointer();
+        sem_post(&mld_suspend_ack);
+        sigset_t wait_mask;
+        sigfillset(&wait_mask);
+        sigdelset(&wait_mask, MLD_RESUME_SIGNAL);
+        sigsuspend(&wait_mask);
+    }
+    errno = saved_errno;
+}
+
+static void mld_resume_handler(int sig){
+    (void)sig;
+}
+
+static void mld_install_suspend_handlers(void){
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    sigfillset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    action.sa_handler = mld_suspend_handler;
+    sigaction(MLD_SUSPEND_SIGNAL, &action, NULL);
+
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = mld_resume_handler;
+    sigaction(MLD_RESUME_SIGNAL, &action, NULL);
+    sem_init(&mld_suspend_ack, 0, 0);
+}
+
+void mld_register_thread(void){
+    if(mld_self_thread) return;
+    pthread_once(&mld_threads_once, mld_install_suspend_handlers);
+
+    MldThreadRoot *self = calloc(1, sizeof(MldThreadRoot));
+    if(!self){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    self->thread = pthread_self();
+    self->stack_high = mld_stack_bounds(&self->stack_limit);
+    assert(self->stack_high);
+
+    pthread_mutex_lock(&mld_threads_lock);
+    self->next = mld_threads;
+    mld_threads = self;
+    pthread_mutex_unlock(&mld_threads_lock);
+    mld_self_thread = self;
+}
+
+void mld_unregister_thread(void){
+    MldThreadRoot *self = mld_self_thread;
+    if(!self) return;
+
+    pthread_mutex_lock(&mld_threads_lock);
+    for(MldThreadRoot **link = &mld_threads; *link; link = &(*link)->next){
+        if(*link == self){
+            *link = self->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mld_threads_lock);
+    mld_self_thread = NULL;
+    free(self);
+}
+
+void mld_enable_root_discovery(ObjectDb *object_db, unsigned int sources){
+    object_db->root_sources = sources;
+}
+
+//stops every registered thread but the caller, returns once all of them saved their stack pointer, registry lock is held
+static void mld_suspend_threads(void){
+    unsigned int stopped = 0;
+    for(MldThreadRoot *thread = mld_threads; thread; thread = thread->next){
+        thread->stack_low = NULL;
+        if(thread != mld_self_thread && !pthread_kill(thread->thread, MLD_SUSPEND_SIGNAL)) stopped++;
+    }
+    while(stopped){
+        if(!sem_wait(&mld_suspend_ack)) stopped--;
+    }
+}
+
+static void mld_resume_threads(void){
+    for(MldThreadRoot *thread = mld_threads; thread; thread = thread->next){
+        if(thread != mld_self_thread && thread->stack_low) pthread_kill(thread->thread, MLD_RESUME_SIGNAL);
+    }
+}
+
+static void mld_root_range_add(MldRootRanges *ranges, const char *low, const char *high){
+    if(low >= high) return;
+    if(ranges->count == ranges->capacity){
+        ranges->capacity = ranges->capacity ? ranges->capacity * 2 : 32;
+        ranges->ranges = realloc(ranges->ranges, ranges->capacity * sizeof(MldRootRange));
+        if(!ranges->ranges){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    ranges->ranges[ranges->count].low = low;
+    ranges->ranges[ranges->count].high = high;
+    ranges->count++;
+}
+
+static int mld_add_data_ranges(struct dl_phdr_info *info, size_t size, void *data){
+    (void)size;
+    for(int i = 0; i < info->dlpi_phnum; i++){
+        const ElfW(Phdr) *phdr = &info->dlpi_phdr[i];
+        if(phdr->p_type != PT_LOAD || !(phdr->p_flags & PF_W)) continue;
+        const char *low = (const char *)(info->dlpi_addr + phdr->p_vaddr);
+        mld_root_range_add(data, low, low + phdr->p_memsz);
+    }
+    return 0;
+}
+
+//aligned words of [low, high) go to word & end
+static void mld_root_range_words(const char *low, const char *high, const uintptr_t **word, const uintptr_t **end){
+    *word = (const uintptr_t *)MLD_ROUND_UP((uintptr_t)low, sizeof(uintptr_t));
+    *end = (const uintptr_t *)((uintptr_t)high & ~(uintptr_t)(sizeof(uintptr_t) - 1));
+    if(*end < *word) *end = *word;
+}
+
+/*
+stops every registered thread but the caller, filters each stopped stack into candidates & resumes them,
+nothing may be allocated meanwhile, a thread stopped inside malloc holds its arena lock,
+so candidates gets room for every word of every registered stack before the first thread is stopped
+*/
+static void mld_capture_thread_roots(const MldCandidateFilter *filter, MldWordBuffer *candidates){
+    pthread_mutex_lock(&mld_threads_lock);
+    size_t words = 0;
+    for(MldThreadRoot *thread = mld_threads; thread; thread = thread->next){
+        if(thread != mld_self_thread) words += (size_t)(thread->stack_high - thread->stack_limit) / sizeof(uintptr_t) + 1;
+    }
+    mld_word_buffer_reserve(candidates, words);
+
+    mld_suspend_threads();
+    for(MldThreadRoot *thread = mld_threads; thread; thread = thread->next){
+        if(thread == mld_self_thread || !thread->stack_low) continue;
+        const uintptr_t *word, *end;
+        mld_root_range_words(thread->stack_low, thread->stack_high, &word, &end);
+        candidates->count += mld_filter_candidates(filter, word, (size_t)(end - word), candidates->words + candidates->count);
+    }
+    mld_resume_threads();
+    pthread_mutex_unlock(&mld_threads_lock);
+}
+
+//every aligned word of [low, high) is a candidate, filtered a chunk at a time & marked, marked objects are pushed on stack
+static void mld_scan_root_range(ObjectDb *object_db, const MldCandidateFilter *filter, const char *low, const char *high,
+                                MldWordBuffer *buffer, MldRecordStack *stack){
+    const uintptr_t *word, *end;
+    mld_root_range_words(low, high, &word, &end);
+    while(word < end){
+        size_t count = (size_t)(end - word) < MLD_SCAN_CHUNK_WORDS ? (size_t)(end - word) : MLD_SCAN_CHUNK_WORDS;
+        buffer->count = 0;
+        mld_word_buffer_reserve(buffer, count);
+        buffer->count = mld_filter_candidates(filter, word, count, buffer->words);
+        mld_mark_candidates(object_db, buffer->words, buffer->count, stack);
+        word += count;
+    }
+}
+
+/*
+scan the discovered root ranges & explore everything they reach
+other registered threads are stopped only while their stacks are filtered, marking runs once they are resumed
+the stack of the calling thread is scanned from where mld_enter_scan left it, MLD's frames below that are skipped
+*/
+static void mld_scan_discovered_roots(ObjectDb *object_db, const MldCandidateFilter *filter){
+    if(!object_db->root_sources || !filter->high) return;
+
+    MldRootRanges ranges = {0};
+    MldWordBuffer buffer = {0};
+    MldRecordStack stack = {0};
+    if(object_db->root_sources & MLD_ROOTS_DATA) dl_iterate_phdr(mld_add_data_ranges, &ranges);
+    if(object_db->root_sources & MLD_ROOTS_STACKS){
+        mld_capture_thread_roots(filter, &buffer);
+        mld_mark_candidates(object_db, buffer.words, buffer.count, &stack);
+        char *limit;
+        char *high = mld_self_thread ? mld_self_thread->stack_high : mld_stack_bounds(&limit);
+        if(high) mld_root_range_add(&ranges, mld_scan_stack_low, high);
+    }
+
+    for(unsigned int i = 0; i < ranges.count; i++)
+        mld_scan_root_range(object_db, filter, ranges.ranges[i].low, ranges.ranges[i].high, &buffer, &stack);
+    mld_explore_stack(object_db, filter, &stack);
+
+    free(buffer.words);
+    free(stack.entries);
+    free(ranges.ranges);
+}
+
+/*generational scanning*/
+
+void mld_enable_generations(ObjectDb *object_db, unsigned int promote_after, unsigned int full_every){
+    assert(!object_db->generations && !object_db->slab_heap);
+    MldGenerations *generations = calloc(1, sizeof(MldGenerations));
+    if(!generations){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    generations->promote_after = promote_after ? promote_after : 1;
+    generations->full_every = full_every ? full_every : 1;
+
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            obj_rec->is_old = MLD_FALSE;
+            obj_rec->survived = 0;
+            obj_rec->remembered_slot = 0;
+            mld_young_push(generations, obj_rec);
+        }
+    }
+    object_db->generations = generations;
+}
+
+void mld_disable_generations(ObjectDb *object_db){
+    MldGenerations *generations = object_db->generations;
+    if(!generations) return;
+
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            obj_rec->is_old = MLD_FALSE;
+            obj_rec->survived = 0;
+            obj_rec->remembered_slot = 0;
+            obj_rec->young_prev = obj_rec->young_next = NULL;
+        }
+    }
+    free(generations->remembered);
+    free(generations);
+    object_db->generations = NULL;
+}
+
+void mld_flush_store_log(ObjectDb *object_db){
+    MldGenerations *generations = object_db->generations;
+    for(unsigned int i = 0; i < generations->store_log_count; i++){
+        ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, generations->store_log[i]);
+        if(obj_rec && obj_rec->is_old) mld_remembered_add(generations, obj_rec);
+    }
+    generations->store_log_count = 0;
+}
+
+static MldBoolean mld_points_to_young(ObjectDb *object_db, const MldCandidateFilter *filter, ObjectDbRecord *obj_rec,
+                                      MldWordBuffer *children){
+    children->count = 0;
+    mld_gather_children(object_db, filter, obj_rec, children);
+    for(size_t c = 0; c < children->count; c++){
+        ObjectDbRecord *child_obj_rec = object_db_lookup(NULL, object_db, (void *)children->words[c]);
+        if(child_obj_rec && !child_obj_rec->is_old) return MLD_TRUE;
+    }
+    return MLD_FALSE;
+}
+
+/*
+end of scan bookkeeping, filter must pass every young object
+1. young objects reached by the scan age by one, those reaching promote_after move to the old generation
+2. remembered objects are kept only while they still point to a young object, old roots are always kept,
+   stores into roots are rarely routed through MLD_STORE
+3. promoted objects which point to a young object, & promoted roots, enter the remembered set
+promoted records are chained through young_next until step 3
+*/
+static void mld_generations_after_scan(ObjectDb *object_db, const MldCandidateFilter *filter){
+    MldGenerations *generations = object_db->generations;
+    MldWordBuffer children = {0};
+    ObjectDbRecord *promoted = NULL;
+
+    for(ObjectDbRecord *obj_rec = generations->young, *next; obj_rec; obj_rec = next){
+        next = obj_rec->young_next;
+        if(!obj_rec->is_visited || ++obj_rec->survived < generations->promote_after) continue;
+        mld_young_unlink(generations, obj_rec);
+        obj_rec->is_old = MLD_TRUE;
+        obj_rec->young_next = promoted;
+        promoted = obj_rec;
+    }
+
+    //walked backwards, a swap remove only moves an entry which was already checked
+    for(unsigned int i = generations->remembered_count; i-- > 0;){
+        ObjectDbRecord *obj_rec = generations->remembered[i];
+        if(!obj_rec->is_root && !mld_points_to_young(object_db, filter, obj_rec, &children))
+            mld_remembered_remove(generations, obj_rec);
+    }
+
+    for(ObjectDbRecord *obj_rec = promoted, *next; obj_rec; obj_rec = next){
+        next = obj_rec->young_next;
+        obj_rec->young_next = NULL;
+        if(obj_rec->is_root || mld_points_to_young(object_db, filter, obj_rec, &children))
+            mld_remembered_add(generations, obj_rec);
+    }
+    free(children.words);
+}
+
+/*
+minor scan, only young objects are reset & marked
+young roots & remembered objects are the starting points, the filter holds young objects only,
+so pointers into the old generation are dropped before any lookup
+*/
+static void mld_minor_scan(ObjectDb *object_db){
+    MldGenerations *generations = object_db->generations;
+    assert(generations);
+    mld_finish_sweep(object_db);
+    mld_flush_store_log(object_db);
+
+    for(ObjectDbRecord *obj_rec = generations->young; obj_rec; obj_rec = obj_rec->young_next){
+        obj_rec->is_visited = MLD_FALSE;
+        if(object_db->debug_heap) mld_check_record(object_db, obj_rec, "scan");
+    }
+
+    MldCandidateFilter filter;
+    mld_candidate_filter_build_young(generations, &filter);
+
+    for(ObjectDbRecord *obj_rec = generations->young; obj_rec; obj_rec = obj_rec->young_next){
+        if(!obj_rec->is_root || obj_rec->is_visited) continue;
+        obj_rec->is_visited = MLD_TRUE;
+        mld_explore_objects_recursively(object_db, &filter, obj_rec);
+    }
+    for(unsigned int i = 0; i < generations->remembered_count; i++)
+        mld_explore_objects_recursively(object_db, &filter, generations->remembered[i]);
+    mld_scan_discovered_roots(object_db, &filter);
+
+    mld_generations_after_scan(object_db, &filter);
+    mld_candidate_filter_free(&filter);
+    generations->scans_since_full++;
+}
+
+static void mld_full_scan(ObjectDb *object_db){
+    mld_finish_sweep(object_db);
+    if(object_db->generations) mld_flush_store_log(object_db);
+    if(object_db->debug_heap) mld_check_redzones(object_db);
+    init_mld_algorithm(object_db);
+
+    MldCandidateFilter filter;
+    mld_candidate_filter_build(object_db, &filter);
+
+    ObjectDbRecord *root_obj = get_next_root_object(object_db, NULL);
+
+    while(root_obj){
+        if(root_obj->is_visited){
+            root_obj = get_next_root_object(object_db, root_obj);
+            continue;
+        }
+
+        root_obj->is_visited = MLD_TRUE;
+        mld_explore_objects_recursively(object_db, &filter, root_obj);
+
+        root_obj = get_next_root_object(object_db, root_obj);
+    }
+    mld_explore_slab_roots(object_db, &filter);
+    mld_scan_discovered_roots(object_db, &filter);
+
+    if(object_db->generations){
+        mld_generations_after_scan(object_db, &filter);
+        object_db->generations->scans_since_full = 0;
+    }
+    mld_candidate_filter_free(&filter);
+}
+
+void mld_run_minor_scan(ObjectDb *object_db){
+    mld_enter_scan(object_db, mld_minor_scan);
+}
+
+void mld_run_full_scan(ObjectDb *object_db){
+    if(!object_db) return;
+    mld_enter_scan(object_db, mld_full_scan);
+}
+
+//without generational scanning every run is a full scan, with it every full_every-th run is
+void run_mld_algorithm(ObjectDb *object_db){
+    if(!object_db) return;
+    MldGenerations *generations = object_db->generations;
+    if(generations && generations->scans_since_full + 1 < generations->full_every){
+        mld_run_minor_scan(object_db);
+        return;
+    }
+    mld_run_full_scan(object_db);
+}
+
+/*collect mode*/
+
+void mld_set_finalizer(StructureDb *struct_db, char *structure_name, MldFinalizer finalizer){
+    StructureDbRecord *struct_rec = struct_db_lookup(struct_db, structure_name);
+    assert(struct_rec);
+    struct_rec->finalizer = finalizer;
+}
+
+//link points at the record in its bucket, the record is unlinked before its finalizer runs
+static void mld_sweep_record(ObjectDb *object_db, ObjectDbRecord **link){
+    ObjectDbRecord *obj_rec = *link;
+    StructureDbRecord *struct_rec = obj_rec->structure_record;
+    size_t size = (size_t)obj_rec->units * struct_rec->structure_size;
+
+    *link = obj_rec->next;
+    object_db->count--;
+    mld_generations_forget(object_db, obj_rec);
+    mld_check_record(object_db, obj_rec, "sweep");
+    if(struct_rec->finalizer) struct_rec->finalizer(obj_rec->pointer, struct_rec, obj_rec->units);
+    mld_stats_record_free(struct_rec, obj_rec->units);
+    mld_heap_free(object_db, obj_rec->pointer, size, obj_rec->heap_kind);
+    free(obj_rec);
+    object_db->sweep.freed_objects++;
+    object_db->sweep.freed_bytes += size;
+}
+
+static void mld_sweep_slab_object(ObjectDb *object_db, MldSlab *slab, unsigned int slot){
+    StructureDbRecord *struct_rec = slab->record.structure_record;
+    void *pointer = (char *)slab->record.pointer + (size_t)slot * struct_rec->structure_size;
+    if(struct_rec->finalizer) struct_rec->finalizer(pointer, struct_rec, 1);
+    mld_slab_free(object_db->slab_heap, slab, pointer);
+    object_db->sweep.freed_objects++;
+    object_db->sweep.freed_bytes += struct_rec->structure_size;
+}
+
+void mld_collect(ObjectDb *object_db){
+    mld_run_full_scan(object_db);
+    MldSweep *sweep = &object_db->sweep;
+    sweep->bucket = sweep->position = sweep->slab = sweep->slot = 0;
+    sweep->pending = MLD_TRUE;
+}
+
+/*
+one bounded step of the pending sweep, the budget counts work done:
+1. every record looked at in a bucket, kept or freed, costs one unit & an empty bucket costs one
+2. every object freed from a slab costs one unit & a bitmap word of a slab with nothing to free costs one
+a bucket or slab left part way keeps its place, the records of a bucket kept so far are stepped over without charge when it is resumed
+*/
+MldBoolean mld_sweep_step(ObjectDb *object_db, unsigned int budget){
+    MldSweep *sweep = &object_db->sweep;
+    if(!sweep->pending || sweep->active) return sweep->pending;
+    sweep->active = MLD_TRUE;
+
+    while(budget && sweep->bucket < object_db->table_size){
+        ObjectDbRecord **head = &object_db->object_db_arr[sweep->bucket];
+        ObjectDbRecord **link = head;
+        for(unsigned int i = 0; i < sweep->position && *link; i++) link = &(*link)->next;
+        if(!*link){
+            if(link == head) budget--;
+            sweep->bucket++;
+            sweep->position = 0;
+            continue;
+        }
+        while(*link && budget){
+            ObjectDbRecord *obj_rec = *link;
+            budget--;
+            if(obj_rec->is_visited || !obj_rec->structure_record){
+                link = &obj_rec->next;
+                sweep->position++;
+                continue;
+            }
+            MldBoolean finalized = obj_rec->structure_record->finalizer ? MLD_TRUE : MLD_FALSE;
+            mld_sweep_record(object_db, link);
+            //a finalizer may have freed records of this bucket, the walk restarts from the head
+            if(finalized){
+                link = head;
+                sweep->position = 0;
+            }
+        }
+        if(*link) break;
+        sweep->bucket++;
+        sweep->position = 0;
+    }
+
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+    while(budget && slab_heap && sweep->slab < slab_heap->slab_count){
+        MldSlab *slab = slab_heap->slabs[sweep->slab];
+        while(budget && sweep->slot < slab->record.units){
+            unsigned int w = sweep->slot >> 6;
+            uint64_t garbage = (slab->live[w] & ~slab->marked[w]) >> (sweep->slot & 63);
+            budget--;
+            if(!garbage){
+                sweep->slot = (w + 1) << 6;
+                continue;
+            }
+            unsigned int slot = sweep->slot + __builtin_ctzll(garbage);
+            if(slot >= slab->record.units){
+                sweep->slot = slab->record.units;
+                break;
+            }
+            sweep->slot = slot + 1;
+            mld_sweep_slab_object(object_db, slab, slot);
+        }
+        if(sweep->slot >= slab->record.units){
+            sweep->slab++;
+            sweep->slot = 0;
+        }
+    }
+
+    if(sweep->bucket >= object_db->table_size && (!slab_heap || sweep->slab >= slab_heap->slab_count)) sweep->pending = MLD_FALSE;
+    sweep->active = MLD_FALSE;
+    return sweep->pending;
+}
+
+//a finalizer which starts a scan can not finish the sweep it is called from, the scan then sees the heap as swept so far
+void mld_finish_sweep(ObjectDb *object_db){
+    if(object_db->sweep.active) return;
+    while(mld_sweep_step(object_db, UINT_MAX));
+}
+
+void report_leaked_objects(ObjectDb *object_db){
+    printf("Leaked Objects Report:\n");
+
+    //iterate through the hash table of object db, to print all the leaked object records
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        ObjectDbRecord *object_record = object_db->object_db_arr[i];
+        for(; object_record && object_record->structure_record!=0; object_record = object_record->next){
+            if(!object_record->is_visited && object_record->structure_record!=0){
+                mld_dump_object_rec_detail(object_record);
+            }
+        }
+    }
+
+    ObjectDbRecord unit_rec;
+    unsigned int slab_index = 0, slot = 0;
+    while(mld_slab_next_leaked(object_db->slab_heap, &slab_index, &slot, &unit_rec)) mld_dump_object_rec_detail(&unit_rec);
+}
+
+/*streaming leak report writer*/
+
+typedef struct MldReportWriter {
+    int fd;
+    int failed;
+    size_t used;
+    char *buffer;
+} MldReportWriter;
+
+static void mld_report_flush(MldReportWriter *writer){
+    size_t done = 0;
+    while(done < writer->used && !writer->failed){
+        ssize_t rc = write(writer->fd, writer->buffer + done, writer->used - done);
+        if(rc < 0){
+            if(errno == EINTR) continue;
+            writer->failed = 1;
+            break;
+        }
+        done += rc;
+    }
+    writer->used = 0;
+}
+
+//every record is far smaller than the buffer, so callers reserve room once per record
+static char *mld_report_reserve(MldReportWriter *writer, size_t size){
+    if(writer->used + size > MLD_REPORT_BUFFER_SIZE) mld_report_flush(writer);
+    return writer->buffer + writer->used;
+}
+
+static void mld_report_str(MldReportWriter *writer, const char *str){
+    size_t len = strlen(str);
+    char *out = mld_report_reserve(writer, len);
+    memcpy(out, str, len);
+    writer->used += len;
+}
+
+static void mld_report_ulong(MldReportWriter *writer, unsigned long value){
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = '0' + value % 10;
+        value /= 10;
+    } while(value);
+
+    char *out = mld_report_reserve(writer, n);
+    for(int i = 0; i < n; i++) out[i] = digits[n - 1 - i];
+    writer->used += n;
+}
+
+static void mld_report_pointer(MldReportWriter *writer, void *pointer){
+    static const char hex[] = "0123456789abcdef";
+    uintptr_t value = (uintptr_t)pointer;
+    char digits[2 * sizeof(uintptr_t)];
+    int n = 0;
+    do {
+        digits[n++] = hex[value & 0xF];
+        value >>= 4;
+    } while(value);
+
+    char *out = mld_report_reserve(writer, n + 2);
+    out[0] = '0';
+    out[1] = 'x';
+    for(int i = 0; i < n; i++) out[2 + i] = digits[n - 1 - i];
+    writer->used += n + 2;
+}
+
+//char fields are written as escaped json strings, at most field size bytes, stops at NUL
+static void mld_report_json_chars(MldReportWriter *writer, const char *chars, unsigned int size){
+    static const char hex[] = "0123456789abcdef";
+    char *out = mld_report_reserve(writer, 2 + 6 * size);
+    size_t n = 0;
+    out[n++] = '"';
+    for(unsigned int i = 0; i < size && chars[i]; i++){
+        unsigned char c = chars[i];
+        if(c >= 0x20 && c < 0x7F && c != '"' && c != '\\'){
+            out[n++] = c;
+        }else{
+            memcpy(out + n, "\\u00", 4);
+            out[n + 4] = hex[c >> 4];
+            out[n + 5] = hex[c & 0xF];
+            n += 6;
+        }
+    }
+    out[n++] = '"';
+    writer->used += n;
+}
+
+//field values of every unit, json: [{"name":value,...},...], csv: name=value;... with units separated by |
+static void mld_report_fields(MldReportWriter *writer, ObjectDbRecord *object_record, MldReportFormat format){
+    StructureDbRecord *struct_rec = object_record->structure_record;
+    char number[64];
+
+    mld_report_str(writer, format == MLD_REPORT_JSONL ? "[" : "\"");
+    for(unsigned int unit = 0; unit < object_record->units; unit++){
+        char *unit_ptr = (char *)object_record->pointer + unit * struct_rec->structure_size;
+        if(unit) mld_report_str(writer, format == MLD_REPORT_JSONL ? "," : "|");
+        if(format == MLD_REPORT_JSONL) mld_report_str(writer, "{");
+
+        for(unsigned int i = 0; i < struct_rec->field_count; i++){
+            FieldInfo *field = &struct_rec->fields[i];
+            void *field_addr = unit_ptr + field->offset;
+
+            if(i) mld_report_str(writer, format == MLD_REPORT_JSONL ? "," : ";");
+            if(format == MLD_REPORT_JSONL){
+                mld_report_str(writer, "\"");
+                mld_report_str(writer, field->field_name);
+                mld_report_str(writer, "\":");
+            }else{
+                mld_report_str(writer, field->field_name);
+                mld_report_str(writer, "=");
+            }
+
+            switch(field->data_type){
+                case UINT8_TYPE:
+                    snprintf(number, sizeof(number), "%u", *(unsigned char *)field_addr);
+                    break;
+                case UINT32_TYPE:
+                    snprintf(number, sizeof(number), "%u", *(unsigned int *)field_addr);
+                    break;
+                case INT32_TYPE:
+                    snprintf(number, sizeof(number), "%d", *(int *)field_addr);
+                    break;
+                case FLOAT_TYPE:
+                case DOUBLE_TYPE: {
+                    double value = field->data_type == FLOAT_TYPE ? *(float *)field_addr : *(double *)field_addr;
+                    //nan & inf have no json spelling
+                    if(!isfinite(value) && format == MLD_REPORT_JSONL) snprintf(number, sizeof(number), "null");
+                    else snprintf(number, sizeof(number), "%g", value);
+                    break;
+                }
+                case CHAR_TYPE:
+                    if(format == MLD_REPORT_JSONL){
+                        mld_report_json_chars(writer, field_addr, field->size);
+                        continue;
+                    }
+                    //csv keeps only the printable characters, the column itself is quoted
+                    number[0] = 0;
+                    for(unsigned int c = 0, n = 0; c < field->size && n < sizeof(number) - 1 && ((char *)field_addr)[c]; c++){
+                        char ch = ((char *)field_addr)[c];
+                        if(ch >= 0x20 && ch < 0x7F && ch != '"' && ch != ';' && ch != '|') number[n++] = ch;
+                        number[n] = 0;
+                    }
+                    break;
+                case OBJECT_pointer_TYPE:
+                case VOID_pointer_TYPE:
+                case OBJECT_pointer_ARRAY_TYPE:
+                case OBJECT_pointer_DYNAMIC_ARRAY_TYPE:
+                    if(format == MLD_REPORT_JSONL) mld_report_str(writer, "\"");
+                    mld_report_pointer(writer, *(void **)field_addr);
+                    if(format == MLD_REPORT_JSONL) mld_report_str(writer, "\"");
+                    continue;
+                default:
+                    snprintf(number, sizeof(number), format == MLD_REPORT_JSONL ? "null" : "");
+            }
+            mld_report_str(writer, number);
+        }
+
+        if(format == MLD_REPORT_JSONL) mld_report_str(writer, "}");
+    }
+    mld_report_str(writer, format == MLD_REPORT_JSONL ? "]" : "\"");
+}
+
+static void mld_report_object(MldReportWriter *writer, ObjectDbRecord *object_record, MldReportFormat format, MldBoolean dump_fields){
+    StructureDbRecord *struct_rec = object_record->structure_record;
+
+    if(format == MLD_REPORT_JSONL){
+        mld_report_str(writer, "{\"type\":\"");
+        mld_report_str(writer, struct_rec->structure_name);
+        mld_report_str(writer, "\",\"address\":\"");
+        mld_report_pointer(writer, object_record->pointer);
+        mld_report_str(writer, "\",\"units\":");
+        mld_report_ulong(writer, object_record->units);
+        mld_report_str(writer, ",\"bytes\":");
+        mld_report_ulong(writer, (unsigned long)object_record->units * struct_rec->structure_size);
+        mld_report_str(writer, object_record->is_root ? ",\"root\":true" : ",\"root\":false");
+        if(dump_fields){
+            mld_report_str(writer, ",\"fields\":");
+            mld_report_fields(writer, object_record, format);
+        }
+        mld_report_str(writer, "}\n");
+    }else{
+        mld_report_str(writer, struct_rec->structure_name);
+        mld_report_str(writer, ",");
+        mld_report_pointer(writer, object_record->pointer);
+        mld_report_str(writer, ",");
+        mld_report_ulong(writer, object_record->units);
+        mld_report_str(writer, ",");
+        mld_report_ulong(writer, (unsigned long)object_record->units * struct_rec->structure_size);
+        mld_report_str(writer, object_record->is_root ? ",1" : ",0");
+        if(dump_fields){
+            mld_report_str(writer, ",");
+            mld_report_fields(writer, object_record, format);
+        }
+        mld_report_str(writer, "\n");
+    }
+}
+
+typedef struct MldLeakTotal {
+    StructureDbRecord *struct_rec; //NULL for a free slot
+    unsigned long objects;
+    unsigned long bytes;
+} MldLeakTotal;
+
+//leaks summed per structure type, open addressing keyed by the structure record, kept at most half full
+typedef struct MldLeakTotals {
+    MldLeakTotal *slots;
+    unsigned int capacity; //power of two
+    unsigned int used;
+} MldLeakTotals;
+
+static inline unsigned int mld_leak_total_hash(const StructureDbRecord *struct_rec, unsigned int capacity){
+    return (unsigned int)((((uintptr_t)struct_rec >> 4) * 0x9E3779B97F4A7C15ULL) >> 32) & (capacity - 1);
+}
+
+static int mld_leak_totals_init(MldLeakTotals *totals, unsigned int capacity){
+    totals->slots = calloc(capacity, sizeof(MldLeakTotal));
+    totals->capacity = capacity;
+    totals->used = 0;
+    return totals->slots ? 0 : -1;
+}
+
+static MldLeakTotal *mld_leak_total_slot(MldLeakTotals *totals, StructureDbRecord *struct_rec){
+    unsigned int i = mld_leak_total_hash(struct_rec, totals->capacity);
+    while(totals->slots[i].struct_rec && totals->slots[i].struct_rec != struct_rec) i = (i + 1) & (totals->capacity - 1);
+    return &totals->slots[i];
+}
+
+//returns -1 if the table had to grow & could not
+static int mld_leak_totals_add(MldLeakTotals *totals, StructureDbRecord *struct_rec, unsigned long bytes){
+    MldLeakTotal *total = mld_leak_total_slot(totals, struct_rec);
+    if(!total->struct_rec){
+        if(2 * (totals->used + 1) > totals->capacity){
+            MldLeakTotals grown;
+            if(mld_leak_totals_init(&grown, totals->capacity * 2)) return -1;
+            for(unsigned int i = 0; i < totals->capacity; i++){
+                if(totals->slots[i].struct_rec) *mld_leak_total_slot(&grown, totals->slots[i].struct_rec) = totals->slots[i];
+            }
+            grown.used = totals->used;
+            free(totals->slots);
+            *totals = grown;
+            total = mld_leak_total_slot(totals, struct_rec);
+        }
+        total->struct_rec = struct_rec;
+        totals->used++;
+    }
+    total->objects++;
+    total->bytes += bytes;
+    return 0;
+}
+
+//one leaked object, summed into the totals of its type when aggregating (totals not NULL), otherwise written out
+static long mld_report_leak(MldReportWriter *writer, ObjectDbRecord *object_record, MldReportFormat format, MldBoolean dump_fields,
+                            MldLeakTotals *totals){
+    if(!totals){
+        mld_report_object(writer, object_record, format, dump_fields);
+        return 1;
+    }
+    StructureDbRecord *struct_rec = object_record->structure_record;
+    if(mld_leak_totals_add(totals, struct_rec, (unsigned long)object_record->units * struct_rec->structure_size)) writer->failed = 1;
+    return 0;
+}
+
+long mld_write_leak_report(ObjectDb *object_db, int fd, MldReportFormat format, MldBoolean aggregate, MldBoolean dump_fields){
+    MldReportWriter writer = {fd, 0, 0, malloc(MLD_REPORT_BUFFER_SIZE)};
+    if(!writer.buffer) return -1;
+
+    //leaks per structure type are summed by structure record, sized for every registered type
+    MldLeakTotals totals = {0};
+    if(aggregate){
+        unsigned int capacity = 16;
+        while(capacity < 2 * (unsigned int)object_db->struct_db->count) capacity *= 2;
+        if(mld_leak_totals_init(&totals, capacity)){
+            free(writer.buffer);
+            return -1;
+        }
+    }
+    MldLeakTotals *leak_totals = aggregate ? &totals : NULL;
+
+    if(format == MLD_REPORT_CSV){
+        if(aggregate) mld_report_str(&writer, "type,leaked_objects,leaked_bytes\n");
+        else mld_report_str(&writer, dump_fields ? "type,address,units,bytes,root,fields\n" : "type,address,units,bytes,root\n");
+    }
+
+    long records = 0;
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *object_record = object_db->object_db_arr[i]; object_record; object_record = object_record->next){
+            if(object_record->is_visited || !object_record->structure_record) continue;
+            records += mld_report_leak(&writer, object_record, format, dump_fields, leak_totals);
+        }
+    }
+
+    ObjectDbRecord unit_rec;
+    unsigned int slab_index = 0, slot = 0;
+    while(mld_slab_next_leaked(object_db->slab_heap, &slab_index, &slot, &unit_rec))
+        records += mld_report_leak(&writer, &unit_rec, format, dump_fields, leak_totals);
+
+    if(aggregate){
+        for(unsigned int i = 0; i < totals.capacity; i++){
+            MldLeakTotal *total = &totals.slots[i];
+            if(!total->struct_rec) continue;
+            if(format == MLD_REPORT_JSONL){
+                mld_report_str(&writer, "{\"type\":\"");
+                mld_report_str(&writer, total->struct_rec->structure_name);
+                mld_report_str(&writer, "\",\"leaked_objects\":");
+                mld_report_ulong(&writer, total->objects);
+                mld_report_str(&writer, ",\"leaked_bytes\":");
+                mld_report_ulong(&writer, total->bytes);
+                mld_report_str(&writer, "}\n");
+            }else{
+                mld_report_str(&writer, total->struct_rec->structure_name);
+                mld_report_str(&writer, ",");
+                mld_report_ulong(&writer, total->objects);
+                mld_report_str(&writer, ",");
+                mld_report_ulong(&writer, total->bytes);
+                mld_report_str(&writer, "\n");
+            }
+            records++;
+        }
+        free(totals.slots);
+    }
+
+    mld_report_flush(&writer);
+    free(writer.buffer);
+    return writer.failed ? -1 : records;
+}
+
+/*teardown & exit hook*/
+
+void mld_destroy_object_db(ObjectDb *object_db){
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        ObjectDbRecord *obj_rec = object_db->object_db_arr[i];
+        while(obj_rec){
+            ObjectDbRecord *next = obj_rec->next;
+            free(obj_rec);
+            obj_rec = next;
+        }
+    }
+    free(object_db->object_db_arr);
+    object_db->object_db_arr = NULL;
+    object_db->table_size = 0;
+    object_db->count = 0;
+
+    if(object_db->generations){
+        free(object_db->generations->remembered);
+        free(object_db->generations);
+    }
+    if(object_db->debug_heap){
+        mld_drain_quarantine(object_db);
+        free(object_db->debug_heap);
+    }
+    if(object_db->large_arena){
+        free(object_db->large_arena->regions);
+        free(object_db->large_arena);
+    }
+    //slab pages hold the objects, only the slab bookkeeping is freed
+    MldSlabHeap *slab_heap = object_db->slab_heap;
+    if(slab_heap){
+        for(unsigned int s = 0; s < slab_heap->slab_count; s++) free(slab_heap->slabs[s]);
+        free(slab_heap->slabs);
+        free(slab_heap->table);
+        free(slab_heap);
+    }
+    object_db->generations = NULL;
+    object_db->debug_heap = NULL;
+    object_db->large_arena = NULL;
+    object_db->slab_heap = NULL;
+    memset(&object_db->sweep, 0, sizeof(object_db->sweep));
+    memset(object_db->recently_freed, 0, sizeof(object_db->recently_freed));
+    object_db->recently_freed_next = 0;
+}
+
+typedef struct MldExitReport {
+    ObjectDb *object_db;
+    int fd;
+    MldReportFormat format;
+    unsigned int flags;
+    struct MldExitReport *next;
+} MldExitReport;
+
+//reports still to write, newest first, each is unlinked before it is written so it runs once
+static MldExitReport *mld_exit_reports;
+static MldBoolean mld_exit_hook_registered;
+
+static void mld_exit_report(MldExitReport *exit_report){
+    ObjectDb *object_db = exit_report->object_db;
+    MldBoolean fast = exit_report->flags & MLD_EXIT_FAST ? MLD_TRUE : MLD_FALSE;
+
+    //a pending sweep would free garbage object by object, in fast mode it is reported as leaked instead
+    if(fast) object_db->sweep.pending = MLD_FALSE;
+    mld_run_full_scan(object_db);
+
+    //application output buffered in stdio goes out before the report
+    fflush(NULL);
+    mld_write_leak_report(object_db, exit_report->fd, exit_report->format,
+                          fast || (exit_report->flags & MLD_EXIT_AGGREGATE) ? MLD_TRUE : MLD_FALSE,
+                          !fast && (exit_report->flags & MLD_EXIT_DUMP_FIELDS) ? MLD_TRUE : MLD_FALSE);
+    if(!fast) mld_destroy_object_db(object_db);
+    free(exit_report);
+    //finalizers run by the teardown may have printed too
+    fflush(NULL);
+}
+
+//registered with atexit & run again as a destructor, so a report is also written when mld is in a library unloaded before exit
+__attribute__((destructor))
+static void mld_run_exit_reports(void){
+    while(mld_exit_reports){
+        MldExitReport *exit_report = mld_exit_reports;
+        mld_exit_reports = exit_report->next;
+        mld_exit_report(exit_report);
+    }
+}
+
+void mld_report_at_exit(ObjectDb *object_db, int fd, MldReportFormat format, unsigned int flags){
+    if(!mld_exit_hook_registered){
+        if(atexit(mld_run_exit_reports)){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        mld_exit_hook_registered = MLD_TRUE;
+    }
+    MldExitReport *exit_report = calloc(1, sizeof(MldExitReport));
+    if(!exit_report){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    exit_report->object_db = object_db;
+    exit_report->fd = fd;
+    exit_report->format = format;
+    exit_report->flags = flags;
+    exit_report->next = mld_exit_reports;
+    mld_exit_reports = exit_report;
+}
+
+/*heap snapshots*/
+
+static int mld_compare_pointers(const void *a, const void *b){
+    uintptr_t x = (uintptr_t)*(void * const *)a, y = (uintptr_t)*(void * const *)b;
+    return (x > y) - (x < y);
+}
+
+//sort key is copied next to the record, so sorting never dereferences object records
+typedef struct MldAddressedRecord {
+    uintptr_t address;
+    ObjectDbRecord *record;
+} MldAddressedRecord;
+
+static int mld_compare_addressed_records(const void *a, const void *b){
+    uintptr_t x = ((const MldAddressedRecord *)a)->address, y = ((const MldAddressedRecord *)b)->address;
+    return (x > y) - (x < y);
+}
+
+static uint32_t mld_snapshot_struct_index(StructureDbRecord **structs, uint32_t struct_count, StructureDbRecord *struct_rec){
+    StructureDbRecord **found = bsearch(&struct_rec, structs, struct_count, sizeof(StructureDbRecord *), mld_compare_pointers);
+    return found ? (uint32_t)(found - structs) : MLD_SNAPSHOT_NO_INDEX;
+}
+
+#define MLD_SNAPSHOT_ALIGN(size) (((size) + 7) & ~(uint64_t)7)
+
+//name fields of the snapshot tables always end in a NUL, a longer name is cut
+static void mld_snapshot_copy_name(char *dst, const char *src, size_t size){
+    size_t length = strnlen(src, size - 1);
+    memcpy(dst, src, length);
+    dst[length] = '\0';
+}
+
+/*
+distinct allocation sites of a snapshot in first seen order, deduplicated by an open addressing table over (file pointer, line),
+files are __FILE__ strings, so one site nearly always has one pointer
+*/
+typedef struct MldSiteTable {
+    uint32_t capacity; //slots, a power of two
+    uint32_t count;
+    uint32_t *slots; //site index, MLD_SNAPSHOT_NO_INDEX if empty
+    const char **files;
+    unsigned int *lines;
+} MldSiteTable;
+
+static void mld_site_table_free(MldSiteTable *table){
+    free(table->slots);
+    free(table->files);
+    free(table->lines);
+}
+
+static uint32_t mld_site_table_slot(const MldSiteTable *table, const char *file, unsigned int line){
+    uint64_t hash = ((uint64_t)(uintptr_t)file ^ ((uint64_t)line << 40)) * 0x9E3779B97F4A7C15ULL;
+    uint32_t slot = (uint32_t)(hash >> 32) & (table->capacity - 1);
+    while(table->slots[slot] != MLD_SNAPSHOT_NO_INDEX &&
+          (table->files[table->slots[slot]] != file || table->lines[table->slots[slot]] != line))
+        slot = (slot + 1) & (table->capacity - 1);
+    return slot;
+}
+
+//site index of (file, line), added if new, returns -1 if the table can not grow
+static int mld_site_table_add(MldSiteTable *table, const char *file, unsigned int line, uint32_t *index){
+    if(2 * (table->count + 1) > table->capacity){
+        MldSiteTable grown = {table->capacity ? 2 * table->capacity : 64, table->count, NULL, NULL, NULL};
+        grown.slots = malloc(grown.capacity * sizeof(uint32_t));
+        grown.files = realloc(table->files, grown.capacity / 2 * sizeof(const char *));
+        if(grown.files) table->files = grown.files;
+        grown.lines = realloc(table->lines, grown.capacity / 2 * sizeof(unsigned int));
+        if(grown.lines) table->lines = grown.lines;
+        if(!grown.slots || !grown.files || !grown.lines){
+            free(grown.slots);
+            return -1;
+        }
+        memset(grown.slots, 0xFF, grown.capacity * sizeof(uint32_t));
+        for(uint32_t i = 0; i < grown.count; i++) grown.slots[mld_site_table_slot(&grown, grown.files[i], grown.lines[i])] = i;
+        free(table->slots);
+        *table = grown;
+    }
+
+    uint32_t slot = mld_site_table_slot(table, file, line);
+    if(table->slots[slot] == MLD_SNAPSHOT_NO_INDEX){
+        table->files[table->count] = file;
+        table->lines[table->count] = line;
+        table->slots[slot] = table->count++;
+    }
+    *index = table->slots[slot];
+    return 0;
+}
+
+int mld_snapshot_write(ObjectDb *object_db, const char *path, MldBoolean with_contents){
+    StructureDb *struct_db = object_db->struct_db;
+
+    //structure records, sorted by record address so object records can find their index by binary search
+    uint32_t struct_count = 0, field_count = 0, pointer_offset_count = 0, pointer_array_count = 0;
+    StructureDbRecord **structs = malloc((struct_db->count + 1) * sizeof(StructureDbRecord *));
+    if(!structs) return -1;
+    for(int i = 0; i<TABLE_SIZE; i++){
+        for(StructureDbRecord *struct_rec = struct_db->structutre_db_arr[i]; struct_rec; struct_rec = struct_rec->next){
+            structs[struct_count++] = struct_rec;
+            field_count += struct_rec->field_count;
+            pointer_offset_count += struct_rec->pointer_offset_count;
+            pointer_array_count += struct_rec->pointer_array_count;
+        }
+    }
+    qsort(structs, struct_count, sizeof(StructureDbRecord *), mld_compare_pointers);
+
+    //object records, sorted by object address
+    uint64_t object_count = 0, contents_size = 0;
+    MldAddressedRecord *objects = malloc(((size_t)object_db->count + 1) * sizeof(MldAddressedRecord));
+    if(!objects){
+        free(structs);
+        return -1;
+    }
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            objects[object_count].address = (uintptr_t)obj_rec->pointer;
+            objects[object_count++].record = obj_rec;
+            if(with_contents) contents_size += MLD_SNAPSHOT_ALIGN((uint64_t)obj_rec->units * obj_rec->structure_record->structure_size);
+        }
+    }
+    qsort(objects, object_count, sizeof(MldAddressedRecord), mld_compare_addressed_records);
+
+    //allocation sites are indexed first, the site table precedes the object table
+    MldSiteTable sites = {0};
+    uint32_t *site_indexes = NULL;
+    for(uint64_t i = 0; i < object_count; i++){
+        ObjectDbRecord *obj_rec = objects[i].record;
+        if(!obj_rec->alloc_file) continue;
+        if(!site_indexes){
+            site_indexes = malloc(object_count * sizeof(uint32_t));
+            if(site_indexes) memset(site_indexes, 0xFF, object_count * sizeof(uint32_t));
+        }
+        if(!site_indexes || mld_site_table_add(&sites, obj_rec->alloc_file, obj_rec->alloc_line, &site_indexes[i])){
+            mld_site_table_free(&sites);
+            free(site_indexes);
+            free(structs);
+            free(objects);
+            return -1;
+        }
+    }
+
+    MldSnapshotHeader header = {0};
+    header.magic = MLD_SNAPSHOT_MAGIC;
+    header.struct_count = struct_count;
+    header.struct_offset = sizeof(MldSnapshotHeader);
+    header.field_count = field_count;
+    header.field_offset = header.struct_offset + struct_count * sizeof(MldSnapshotStruct);
+    header.site_count = sites.count;
+    header.site_offset = header.field_offset + field_count * sizeof(MldSnapshotField);
+    header.pointer_offset_count = pointer_offset_count;
+    header.pointer_offset_offset = header.site_offset + sites.count * sizeof(MldSnapshotSite);
+    header.pointer_array_count = pointer_array_count;
+    header.pointer_array_offset = MLD_SNAPSHOT_ALIGN(header.pointer_offset_offset + pointer_offset_count * sizeof(uint32_t));
+    header.object_count = object_count;
+    header.object_offset = header.pointer_array_offset + pointer_array_count * sizeof(MldSnapshotPointerArray);
+    header.contents_size = contents_size;
+    header.contents_offset = header.object_offset + object_count * sizeof(MldSnapshotObject);
+    header.file_size = header.contents_offset + contents_size;
+
+    FILE *file = fopen(path, "wb");
+    if(!file){
+        mld_site_table_free(&sites);
+        free(site_indexes);
+        free(structs);
+        free(objects);
+        return -1;
+    }
+    setvbuf(file, NULL, _IOFBF, MLD_REPORT_BUFFER_SIZE);
+    fwrite(&header, sizeof(header), 1, file);
+
+    uint32_t first_field = 0, first_pointer_offset = 0, first_pointer_array = 0;
+    for(uint32_t i = 0; i < struct_count; i++){
+        MldSnapshotStruct entry = {0};
+        mld_snapshot_copy_name(entry.structure_name, structs[i]->structure_name, sizeof(entry.structure_name));
+        entry.structure_size = structs[i]->structure_size;
+        entry.field_count = structs[i]->field_count;
+        entry.first_field = first_field;
+        entry.pointer_offset_count = structs[i]->pointer_offset_count;
+        entry.first_pointer_offset = first_pointer_offset;
+        entry.pointer_array_count = structs[i]->pointer_array_count;
+        entry.first_pointer_array = first_pointer_array;
+        first_field += structs[i]->field_count;
+        first_pointer_offset += structs[i]->pointer_offset_count;
+        first_pointer_array += structs[i]->pointer_array_count;
+        fwrite(&entry, sizeof(entry), 1, file);
+    }
+
+    for(uint32_t i = 0; i < struct_count; i++){
+        for(uint32_t j = 0; j < structs[i]->field_count; j++){
+            FieldInfo *field = &structs[i]->fields[j];
+            MldSnapshotField entry = {0};
+            mld_snapshot_copy_name(entry.field_name, field->field_name, sizeof(entry.field_name));
+            mld_snapshot_copy_name(entry.nested_structure_name, field->nested_structure_name, sizeof(entry.nested_structure_name));
+            entry.data_type = field->data_type;
+            entry.size = field->size;
+            entry.offset = field->offset;
+            fwrite(&entry, sizeof(entry), 1, file);
+        }
+    }
+
+    for(uint32_t i = 0; i < sites.count; i++){
+        MldSnapshotSite entry = {0};
+        mld_snapshot_copy_name(entry.file, sites.files[i], sizeof(entry.file));
+        entry.line = sites.lines[i];
+        fwrite(&entry, sizeof(entry), 1, file);
+    }
+
+    static const char padding[8];
+    for(uint32_t i = 0; i < struct_count; i++){
+        for(uint32_t k = 0; k < structs[i]->pointer_offset_count; k++){
+            uint32_t offset = structs[i]->pointer_offsets[k];
+            fwrite(&offset, sizeof(offset), 1, file);
+        }
+    }
+    fwrite(padding, 1, header.pointer_array_offset - (header.pointer_offset_offset + pointer_offset_count * sizeof(uint32_t)), file);
+
+    for(uint32_t i = 0; i < struct_count; i++){
+        for(uint32_t a = 0; a < structs[i]->pointer_array_count; a++){
+            MldPointerArrayField *array = &structs[i]->pointer_arrays[a];
+            MldSnapshotPointerArray entry = {0};
+            entry.offset = array->offset;
+            entry.length_offset = array->length_offset;
+            entry.length_size = array->length_size;
+            fwrite(&entry, sizeof(entry), 1, file);
+        }
+    }
+
+    //consecutive objects are mostly of the same type, remember the last index instead of searching again
+    StructureDbRecord *last_struct = NULL;
+    uint32_t last_index = MLD_SNAPSHOT_NO_INDEX;
+    uint64_t contents = header.contents_offset;
+    for(uint64_t i = 0; i < object_count; i++){
+        ObjectDbRecord *obj_rec = objects[i].record;
+        if(obj_rec->structure_record != last_struct){
+            last_struct = obj_rec->structure_record;
+            last_index = mld_snapshot_struct_index(structs, struct_count, last_struct);
+        }
+
+        MldSnapshotObject entry = {0};
+        entry.address = objects[i].address;
+        entry.units = obj_rec->units;
+        entry.struct_index = last_index;
+        entry.is_root = obj_rec->is_root;
+        entry.site_index = site_indexes ? site_indexes[i] : MLD_SNAPSHOT_NO_INDEX;
+        entry.contents = MLD_SNAPSHOT_NO_CONTENTS;
+        if(with_contents){
+            entry.contents = contents;
+            contents += MLD_SNAPSHOT_ALIGN((uint64_t)obj_rec->units * obj_rec->structure_record->structure_size);
+        }
+        fwrite(&entry, sizeof(entry), 1, file);
+    }
+
+    if(with_contents){
+        for(uint64_t i = 0; i < object_count; i++){
+            ObjectDbRecord *obj_rec = objects[i].record;
+            uint64_t bytes = (uint64_t)obj_rec->units * obj_rec->structure_record->structure_size;
+            fwrite(obj_rec->pointer, 1, bytes, file);
+            fwrite(padding, 1, MLD_SNAPSHOT_ALIGN(bytes) - bytes, file);
+        }
+    }
+
+    int failed = ferror(file);
+    if(fclose(file)) failed = 1;
+    mld_site_table_free(&sites);
+    free(site_indexes);
+    free(structs);
+    free(objects);
+    return failed ? -1 : 0;
+}
+
+//table of count entries at offset lies inside a file of size bytes
+static int mld_snapshot_table_fits(uint64_t offset, uint64_t count, size_t entry_size, uint64_t size){
+    return offset <= size && offset % 8 == 0 && count <= (size - offset) / entry_size;
+}
+
+/*
+a snapshot is trusted only after every offset, count & index in it is checked against the mapping,
+so a truncated or corrupt file is refused instead of read out of bounds by the mark loop
+*/
+static int mld_snapshot_validate(const MldSnapshotHeader *header, uint64_t size){
+    if(!mld_snapshot_table_fits(header->struct_offset, header->struct_count, sizeof(MldSnapshotStruct), size) ||
+       !mld_snapshot_table_fits(header->field_offset, header->field_count, sizeof(MldSnapshotField), size) ||
+       !mld_snapshot_table_fits(header->site_offset, header->site_count, sizeof(MldSnapshotSite), size) ||
+       !mld_snapshot_table_fits(header->pointer_offset_offset, header->pointer_offset_count, sizeof(uint32_t), size) ||
+       !mld_snapshot_table_fits(header->pointer_array_offset, header->pointer_array_count, sizeof(MldSnapshotPointerArray), size) ||
+       !mld_snapshot_table_fits(header->object_offset, header->object_count, sizeof(MldSnapshotObject), size) ||
+       header->struct_count >= MLD_SNAPSHOT_NO_INDEX || header->site_count >= MLD_SNAPSHOT_NO_INDEX)
+        return -1;
+
+    const char *base = (const char *)header;
+    const MldSnapshotStruct *structs = (const MldSnapshotStruct *)(base + header->struct_offset);
+    const MldSnapshotField *fields = (const MldSnapshotField *)(base + header->field_offset);
+    const MldSnapshotSite *sites = (const MldSnapshotSite *)(base + header->site_offset);
+    const uint32_t *pointer_offsets = (const uint32_t *)(base + header->pointer_offset_offset);
+    const MldSnapshotPointerArray *pointer_arrays = (const MldSnapshotPointerArray *)(base + header->pointer_array_offset);
+    const MldSnapshotObject *objects = (const MldSnapshotObject *)(base + header->object_offset);
+
+    for(uint64_t i = 0; i < header->struct_count; i++){
+        const MldSnapshotStruct *entry = &structs[i];
+        if(!memchr(entry->structure_name, '\0', sizeof(entry->structure_name)) ||
+           entry->first_field > header->field_count || entry->field_count > header->field_count - entry->first_field)
+            return -1;
+        for(uint32_t f = entry->first_field; f < entry->first_field + entry->field_count; f++){
+            if(!memchr(fields[f].field_name, '\0', sizeof(fields[f].field_name)) ||
+               !memchr(fields[f].nested_structure_name, '\0', sizeof(fields[f].nested_structure_name)) ||
+               fields[f].offset > entry->structure_size || fields[f].size > entry->structure_size - fields[f].offset)
+                return -1;
+        }
+        //the mark loop reads a whole pointer at every flattened offset
+        if(entry->first_pointer_offset > header->pointer_offset_count ||
+           entry->pointer_offset_count > header->pointer_offset_count - entry->first_pointer_offset)
+            return -1;
+        for(uint32_t k = entry->first_pointer_offset; k < entry->first_pointer_offset + entry->pointer_offset_count; k++){
+            if(entry->structure_size < sizeof(uint64_t) || pointer_offsets[k] > entry->structure_size - sizeof(uint64_t)) return -1;
+        }
+        //& a buffer pointer & a length of 1, 2, 4 or 8 bytes for every dynamic array
+        if(entry->first_pointer_array > header->pointer_array_count ||
+           entry->pointer_array_count > header->pointer_array_count - entry->first_pointer_array)
+            return -1;
+        for(uint32_t a = entry->first_pointer_array; a < entry->first_pointer_array + entry->pointer_array_count; a++){
+            const MldSnapshotPointerArray *array = &pointer_arrays[a];
+            uint32_t length_size = array->length_size;
+            if(entry->structure_size < sizeof(uint64_t) || array->offset > entry->structure_size - sizeof(uint64_t) ||
+               (length_size != 1 && length_size != 2 && length_size != 4 && length_size != 8) ||
+               array->length_offset > entry->structure_size - length_size)
+                return -1;
+        }
+    }
+
+    for(uint64_t i = 0; i < header->site_count; i++){
+        if(!memchr(sites[i].file, '\0', sizeof(sites[i].file))) return -1;
+    }
+
+    for(uint64_t i = 0; i < header->object_count; i++){
+        const MldSnapshotObject *object = &objects[i];
+        if(object->site_index != MLD_SNAPSHOT_NO_INDEX && object->site_index >= header->site_count) return -1;
+        if(object->struct_index == MLD_SNAPSHOT_NO_INDEX) continue;
+        if(object->struct_index >= header->struct_count) return -1;
+        if(object->contents == MLD_SNAPSHOT_NO_CONTENTS) continue;
+        uint64_t bytes = (uint64_t)object->units * structs[object->struct_index].structure_size;
+        if(object->contents > size || bytes > size - object->contents) return -1;
+    }
+    return 0;
+}
+
+int mld_snapshot_open(const char *path, MldSnapshot *snapshot){
+    memset(snapshot, 0, sizeof(MldSnapshot));
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return -1;
+
+    struct stat st;
+    if(fstat(fd, &st) || st.st_size < (off_t)sizeof(MldSnapshotHeader)){
+        close(fd);
+        return -1;
+    }
+
+    //private writable mapping, only pages whose mark bits are written get copied
+    void *base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(base == MAP_FAILED) return -1;
+
+    MldSnapshotHeader *header = base;
+    if(header->magic != MLD_SNAPSHOT_MAGIC || header->file_size != (uint64_t)st.st_size || mld_snapshot_validate(header, st.st_size)){
+        munmap(base, st.st_size);
+        return -1;
+    }
+
+    snapshot->base = base;
+    snapshot->size = st.st_size;
+    snapshot->header = header;
+    snapshot->structs = (MldSnapshotStruct *)((char *)base + header->struct_offset);
+    snapshot->fields = (MldSnapshotField *)((char *)base + header->field_offset);
+    snapshot->sites = (MldSnapshotSite *)((char *)base + header->site_offset);
+    snapshot->pointer_offsets = (uint32_t *)((char *)base + header->pointer_offset_offset);
+    snapshot->pointer_arrays = (MldSnapshotPointerArray *)((char *)base + header->pointer_array_offset);
+    snapshot->objects = (MldSnapshotObject *)((char *)base + header->object_offset);
+    return 0;
+}
+
+void mld_snapshot_close(MldSnapshot *snapshot){
+    if(snapshot->base) munmap(snapshot->base, snapshot->size);
+    memset(snapshot, 0, sizeof(MldSnapshot));
+}
+
+//object table is sorted by address, exact match only, as in object_db_lookup
+MldSnapshotObject *mld_snapshot_lookup(MldSnapshot *snapshot, uint64_t address){
+    uint64_t low = 0, high = snapshot->header->object_count;
+    while(low < high){
+        uint64_t mid = low + (high - low) / 2;
+        uint64_t mid_address = snapshot->objects[mid].address;
+        if(mid_address == address) return &snapshot->objects[mid];
+        if(mid_address < address) low = mid + 1;
+        else high = mid;
+    }
+    return NULL;
+}
+
+typedef struct MldSnapshotStack {
+    MldSnapshotObject **objects;
+    size_t count;
+    size_t capacity;
+} MldSnapshotStack;
+
+static void mld_snapshot_mark_address(MldSnapshot *snapshot, uint64_t address, MldSnapshotStack *stack){
+    if(!address) return;
+    MldSnapshotObject *child = mld_snapshot_lookup(snapshot, address);
+    if(!child || child->is_visited) return;
+
+    child->is_visited = 1;
+    if(stack->count == stack->capacity){
+        stack->capacity = stack->capacity ? stack->capacity * 2 : 1024;
+        stack->objects = realloc(stack->objects, stack->capacity * sizeof(MldSnapshotObject *));
+        if(!stack->objects){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    stack->objects[stack->count++] = child;
+}
+
+/*
+same algorithm as run_mld_algorithm, over the mapped snapshot
+every unit is scanned at the flattened pointer offsets & dynamic pointer arrays saved with its structure, as the live marker does,
+array elements are read only from a buffer saved with contents & capped at its size
+dfs uses an explicit stack, snapshots of large heaps have chains far deeper than the c stack allows
+objects saved without contents are marked but not explored
+*/
+unsigned long mld_snapshot_run_mld_algorithm(MldSnapshot *snapshot){
+    uint64_t object_count = snapshot->header->object_count;
+    MldSnapshotObject *objects = snapshot->objects;
+
+    for(uint64_t i = 0; i < object_count; i++) objects[i].is_visited = 0;
+
+    MldSnapshotStack stack = {0};
+    for(uint64_t i = 0; i < object_count; i++){
+        if(!objects[i].is_root || objects[i].is_visited) continue;
+        objects[i].is_visited = 1;
+
+        for(MldSnapshotObject *parent = &objects[i]; parent; parent = stack.count ? stack.objects[--stack.count] : NULL){
+            if(parent->contents == MLD_SNAPSHOT_NO_CONTENTS || parent->struct_index == MLD_SNAPSHOT_NO_INDEX) continue;
+
+            MldSnapshotStruct *struct_entry = &snapshot->structs[parent->struct_index];
+            const uint32_t *offsets = &snapshot->pointer_offsets[struct_entry->first_pointer_offset];
+            const MldSnapshotPointerArray *arrays = &snapshot->pointer_arrays[struct_entry->first_pointer_array];
+            char *unit_ptr = (char *)snapshot->base + parent->contents;
+
+            for(uint32_t unit = 0; unit < parent->units; unit++, unit_ptr += struct_entry->structure_size){
+                for(uint32_t k = 0; k < struct_entry->pointer_offset_count; k++){
+                    uint64_t child_address;
+                    memcpy(&child_address, unit_ptr + offsets[k], sizeof(child_address));
+                    mld_snapshot_mark_address(snapshot, child_address, &stack);
+                }
+                for(uint32_t a = 0; a < struct_entry->pointer_array_count; a++){
+                    uint64_t buffer_address;
+                    memcpy(&buffer_address, unit_ptr + arrays[a].offset, sizeof(buffer_address));
+                    uint64_t length = mld_read_length(unit_ptr + arrays[a].length_offset, arrays[a].length_size);
+                    if(!buffer_address || !length) continue;
+                    mld_snapshot_mark_address(snapshot, buffer_address, &stack);
+
+                    MldSnapshotObject *buffer = mld_snapshot_lookup(snapshot, buffer_address);
+                    if(!buffer || buffer->contents == MLD_SNAPSHOT_NO_CONTENTS || buffer->struct_index == MLD_SNAPSHOT_NO_INDEX) continue;
+                    uint64_t capacity = (uint64_t)buffer->units * snapshot->structs[buffer->struct_index].structure_size / sizeof(uint64_t);
+                    if(length > capacity) length = capacity;
+                    const char *elements = (const char *)snapshot->base + buffer->contents;
+                    for(uint64_t e = 0; e < length; e++){
+                        uint64_t child_address;
+                        memcpy(&child_address, elements + e * sizeof(uint64_t), sizeof(child_address));
+                        mld_snapshot_mark_address(snapshot, child_address, &stack);
+                    }
+                }
+            }
+        }
+    }
+    free(stack.objects);
+
+    unsigned long leaked = 0;
+    for(uint64_t i = 0; i < object_count; i++) leaked += !objects[i].is_visited;
+    return leaked;
+}
+
+/*heap diff*/
+
+static int mld_compare_epoch_entries(const void *a, const void *b){
+    uint64_t x = ((const MldEpochEntry *)a)->address, y = ((const MldEpochEntry *)b)->address;
+    return (x > y) - (x < y);
+}
+
+int mld_epoch_capture(ObjectDb *object_db, MldHeapEpoch *epoch){
+    epoch->count = 0;
+    epoch->entries = malloc(((size_t)object_db->count + 1) * sizeof(MldEpochEntry));
+    if(!epoch->entries) return -1;
+
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            MldEpochEntry *entry = &epoch->entries[epoch->count++];
+            entry->address = (uintptr_t)obj_rec->pointer;
+            entry->bytes = (uint64_t)obj_rec->units * obj_rec->structure_record->structure_size;
+            entry->structure_name = obj_rec->structure_record->structure_name;
+            entry->alloc_file = obj_rec->alloc_file;
+            entry->alloc_line = obj_rec->alloc_line;
+        }
+    }
+
+    //object db is hashed, so this is the only sort, snapshots are already in address order
+    qsort(epoch->entries, epoch->count, sizeof(MldEpochEntry), mld_compare_epoch_entries);
+    return 0;
+}
+
+int mld_epoch_from_snapshot(MldSnapshot *snapshot, MldHeapEpoch *epoch){
+    epoch->count = snapshot->header->object_count;
+    epoch->entries = malloc((epoch->count + 1) * sizeof(MldEpochEntry));
+    if(!epoch->entries) return -1;
+
+    for(uint64_t i = 0; i < epoch->count; i++){
+        MldSnapshotObject *object = &snapshot->objects[i];
+        MldSnapshotStruct *struct_entry = object->struct_index == MLD_SNAPSHOT_NO_INDEX ? NULL : &snapshot->structs[object->struct_index];
+        MldEpochEntry *entry = &epoch->entries[i];
+        entry->address = object->address;
+        entry->bytes = struct_entry ? (uint64_t)object->units * struct_entry->structure_size : 0;
+        entry->structure_name = struct_entry ? struct_entry->structure_name : "";
+        MldSnapshotSite *site = object->site_index == MLD_SNAPSHOT_NO_INDEX ? NULL : &snapshot->sites[object->site_index];
+        entry->alloc_file = site ? site->file : NULL;
+        entry->alloc_line = site ? site->line : 0;
+    }
+    return 0;
+}
+
+void mld_epoch_free(MldHeapEpoch *epoch){
+    free(epoch->entries);
+    epoch->entries = NULL;
+    epoch->count = 0;
+}
+
+/*
+diff rows are kept in an open addressing table keyed by (structure name, file, line)
+keys are compared by content, two snapshots never share name pointers
+*/
+typedef struct MldDiffTable {
+    unsigned long capacity;
+    unsigned long count;
+    MldDiffRow *rows;
+    unsigned char *used;
+} MldDiffTable;
+
+static uint64_t mld_diff_key_hash(const char *structure_name, const char *alloc_file, unsigned int alloc_line){
+    uint64_t hash = 1469598103934665603ULL;
+    for(const char *c = structure_name; *c; c++) hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+    if(alloc_file){
+        for(const char *c = alloc_file; *c; c++) hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+        hash = (hash ^ alloc_line) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static MldDiffRow *mld_diff_row(MldDiffTable *table, const char *structure_name, const char *alloc_file, unsigned int alloc_line){
+    if(2 * (table->count + 1) > table->capacity){
+        MldDiffTable grown = {table->capacity ? 2 * table->capacity : 64, 0, NULL, NULL};
+        grown.rows = calloc(grown.capacity, sizeof(MldDiffRow));
+        grown.used = calloc(grown.capacity, 1);
+        if(!grown.rows || !grown.used){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+        for(unsigned long i = 0; i < table->capacity; i++){
+            if(!table->used[i]) continue;
+            MldDiffRow *row = mld_diff_row(&grown, table->rows[i].structure_name, table->rows[i].alloc_file, table->rows[i].alloc_line);
+            *row = table->rows[i];
+        }
+        free(table->rows);
+        free(table->used);
+        *table = grown;
+    }
+
+    unsigned long slot = mld_diff_key_hash(structure_name, alloc_file, alloc_line) & (table->capacity - 1);
+    for(;; slot = (slot + 1) & (table->capacity - 1)){
+        MldDiffRow *row = &table->rows[slot];
+        if(!table->used[slot]){
+            table->used[slot] = 1;
+            table->count++;
+            row->structure_name = structure_name;
+            row->alloc_file = alloc_file;
+            row->alloc_line = alloc_line;
+            return row;
+        }
+        if(row->alloc_line == alloc_line &&
+           strcmp(row->structure_name, structure_name) == 0 &&
+           (row->alloc_file == alloc_file || (row->alloc_file && alloc_file && strcmp(row->alloc_file, alloc_file) == 0)))
+            return row;
+    }
+}
+
+static void mld_diff_account(MldDiffTable *table, MldEpochEntry *entry, long sign){
+    MldDiffRow *row = mld_diff_row(table, entry->structure_name, NULL, 0);
+    row->count_delta += sign;
+    row->bytes_delta += sign * (long)entry->bytes;
+
+    if(entry->alloc_file){
+        row = mld_diff_row(table, entry->structure_name, entry->alloc_file, entry->alloc_line);
+        row->count_delta += sign;
+        row->bytes_delta += sign * (long)entry->bytes;
+    }
+}
+
+static int mld_compare_diff_rows(const void *a, const void *b){
+    long x = ((const MldDiffRow *)a)->bytes_delta, y = ((const MldDiffRow *)b)->bytes_delta;
+    return (x < y) - (x > y);
+}
+
+void mld_heap_diff(MldHeapEpoch *before, MldHeapEpoch *after, MldHeapDiff *diff){
+    MldDiffTable table = {0, 0, NULL, NULL};
+    uint64_t i = 0, j = 0;
+
+    //sorted merge, both epochs are in address order
+    while(i < before->count || j < after->count){
+        MldEpochEntry *old_entry = i < before->count ? &before->entries[i] : NULL;
+        MldEpochEntry *new_entry = j < after->count ? &after->entries[j] : NULL;
+
+        if(old_entry && new_entry && old_entry->address == new_entry->address){
+            //same object unless the address was reused for another type or size
+            if(old_entry->bytes != new_entry->bytes || strcmp(old_entry->structure_name, new_entry->structure_name) != 0){
+                mld_diff_account(&table, old_entry, -1);
+                mld_diff_account(&table, new_entry, 1);
+            }
+            i++;
+            j++;
+        }else if(!new_entry || (old_entry && old_entry->address < new_entry->address)){
+            mld_diff_account(&table, old_entry, -1);
+            i++;
+        }else{
+            mld_diff_account(&table, new_entry, 1);
+            j++;
+        }
+    }
+
+    //compact the table into the result, unchanged groups are dropped
+    diff->row_count = 0;
+    diff->rows = malloc((table.count + 1) * sizeof(MldDiffRow));
+    if(!diff->rows){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(unsigned long k = 0; k < table.capacity; k++){
+        if(table.used[k] && (table.rows[k].count_delta || table.rows[k].bytes_delta))
+            diff->rows[diff->row_count++] = table.rows[k];
+    }
+    qsort(diff->rows, diff->row_count, sizeof(MldDiffRow), mld_compare_diff_rows);
+
+    free(table.rows);
+    free(table.used);
+}
+
+//printed width of an allocation site, file:line, or "(all)" for rows without a site
+static int mld_diff_site_width(const MldDiffRow *row){
+    if(!row->alloc_file) return (int)strlen("(all)");
+    return snprintf(NULL, 0, "%s:%u", row->alloc_file, row->alloc_line);
+}
+
+void print_heap_diff(MldHeapDiff *diff){
+    //the site column is as wide as the longest site, file names are never cut
+    int site_width = 30;
+    for(unsigned long i = 0; i < diff->row_count; i++){
+        int width = mld_diff_site_width(&diff->rows[i]);
+        if(width > site_width) site_width = width;
+    }
+
+    printf("| %-30s | %-*s | %-12s | %-14s |\n", "Structure", site_width, "Allocation Site", "Count Delta", "Bytes Delta");
+    printf("|--------------------------------|");
+    for(int i = 0; i < site_width + 2; i++) putchar('-');
+    printf("|--------------|----------------|\n");
+    for(unsigned long i = 0; i < diff->row_count; i++){
+        MldDiffRow *row = &diff->rows[i];
+        printf("| %-30s | ", row->structure_name);
+        if(row->alloc_file) printf("%s:%u", row->alloc_file, row->alloc_line);
+        else printf("(all)");
+        printf("%*s | %+12ld | %+14ld |\n", site_width - mld_diff_site_width(row), "", row->count_delta, row->bytes_delta);
+    }
+}
+
+void mld_heap_diff_free(MldHeapDiff *diff){
+    free(diff->rows);
+    diff->rows = NULL;
+    diff->row_count = 0;
+}
+
+/*retained size, dominator tree*/
+
+/*
+nodes are sorted with an lsd radix sort on address - low, 11 bits per pass, the passes needed follow the span of the heap
+a comparison sort of 10M records costs several times more than the 3 passes a typical heap span needs
+*/
+#define MLD_RADIX_BITS 11
+
+static void mld_radix_sort_addressed_records(MldAddressedRecord *records, uint32_t count){
+    if(count < 2) return;
+    uintptr_t low = UINTPTR_MAX, high = 0;
+    for(uint32_t i = 0; i < count; i++){
+        if(records[i].address < low) low = records[i].address;
+        if(records[i].address > high) high = records[i].address;
+    }
+    MldAddressedRecord *scratch = malloc((size_t)count * sizeof(MldAddressedRecord));
+    uint32_t *histogram = malloc(sizeof(uint32_t) << MLD_RADIX_BITS);
+    if(!scratch || !histogram){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    MldAddressedRecord *from = records, *to = scratch;
+    for(unsigned int shift = 0; shift < sizeof(uintptr_t) * 8 && ((high - low) >> shift); shift += MLD_RADIX_BITS){
+        uintptr_t mask = ((uintptr_t)1 << MLD_RADIX_BITS) - 1;
+        memset(histogram, 0, sizeof(uint32_t) << MLD_RADIX_BITS);
+        for(uint32_t i = 0; i < count; i++) histogram[((from[i].address - low) >> shift) & mask]++;
+        for(uint32_t d = 0, sum = 0; d <= mask; d++){
+            uint32_t c = histogram[d];
+            histogram[d] = sum;
+            sum += c;
+        }
+        for(uint32_t i = 0; i < count; i++) to[histogram[((from[i].address - low) >> shift) & mask]++] = from[i];
+        MldAddressedRecord *t = from;
+        from = to;
+        to = t;
+    }
+    if(from != records) memcpy(records, from, (size_t)count * sizeof(MldAddressedRecord));
+    free(scratch);
+    free(histogram);
+}
+
+/*
+address -> node index over nodes sorted by address
+the span low..high is cut into slots of 1 << shift bytes, at most about 2 slots per node, & slots[s] is the first node at or after slot s,
+a lookup is one directory read & a binary search of the few nodes in that slot, all within the sorted node array
+*/
+typedef struct MldNodeIndex {
+    uintptr_t low, high;
+    unsigned int shift;
+    uint32_t *slots;
+    const MldAddressedRecord *nodes;
+} MldNodeIndex;
+
+static void mld_node_index_init(MldNodeIndex *index, const MldAddressedRecord *nodes, uint32_t node_count){
+    index->nodes = nodes;
+    index->low = node_count ? nodes[0].address : 1;
+    index->high = node_count ? nodes[node_count - 1].address : 0;
+    index->shift = 0;
+    uintptr_t span = node_count ? index->high - index->low : 0;
+    while((span >> index->shift) > 2 * (uintptr_t)node_count) index->shift++;
+
+    size_t slot_count = (size_t)(span >> index->shift) + 2;
+    index->slots = malloc(slot_count * sizeof(uint32_t));
+    if(!index->slots){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    uint32_t v = 0;
+    for(size_t s = 0; s < slot_count; s++){
+        while(v < node_count && ((nodes[v].address - index->low) >> index->shift) < s) v++;
+        index->slots[s] = v;
+    }
+}
+
+static uint32_t mld_node_index_lookup(const MldNodeIndex *index, uintptr_t address){
+    if(address < index->low || address > index->high) return UINT32_MAX;
+    uintptr_t s = (address - index->low) >> index->shift;
+    uint32_t first = index->slots[s], last = index->slots[s + 1];
+    while(first < last){
+        uint32_t mid = first + (last - first) / 2;
+        if(index->nodes[mid].address < address) first = mid + 1;
+        else last = mid;
+    }
+    return first < index->slots[s + 1] && index->nodes[first].address == address ? first : UINT32_MAX;
+}
+
+static void mld_node_index_free(MldNodeIndex *index){
+    free(index->slots);
+}
+
+/*
+object graph in csr form, nodes 0..n-1 are object records in address order, node n is a virtual root pointing to every root object
+address order keeps the dfs & edge scans close to allocation order, which is mostly memory order
+with only_unvisited set, only objects left unvisited by run_mld_algorithm are nodes, & the virtual root has no edges
+*/
+typedef struct MldObjectGraph {
+    uint32_t node_count;
+    MldAddressedRecord *nodes;
+    uint64_t *edge_start; //edges of node v are edges[edge_start[v] .. edge_start[v + 1])
+    uint32_t *edges;
+} MldObjectGraph;
+
+static void mld_graph_push_edge(uint32_t **edges, uint64_t *edge_count, uint64_t *edge_capacity, uint32_t w){
+    if(*edge_count == *edge_capacity){
+        *edges = realloc(*edges, (*edge_capacity *= 2) * sizeof(uint32_t));
+        if(!*edges){
+            printf("Memory allocation failed.\n");
+            exit(1);
+        }
+    }
+    (*edges)[(*edge_count)++] = w;
+}
+
+static void mld_build_object_graph(ObjectDb *object_db, MldBoolean only_unvisited, MldObjectGraph *graph){
+    uint32_t n = 0;
+    MldAddressedRecord *nodes = malloc(((size_t)object_db->count + 1) * sizeof(MldAddressedRecord));
+    if(!nodes){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            if(only_unvisited && obj_rec->is_visited) continue;
+            nodes[n].address = (uintptr_t)obj_rec->pointer;
+            nodes[n++].record = obj_rec;
+        }
+    }
+    mld_radix_sort_addressed_records(nodes, n);
+
+    MldNodeIndex index;
+    mld_node_index_init(&index, nodes, n);
+    uint32_t root = n;
+
+    //edges are built in one pass as nodes are visited in order
+    uint64_t edge_count = 0, edge_capacity = (uint64_t)n + 16;
+    uint64_t *edge_start = malloc(((size_t)n + 2) * sizeof(uint64_t));
+    uint32_t *edges = malloc(edge_capacity * sizeof(uint32_t));
+    if(!edge_start || !edges){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    MldWordBuffer children = {0};
+    MldCandidateFilter filter;
+    mld_candidate_filter_build(object_db, &filter);
+
+    for(uint32_t v = 0; v <= n; v++){
+        edge_start[v] = edge_count;
+        for(uint32_t u = 0; v == root && !only_unvisited && u < n; u++){
+            if(nodes[u].record->is_root) mld_graph_push_edge(&edges, &edge_count, &edge_capacity, u);
+        }
+        if(v == root) break;
+
+        children.count = 0;
+        mld_gather_children(object_db, &filter, nodes[v].record, &children);
+        for(size_t c = 0; c < children.count; c++){
+            uint32_t w = mld_node_index_lookup(&index, children.words[c]);
+            if(w != UINT32_MAX) mld_graph_push_edge(&edges, &edge_count, &edge_capacity, w);
+        }
+    }
+    free(children.words);
+    mld_candidate_filter_free(&filter);
+    edge_start[n + 1] = edge_count;
+    mld_node_index_free(&index);
+
+    graph->node_count = n;
+    graph->nodes = nodes;
+    graph->edge_start = edge_start;
+    graph->edges = edges;
+}
+
+static void mld_free_object_graph(MldObjectGraph *graph){
+    free(graph->nodes);
+    free(graph->edge_start);
+    free(graph->edges);
+}
+
+int mld_compute_top_retainers(ObjectDb *object_db, MldRetainer *top, int k){
+    MldObjectGraph graph;
+    mld_build_object_graph(object_db, MLD_FALSE, &graph);
+
+    uint32_t n = graph.node_count, root = n;
+    MldAddressedRecord *nodes = graph.nodes;
+    uint64_t *edge_start = graph.edge_start;
+    uint32_t *edges = graph.edges;
+
+    //iterative dfs from the virtual root, rpo[] numbers reachable nodes in reverse postorder
+    uint32_t *rpo = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t *order = malloc(((size_t)n + 1) * sizeof(uint32_t)); //rpo number -> node
+    uint32_t *stack = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint64_t *cursor = malloc(((size_t)n + 1) * sizeof(uint64_t));
+    if(!rpo || !order || !stack || !cursor){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t v = 0; v <= n; v++) rpo[v] = UINT32_MAX;
+
+    uint32_t reachable = 0, depth = 0;
+    stack[depth++] = root;
+    rpo[root] = 0; //any value other than UINT32_MAX marks the node as seen
+    cursor[root] = edge_start[root];
+    while(depth){
+        uint32_t v = stack[depth - 1];
+        if(cursor[v] < edge_start[v + 1]){
+            uint32_t w = edges[cursor[v]++];
+            if(rpo[w] == UINT32_MAX){
+                rpo[w] = 0;
+                cursor[w] = edge_start[w];
+                stack[depth++] = w;
+            }
+            continue;
+        }
+        order[reachable++] = v; //postorder
+        depth--;
+    }
+    for(uint32_t i = 0; i < reachable / 2; i++){
+        uint32_t t = order[i];
+        order[i] = order[reachable - 1 - i];
+        order[reachable - 1 - i] = t;
+    }
+    for(uint32_t i = 0; i < reachable; i++) rpo[order[i]] = i;
+    free(stack);
+    free(cursor);
+
+    //predecessors in rpo numbering, only edges between reachable nodes exist
+    uint64_t *pred_start = calloc((size_t)reachable + 1, sizeof(uint64_t));
+    if(!pred_start){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t i = 0; i < reachable; i++){
+        uint32_t v = order[i];
+        for(uint64_t e = edge_start[v]; e < edge_start[v + 1]; e++) pred_start[rpo[edges[e]] + 1]++;
+    }
+    for(uint32_t i = 0; i < reachable; i++) pred_start[i + 1] += pred_start[i];
+    uint32_t *preds = malloc((pred_start[reachable] + 1) * sizeof(uint32_t));
+    uint64_t *pred_fill = malloc(((size_t)reachable + 1) * sizeof(uint64_t));
+    if(!preds || !pred_fill){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    memcpy(pred_fill, pred_start, (size_t)reachable * sizeof(uint64_t));
+    for(uint32_t i = 0; i < reachable; i++){
+        uint32_t v = order[i];
+        for(uint64_t e = edge_start[v]; e < edge_start[v + 1]; e++) preds[pred_fill[rpo[edges[e]]]++] = i;
+    }
+    free(pred_fill);
+    free(graph.edges);
+    free(graph.edge_start);
+
+    //Cooper-Harvey-Kennedy, everything in rpo numbers, so intersect is a walk towards smaller numbers
+    uint32_t *idom = malloc(((size_t)reachable + 1) * sizeof(uint32_t));
+    if(!idom){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t i = 0; i < reachable; i++) idom[i] = UINT32_MAX;
+    idom[0] = 0;
+    for(int changed = 1; changed;){
+        changed = 0;
+        for(uint32_t b = 1; b < reachable; b++){
+            uint32_t new_idom = UINT32_MAX;
+            for(uint64_t e = pred_start[b]; e < pred_start[b + 1]; e++){
+                uint32_t p = preds[e];
+                if(idom[p] == UINT32_MAX) continue;
+                if(new_idom == UINT32_MAX){
+                    new_idom = p;
+                    continue;
+                }
+                uint32_t x = p, y = new_idom;
+                while(x != y){
+                    while(x > y) x = idom[x];
+                    while(y > x) y = idom[y];
+                }
+                new_idom = x;
+            }
+            if(idom[b] != new_idom){
+                idom[b] = new_idom;
+                changed = 1;
+            }
+        }
+    }
+    free(preds);
+    free(pred_start);
+
+    //retained sizes, children have larger rpo numbers than their idom, so one backward sweep sums subtrees
+    uint64_t *retained_bytes = calloc((size_t)reachable + 1, sizeof(uint64_t));
+    uint64_t *retained_objects = calloc((size_t)reachable + 1, sizeof(uint64_t));
+    if(!retained_bytes || !retained_objects){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t b = reachable - 1; b > 0; b--){
+        ObjectDbRecord *obj_rec = nodes[order[b]].record;
+        retained_bytes[b] += (uint64_t)obj_rec->units * obj_rec->structure_record->structure_size;
+        retained_objects[b] += 1;
+        retained_bytes[idom[b]] += retained_bytes[b];
+        retained_objects[idom[b]] += retained_objects[b];
+    }
+
+    //top k by insertion, k is small
+    int filled = 0;
+    for(uint32_t b = 1; b < reachable; b++){
+        if(filled == k && (k == 0 || retained_bytes[b] <= top[k - 1].retained_bytes)) continue;
+        int pos = filled < k ? filled++ : k - 1;
+        while(pos > 0 && top[pos - 1].retained_bytes < retained_bytes[b]){
+            top[pos] = top[pos - 1];
+            pos--;
+        }
+        top[pos].pointer = nodes[order[b]].record->pointer;
+        top[pos].structure_record = nodes[order[b]].record->structure_record;
+        top[pos].retained_bytes = retained_bytes[b];
+        top[pos].retained_objects = retained_objects[b];
+    }
+
+    free(retained_bytes);
+    free(retained_objects);
+    free(idom);
+    free(order);
+    free(rpo);
+    free(graph.nodes);
+    return filled;
+}
+
+void print_top_retainers(MldRetainer *top, int count){
+    printf("| %-3s | %-30s | %-18s | %-16s | %-16s |\n", "#", "Structure", "Object", "Retained Bytes", "Retained Objects");
+    printf("|-----|--------------------------------|--------------------|------------------|------------------|\n");
+    for(int i = 0; i < count; i++){
+        printf("| %-3d | %-30s | %-18p | %-16llu | %-16llu |\n", i, top[i].structure_record->structure_name, top[i].pointer,
+               (unsigned long long)top[i].retained_bytes, (unsigned long long)top[i].retained_objects);
+    }
+}
+
+/*leak clustering, weakly connected components over the scc condensation*/
+
+static int mld_compare_leak_clusters(const void *a, const void *b){
+    uint64_t x = ((const MldLeakCluster *)a)->bytes, y = ((const MldLeakCluster *)b)->bytes;
+    return (x < y) - (x > y);
+}
+
+static uint32_t mld_cluster_find(uint32_t *parent, uint32_t v){
+    while(parent[v] != v){
+        parent[v] = parent[parent[v]]; //path halving
+        v = parent[v];
+    }
+    return v;
+}
+
+long mld_cluster_leaked_objects(ObjectDb *object_db, MldLeakCluster **clusters){
+    MldObjectGraph graph;
+    mld_build_object_graph(object_db, MLD_TRUE, &graph);
+    uint32_t n = graph.node_count;
+
+    //tarjan, component[v] numbers the scc of v, scc_entry & scc_size describe each scc
+    uint32_t *index = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t *lowlink = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    unsigned char *on_stack = calloc((size_t)n + 1, 1);
+    uint32_t *component_stack = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t *call_stack = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint64_t *cursor = malloc(((size_t)n + 1) * sizeof(uint64_t));
+    uint32_t *component = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t *scc_entry = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t *scc_size = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    if(!index || !lowlink || !on_stack || !component_stack || !call_stack || !cursor || !component || !scc_entry || !scc_size){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t v = 0; v < n; v++) index[v] = UINT32_MAX;
+
+    uint32_t next_index = 0, component_depth = 0, scc_count = 0;
+    for(uint32_t start = 0; start < n; start++){
+        if(index[start] != UINT32_MAX) continue;
+
+        uint32_t call_depth = 0;
+        call_stack[call_depth++] = start;
+        index[start] = lowlink[start] = next_index++;
+        cursor[start] = graph.edge_start[start];
+        component_stack[component_depth++] = start;
+        on_stack[start] = 1;
+
+        while(call_depth){
+            uint32_t v = call_stack[call_depth - 1];
+
+            if(cursor[v] < graph.edge_start[v + 1]){
+                uint32_t w = graph.edges[cursor[v]++];
+                if(index[w] == UINT32_MAX){
+                    index[w] = lowlink[w] = next_index++;
+                    cursor[w] = graph.edge_start[w];
+                    component_stack[component_depth++] = w;
+                    on_stack[w] = 1;
+                    call_stack[call_depth++] = w;
+                }else if(on_stack[w] && index[w] < lowlink[v]){
+                    lowlink[v] = index[w];
+                }
+                continue;
+            }
+
+            call_depth--;
+            if(call_depth && lowlink[v] < lowlink[call_stack[call_depth - 1]])
+                lowlink[call_stack[call_depth - 1]] = lowlink[v];
+            if(lowlink[v] != index[v]) continue;
+
+            //v is the first object of its scc reached by the search, pop the whole scc
+            uint32_t w;
+            scc_entry[scc_count] = v;
+            scc_size[scc_count] = 0;
+            do {
+                w = component_stack[--component_depth];
+                on_stack[w] = 0;
+                component[w] = scc_count;
+                scc_size[scc_count]++;
+            } while(w != v);
+            scc_count++;
+        }
+    }
+    free(index);
+    free(lowlink);
+    free(on_stack);
+    free(component_stack);
+    free(call_stack);
+    free(cursor);
+
+    /*
+    an scc with no edge from another scc is a source of the condensation, nothing else in the leak points to it,
+    every edge joins its ends into one weakly connected cluster, so a source is grouped with everything it reaches
+    & sources sharing leaked objects end up in one cluster
+    */
+    uint32_t *parent = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    unsigned char *has_incoming = calloc((size_t)scc_count + 1, 1);
+    uint32_t *cluster_of = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    uint32_t *entry_size = malloc(((size_t)n + 1) * sizeof(uint32_t));
+    if(!parent || !has_incoming || !cluster_of || !entry_size){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t v = 0; v < n; v++) parent[v] = v;
+    for(uint32_t v = 0; v < n; v++){
+        for(uint64_t e = graph.edge_start[v]; e < graph.edge_start[v + 1]; e++){
+            uint32_t w = graph.edges[e];
+            if(component[v] != component[w]) has_incoming[component[w]] = 1;
+            uint32_t x = mld_cluster_find(parent, v), y = mld_cluster_find(parent, w);
+            if(x != y) parent[x] = y;
+        }
+    }
+
+    long cluster_count = 0;
+    *clusters = malloc(((size_t)n + 1) * sizeof(MldLeakCluster));
+    if(!*clusters){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(uint32_t v = 0; v < n; v++) cluster_of[v] = UINT32_MAX;
+    for(uint32_t v = 0; v < n; v++){
+        uint32_t r = mld_cluster_find(parent, v);
+        if(cluster_of[r] == UINT32_MAX){
+            cluster_of[r] = cluster_count;
+            entry_size[cluster_count] = 0;
+            (*clusters)[cluster_count++] = (MldLeakCluster){0};
+        }
+        MldLeakCluster *cluster = &(*clusters)[cluster_of[r]];
+        ObjectDbRecord *obj_rec = graph.nodes[v].record;
+        cluster->object_count++;
+        cluster->bytes += (uint64_t)obj_rec->units * obj_rec->structure_record->structure_size;
+    }
+
+    //entry of a cluster is the first object of its largest source scc
+    for(uint32_t c = 0; c < scc_count; c++){
+        if(has_incoming[c]) continue;
+        uint32_t cluster_index = cluster_of[mld_cluster_find(parent, scc_entry[c])];
+        MldLeakCluster *cluster = &(*clusters)[cluster_index];
+        cluster->entry_count++;
+        if(scc_size[c] <= entry_size[cluster_index]) continue;
+        entry_size[cluster_index] = scc_size[c];
+        cluster->entry_pointer = graph.nodes[scc_entry[c]].record->pointer;
+        cluster->entry_structure = graph.nodes[scc_entry[c]].record->structure_record;
+    }
+
+    free(parent);
+    free(has_incoming);
+    free(cluster_of);
+    free(entry_size);
+    free(component);
+    free(scc_entry);
+    free(scc_size);
+    mld_free_object_graph(&graph);
+
+    qsort(*clusters, cluster_count, sizeof(MldLeakCluster), mld_compare_leak_clusters);
+    return cluster_count;
+}
+
+void report_leak_clusters(ObjectDb *object_db){
+    MldLeakCluster *clusters = NULL;
+    long cluster_count = mld_cluster_leaked_objects(object_db, &clusters);
+
+    printf("Leaked Object Clusters Report: %ld clusters\n", cluster_count);
+    printf("| %-30s | %-18s | %-8s | %-12s | %-14s |\n", "Entry Structure", "Entry Object", "Entries", "Objects", "Bytes");
+    printf("|--------------------------------|--------------------|----------|--------------|----------------|\n");
+    for(long i = 0; i < cluster_count; i++){
+        printf("| %-30s | %-18p | %-8llu | %-12llu | %-14llu |\n", clusters[i].entry_structure->structure_name, clusters[i].entry_pointer,
+               (unsigned long long)clusters[i].entry_count, (unsigned long long)clusters[i].object_count,
+               (unsigned long long)clusters[i].bytes);
+    }
+    free(clusters);
 }
 
 void init_primitive_data_types_support(StructureDb *struct_db){
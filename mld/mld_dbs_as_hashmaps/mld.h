@@ -7,6 +7,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <stdint.h>
 
 /*
 at the core, hashmap maintains array where each element os a bucket
@@ -34,18 +35,37 @@ more on buckets: each bucket is a linked list of object db records, to handle co
 #define MAX_STRUCTURE_NAME_LENGTH 128
 #define MAX_FIELD_NAME_LENGTH 128
 
+typedef enum {
+    MLD_FALSE,
+    MLD_TRUE
+} MldBoolean;
+
 typedef struct StructureDbRecord StructureDbRecord;
 
 typedef struct FieldInfo FieldInfo;
 
 typedef struct StructureDb StructureDb;
 
+typedef struct MldPointerArrayField MldPointerArrayField;
+
+//called on an object reclaimed by mld_collect before its memory is released, see mld_set_finalizer
+typedef void (*MldFinalizer)(void *object, StructureDbRecord *structure_record, unsigned int units);
+
 struct StructureDbRecord {
     StructureDbRecord *next;
     char structure_name[MAX_STRUCTURE_NAME_LENGTH];
     unsigned int structure_size;
     unsigned int field_count;
     FieldInfo *fields;
+    unsigned int stats_index; //slot of this structure in the leak statistics counters, assigned on registration
+    const uint64_t *pointer_map; //MLD_DEFINE_STRUCT types only, bit i set if pointer sized word i holds a pointer field, NULL otherwise
+    unsigned int *pointer_offsets; //offset within one unit of every pointer field, nested struct members expanded, built on registration
+    unsigned int pointer_offset_count;
+    MldBoolean pointer_offsets_pending; //some nested structure is not registered yet, offsets are rebuilt when it is
+    MldPointerArrayField *pointer_arrays; //OBJECT_pointer_DYNAMIC_ARRAY_TYPE fields, flattened like pointer_offsets
+    unsigned int pointer_array_count;
+    MldBoolean pointer_dense; //every pointer sized word of a unit is a pointer field, units are scanned as one word range
+    MldFinalizer finalizer; //NULL unless set by mld_set_finalizer
 };
 
 typedef enum {
@@ -57,7 +77,9 @@ typedef enum {
     DOUBLE_TYPE,
     OBJECT_pointer_TYPE,
     OBJECT_STRUCT_TYPE,
-    VOID_pointer_TYPE
+    VOID_pointer_TYPE,
+    OBJECT_pointer_ARRAY_TYPE, //T *field[N], every element is followed, N is size / sizeof(void *)
+    OBJECT_pointer_DYNAMIC_ARRAY_TYPE //T **field, buffer of as many pointers as the sibling length field says
 } DataType;
 
 struct FieldInfo {
@@ -66,6 +88,15 @@ struct FieldInfo {
     unsigned int size;
     unsigned int offset;
     char nested_structure_name[MAX_STRUCTURE_NAME_LENGTH];
+    unsigned int length_offset; //OBJECT_pointer_DYNAMIC_ARRAY_TYPE only, offset & size of the unsigned element count field
+    unsigned int length_size;
+};
+
+//dynamic pointer array of a flattened structure, offsets are within one unit
+struct MldPointerArrayField {
+    unsigned int offset;
+    unsigned int length_offset;
+    unsigned int length_size;
 };
 
 #define OFFSET_OFF(structure_name, field_name) \
@@ -74,13 +105,55 @@ struct FieldInfo {
 #define FIELD_SIZE(structure_name, field_name) \
     sizeof(((structure_name *)0)->field_name)
 
+//table size is a prime number
+#define TABLE_SIZE 101
+
 struct StructureDb {
-    StructureDbRecord *structutre_db_arr[100];
+    StructureDbRecord *structutre_db_arr[TABLE_SIZE];
     int count;
+    //perfect hash over the structure names, see mld_struct_db_install_perfect_hash, NULL if none is installed
+    StructureDbRecord **perfect_slots;
+    const uint32_t *perfect_seeds;
+    uint32_t perfect_slot_count;
+    uint32_t perfect_bucket_count;
+    int perfect_count; //count at install time, the perfect hash is used only while count still equals it
+    int frozen; //set by mld_struct_db_freeze, no structure can be added afterwards
 };
 
+/*
+perfect hashing of structure names, two level hash & displace over one 64 bit hash of the name
+bucket = hash % bucket_count, slot = mld_struct_name_slot(hash, seeds[bucket], slot_count)
+seeds are picked offline (mld_structgen) or at startup (mld_struct_db_freeze), so that no two registered names share a slot
+*/
+static inline uint64_t mld_struct_name_hash(const char *name){
+    uint64_t hash = 14695981039346656037ull;
+    for(; *name; name++){
+        hash ^= (unsigned char)*name;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static inline uint32_t mld_struct_name_slot(uint64_t hash, uint32_t seed, uint32_t slot_count){
+    hash ^= seed * 0x9E3779B97F4A7C15ull;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return (uint32_t)(hash % slot_count);
+}
+
+//FieldInfo entries are designated, members a field kind does not use stay zero
+#define MLD_FIELD_ENTRY(s, member, type, nested) \
+    .field_name = #member, .data_type = type, .size = FIELD_SIZE(s, member), .offset = OFFSET_OFF(s, member), \
+    .nested_structure_name = nested
+
 #define FIELD_INFO(structure_name, field_name, data_type, nested_structure_name) \
-    {#field_name, data_type, FIELD_SIZE(structure_name, field_name), OFFSET_OFF(structure_name, field_name), #nested_structure_name}
+    {MLD_FIELD_ENTRY(structure_name, field_name, data_type, #nested_structure_name)}
+
+//T **field_name with its element count in the sibling field length_field_name
+#define FIELD_INFO_DYNAMIC_ARRAY(structure_name, field_name, nested_structure_name, length_field_name) \
+    {MLD_FIELD_ENTRY(structure_name, field_name, OBJECT_pointer_DYNAMIC_ARRAY_TYPE, #nested_structure_name), \
+     .length_offset = OFFSET_OFF(structure_name, length_field_name), .length_size = FIELD_SIZE(structure_name, length_field_name)}
 
 #define REGISTER_STRUCTURE(struct_db, struct_name, fields_array) \
     do { \
@@ -98,6 +171,188 @@ struct StructureDb {
         } \
     } while(0);
 
+/*
+compile time structure reflection
+MLD_DEFINE_STRUCT emits the struct typedef, its FieldInfo table, a pointer map & a statically initialized StructureDbRecord,
+so a type is described once & registration is a single add_structure_to_database with no calloc & no printf
+
+    MLD_DEFINE_STRUCT(Employee,
+        FIELD(char, emp_name, 30),      char emp_name[30]
+        FIELD(unsigned int, emp_id),    unsigned int emp_id
+        PTR(Employee, mgr),             struct Employee *mgr
+        VOID_PTR(user_data),            void *user_data
+        NESTED(Address, home),          Address home, Address must be a typedef'd struct
+        PTR_ARRAY(Employee, team, 8),   struct Employee *team[8]
+        DYN_PTR_ARRAY(Employee, reports, report_count),   struct Employee **reports, report_count elements
+        FIELD(unsigned int, report_count),
+        FIELD(float, salary));
+
+    MLD_REGISTER_DEFINED_STRUCTURE(struct_db, Employee);
+
+FIELD takes an arithmetic type, its DataType is picked with _Generic, up to 32 fields per struct
+the pointer map covers the first MLD_POINTER_MAP_WORDS * 64 pointer sized words of the struct
+*/
+
+#define MLD_POINTER_MAP_WORDS 4
+
+#define FIELD(...) (FIELD, __VA_ARGS__)
+#define PTR(nested_structure_name, field_name) (PTR, nested_structure_name, field_name)
+#define VOID_PTR(field_name) (VOID_PTR, field_name)
+#define NESTED(nested_structure_name, field_name) (NESTED, nested_structure_name, field_name)
+#define PTR_ARRAY(nested_structure_name, field_name, count) (PTR_ARRAY, nested_structure_name, field_name, count)
+#define DYN_PTR_ARRAY(nested_structure_name, field_name, length_field_name) \
+    (DYN_PTR_ARRAY, nested_structure_name, field_name, length_field_name)
+
+#define MLD_DATA_TYPE_OF(c_type) \
+    _Generic((c_type)0, \
+        char: CHAR_TYPE, signed char: CHAR_TYPE, unsigned char: UINT8_TYPE, \
+        unsigned int: UINT32_TYPE, int: INT32_TYPE, \
+        float: FLOAT_TYPE, double: DOUBLE_TYPE, \
+        default: UINT32_TYPE)
+
+//apply m(structure_name, field) to every field, up to 32 fields
+#define MLD_EXPAND(x) x
+#define MLD_ARG_COUNT(...) MLD_ARG_COUNT_I(__VA_ARGS__, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, \
+    16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
+#define MLD_ARG_COUNT_I(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, _15, _16, _17, _18, _19, _20, \
+    _21, _22, _23, _24, _25, _26, _27, _28, _29, _30, _31, _32, count, ...) count
+#define MLD_CONCAT(a, b) MLD_CONCAT_I(a, b)
+#define MLD_CONCAT_I(a, b) a##b
+#define MLD_FOR_EACH(m, s, ...) MLD_CONCAT(MLD_FOR_EACH_, MLD_ARG_COUNT(__VA_ARGS__))(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_1(m, s, x) m(s, x)
+#define MLD_FOR_EACH_2(m, s, x, ...) m(s, x) MLD_FOR_EACH_1(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_3(m, s, x, ...) m(s, x) MLD_FOR_EACH_2(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_4(m, s, x, ...) m(s, x) MLD_FOR_EACH_3(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_5(m, s, x, ...) m(s, x) MLD_FOR_EACH_4(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_6(m, s, x, ...) m(s, x) MLD_FOR_EACH_5(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_7(m, s, x, ...) m(s, x) MLD_FOR_EACH_6(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_8(m, s, x, ...) m(s, x) MLD_FOR_EACH_7(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_9(m, s, x, ...) m(s, x) MLD_FOR_EACH_8(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_10(m, s, x, ...) m(s, x) MLD_FOR_EACH_9(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_11(m, s, x, ...) m(s, x) MLD_FOR_EACH_10(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_12(m, s, x, ...) m(s, x) MLD_FOR_EACH_11(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_13(m, s, x, ...) m(s, x) MLD_FOR_EACH_12(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_14(m, s, x, ...) m(s, x) MLD_FOR_EACH_13(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_15(m, s, x, ...) m(s, x) MLD_FOR_EACH_14(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_16(m, s, x, ...) m(s, x) MLD_FOR_EACH_15(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_17(m, s, x, ...) m(s, x) MLD_FOR_EACH_16(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_18(m, s, x, ...) m(s, x) MLD_FOR_EACH_17(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_19(m, s, x, ...) m(s, x) MLD_FOR_EACH_18(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_20(m, s, x, ...) m(s, x) MLD_FOR_EACH_19(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_21(m, s, x, ...) m(s, x) MLD_FOR_EACH_20(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_22(m, s, x, ...) m(s, x) MLD_FOR_EACH_21(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_23(m, s, x, ...) m(s, x) MLD_FOR_EACH_22(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_24(m, s, x, ...) m(s, x) MLD_FOR_EACH_23(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_25(m, s, x, ...) m(s, x) MLD_FOR_EACH_24(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_26(m, s, x, ...) m(s, x) MLD_FOR_EACH_25(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_27(m, s, x, ...) m(s, x) MLD_FOR_EACH_26(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_28(m, s, x, ...) m(s, x) MLD_FOR_EACH_27(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_29(m, s, x, ...) m(s, x) MLD_FOR_EACH_28(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_30(m, s, x, ...) m(s, x) MLD_FOR_EACH_29(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_31(m, s, x, ...) m(s, x) MLD_FOR_EACH_30(m, s, __VA_ARGS__)
+#define MLD_FOR_EACH_32(m, s, x, ...) m(s, x) MLD_FOR_EACH_31(m, s, __VA_ARGS__)
+
+//field (KIND, args...) is dispatched to MLD_<context>_<KIND>(structure_name, args...)
+#define MLD_DISPATCH(context, s, field) MLD_EXPAND(MLD_DISPATCH_I(context, s, MLD_EXPAND(MLD_UNPACK field)))
+#define MLD_UNPACK(...) __VA_ARGS__
+#define MLD_DISPATCH_I(context, s, ...) MLD_DISPATCH_II(context, s, __VA_ARGS__)
+#define MLD_DISPATCH_II(context, s, kind, ...) MLD_##context##_##kind(s, __VA_ARGS__)
+
+//struct members
+#define MLD_MEMBER(s, field) MLD_DISPATCH(MEMBER, s, field)
+#define MLD_MEMBER_FIELD(s, c_type, field_name, ...) c_type field_name __VA_OPT__([__VA_ARGS__]);
+#define MLD_MEMBER_PTR(s, nested, field_name) struct nested *field_name;
+#define MLD_MEMBER_VOID_PTR(s, field_name) void *field_name;
+#define MLD_MEMBER_NESTED(s, nested, field_name) nested field_name;
+#define MLD_MEMBER_PTR_ARRAY(s, nested, field_name, count) struct nested *field_name[count];
+#define MLD_MEMBER_DYN_PTR_ARRAY(s, nested, field_name, length_field_name) struct nested **field_name;
+
+//FieldInfo table entries
+#define MLD_FIELD_INFO(s, field) MLD_DISPATCH(FIELD_INFO, s, field)
+#define MLD_FIELD_INFO_FIELD(s, c_type, field_name, ...) \
+    {MLD_FIELD_ENTRY(s, field_name, MLD_DATA_TYPE_OF(c_type), "")},
+#define MLD_FIELD_INFO_PTR(s, nested, field_name) \
+    {MLD_FIELD_ENTRY(s, field_name, OBJECT_pointer_TYPE, #nested)},
+#define MLD_FIELD_INFO_VOID_PTR(s, field_name) \
+    {MLD_FIELD_ENTRY(s, field_name, VOID_pointer_TYPE, "")},
+#define MLD_FIELD_INFO_NESTED(s, nested, field_name) \
+    {MLD_FIELD_ENTRY(s, field_name, OBJECT_STRUCT_TYPE, #nested)},
+#define MLD_FIELD_INFO_PTR_ARRAY(s, nested, field_name, count) \
+    {MLD_FIELD_ENTRY(s, field_name, OBJECT_pointer_ARRAY_TYPE, #nested)},
+#define MLD_FIELD_INFO_DYN_PTR_ARRAY(s, nested, field_name, length_field_name) \
+    FIELD_INFO_DYNAMIC_ARRAY(s, field_name, nested, length_field_name),
+
+//pointer map, one term per pointer field for each map word, MLD_POINTER_MAP_WORD selects the word
+#define MLD_POINTER_BIT(s, field_name, word) \
+    ((OFFSET_OFF(s, field_name) / sizeof(void *)) / 64 == (word) ? \
+        (1ULL << ((OFFSET_OFF(s, field_name) / sizeof(void *)) % 64)) : 0ULL)
+//bits of map word `word` covering pointer sized words [first, first + count)
+#define MLD_LOW_BITS(n) ((n) >= 64 ? ~0ULL : ((1ULL << ((n) & 63)) - 1))
+#define MLD_POINTER_WORD_BITS(first, count, word) \
+    MLD_POINTER_WORD_BITS_I((long)(first) - 64 * (long)(word), (long)(first) + (long)(count) - 64 * (long)(word))
+#define MLD_POINTER_WORD_BITS_I(lo, hi) \
+    ((lo) < 64 && (hi) > 0 ? (MLD_LOW_BITS((hi) > 64 ? 64 : (hi)) & ~MLD_LOW_BITS((lo) < 0 ? 0 : (lo))) : 0ULL)
+#define MLD_POINTER_ARRAY_BITS(s, field_name, word) \
+    MLD_POINTER_WORD_BITS(OFFSET_OFF(s, field_name) / sizeof(void *), FIELD_SIZE(s, field_name) / sizeof(void *), word)
+#define MLD_POINTER_MAP_0(s, field) MLD_DISPATCH(POINTER_MAP_0, s, field)
+#define MLD_POINTER_MAP_1(s, field) MLD_DISPATCH(POINTER_MAP_1, s, field)
+#define MLD_POINTER_MAP_2(s, field) MLD_DISPATCH(POINTER_MAP_2, s, field)
+#define MLD_POINTER_MAP_3(s, field) MLD_DISPATCH(POINTER_MAP_3, s, field)
+#define MLD_POINTER_MAP_0_FIELD(s, ...)
+#define MLD_POINTER_MAP_0_NESTED(s, nested, field_name)
+#define MLD_POINTER_MAP_0_PTR(s, nested, field_name) | MLD_POINTER_BIT(s, field_name, 0)
+#define MLD_POINTER_MAP_0_VOID_PTR(s, field_name) | MLD_POINTER_BIT(s, field_name, 0)
+#define MLD_POINTER_MAP_0_PTR_ARRAY(s, nested, field_name, count) | MLD_POINTER_ARRAY_BITS(s, field_name, 0)
+#define MLD_POINTER_MAP_0_DYN_PTR_ARRAY(s, nested, field_name, length) | MLD_POINTER_BIT(s, field_name, 0)
+#define MLD_POINTER_MAP_1_FIELD(s, ...)
+#define MLD_POINTER_MAP_1_NESTED(s, nested, field_name)
+#define MLD_POINTER_MAP_1_PTR(s, nested, field_name) | MLD_POINTER_BIT(s, field_name, 1)
+#define MLD_POINTER_MAP_1_VOID_PTR(s, field_name) | MLD_POINTER_BIT(s, field_name, 1)
+#define MLD_POINTER_MAP_1_PTR_ARRAY(s, nested, field_name, count) | MLD_POINTER_ARRAY_BITS(s, field_name, 1)
+#define MLD_POINTER_MAP_1_DYN_PTR_ARRAY(s, nested, field_name, length) | MLD_POINTER_BIT(s, field_name, 1)
+#define MLD_POINTER_MAP_2_FIELD(s, ...)
+#define MLD_POINTER_MAP_2_NESTED(s, nested, field_name)
+#define MLD_POINTER_MAP_2_PTR(s, nested, field_name) | MLD_POINTER_BIT(s, field_name, 2)
+#define MLD_POINTER_MAP_2_VOID_PTR(s, field_name) | MLD_POINTER_BIT(s, field_name, 2)
+#define MLD_POINTER_MAP_2_PTR_ARRAY(s, nested, field_name, count) | MLD_POINTER_ARRAY_BITS(s, field_name, 2)
+#define MLD_POINTER_MAP_2_DYN_PTR_ARRAY(s, nested, field_name, length) | MLD_POINTER_BIT(s, field_name, 2)
+#define MLD_POINTER_MAP_3_FIELD(s, ...)
+#define MLD_POINTER_MAP_3_NESTED(s, nested, field_name)
+#define MLD_POINTER_MAP_3_PTR(s, nested, field_name) | MLD_POINTER_BIT(s, field_name, 3)
+#define MLD_POINTER_MAP_3_VOID_PTR(s, field_name) | MLD_POINTER_BIT(s, field_name, 3)
+#define MLD_POINTER_MAP_3_PTR_ARRAY(s, nested, field_name, count) | MLD_POINTER_ARRAY_BITS(s, field_name, 3)
+#define MLD_POINTER_MAP_3_DYN_PTR_ARRAY(s, nested, field_name, length) | MLD_POINTER_BIT(s, field_name, 3)
+
+#define MLD_DEFINE_STRUCT(struct_name, ...) \
+    typedef struct struct_name { \
+        MLD_FOR_EACH(MLD_MEMBER, struct_name, __VA_ARGS__) \
+    } struct_name; \
+    _Static_assert(sizeof(struct_name) <= MLD_POINTER_MAP_WORDS * 64 * sizeof(void *), \
+                   #struct_name " is too large for the MLD pointer map"); \
+    static FieldInfo struct_name##_mld_fields[] = { \
+        MLD_FOR_EACH(MLD_FIELD_INFO, struct_name, __VA_ARGS__) \
+    }; \
+    static const uint64_t struct_name##_mld_pointer_map[MLD_POINTER_MAP_WORDS] = { \
+        0ULL MLD_FOR_EACH(MLD_POINTER_MAP_0, struct_name, __VA_ARGS__), \
+        0ULL MLD_FOR_EACH(MLD_POINTER_MAP_1, struct_name, __VA_ARGS__), \
+        0ULL MLD_FOR_EACH(MLD_POINTER_MAP_2, struct_name, __VA_ARGS__), \
+        0ULL MLD_FOR_EACH(MLD_POINTER_MAP_3, struct_name, __VA_ARGS__) \
+    }; \
+    static StructureDbRecord struct_name##_mld_record = { \
+        .structure_name = #struct_name, \
+        .structure_size = sizeof(struct_name), \
+        .field_count = sizeof(struct_name##_mld_fields) / sizeof(FieldInfo), \
+        .fields = struct_name##_mld_fields, \
+        .pointer_map = struct_name##_mld_pointer_map \
+    }
+
+#define MLD_REGISTER_DEFINED_STRUCTURE(struct_db, struct_name) \
+    do { \
+        if(add_structure_to_database(struct_db, &struct_name##_mld_record)) { \
+            assert(0); \
+        } \
+    } while(0)
+
 void print_structure_record(StructureDbRecord *structure_record);
 
 void print_structure_database(StructureDb *struct_db);
@@ -106,6 +361,27 @@ int add_structure_to_database(StructureDb *struct_db, StructureDbRecord *structu
 
 StructureDbRecord *struct_db_lookup(StructureDb *struct_db, char *structure_name);
 
+//install a perfect hash over the structures registered so far, slots & seeds must outlive struct_db
+void mld_struct_db_install_perfect_hash(StructureDb *struct_db, StructureDbRecord **slots, uint32_t slot_count,
+                                        const uint32_t *seeds, uint32_t bucket_count);
+
+#define MLD_PERFECT_HASH_SEED_TRIES (1u << 20)
+
+//hash & displace seed search, slots_out[s] is the index of the name placed in slot s or -1, outputs are malloc'd
+void mld_build_perfect_hash(char **names, uint32_t count, int **slots_out, uint32_t *slot_count_out,
+                            uint32_t **seeds_out, uint32_t *bucket_count_out);
+
+/*
+freeze the struct db once all structures are registered
+a perfect hash is built over the registered records & struct_db_lookup becomes one probe & one compare,
+records are not copied, so objects allocated before & after the freeze share them
+nothing is written afterwards, so lookups need no lock, add_structure_to_database fails on a frozen db
+*/
+void mld_struct_db_freeze(StructureDb *struct_db);
+
+//defined by the source file mld_structgen generates, registers every scanned structure plus int/float/double
+void mld_register_generated_structures(StructureDb *struct_db);
+
 /*struct db definition ends*/
 
 /*object db definition begins here*/
@@ -114,10 +390,13 @@ typedef struct ObjectDbRecord ObjectDbRecord;
 
 typedef struct ObjectDb ObjectDb;
 
+//allocator an object came from, objects registered without allocation are MLD_HEAP_LIBC too & are never freed by mld
 typedef enum {
-    MLD_FALSE,
-    MLD_TRUE
-} MldBoolean;
+    MLD_HEAP_LIBC,
+    MLD_HEAP_DEBUG,
+    MLD_HEAP_LARGE,
+    MLD_HEAP_SLAB
+} MldHeapKind;
 
 struct ObjectDbRecord {
     ObjectDbRecord *next;
@@ -126,14 +405,336 @@ struct ObjectDbRecord {
     StructureDbRecord *structure_record;
     MldBoolean is_visited;
     MldBoolean is_root;
+    const char *alloc_file; //allocation site, recorded in TRACE builds only, NULL otherwise
+    unsigned int alloc_line;
+    //generational mode only, see MldGenerations
+    MldBoolean is_old;
+    unsigned int survived; //scans survived while young
+    unsigned int remembered_slot; //index + 1 in the remembered set, 0 if not remembered
+    ObjectDbRecord *young_prev, *young_next;
+    MldHeapKind heap_kind;
 };
 
+/*
+object records are hashed on the object address, so that untyped frees (no structure name known) are a single bucket walk
+the table is allocated with MLD_OBJECT_TABLE_MIN buckets when the first record is added,
+& doubles whenever count passes the number of buckets
+*/
+#define MLD_OBJECT_TABLE_MIN 1024
+
+typedef struct MldGenerations MldGenerations;
+
+typedef struct MldDebugHeap MldDebugHeap;
+
+typedef struct MldLargeArena MldLargeArena;
+
+typedef struct MldSlabHeap MldSlabHeap;
+
+/*
+free errors, xfree & xfree_batch never free a pointer without an object record, they report it instead
+1. double free, the pointer is in the ring of the last MLD_RECENTLY_FREED_SIZE freed addresses
+2. interior free, the pointer lies inside a tracked object, found by a walk of object db on this error path only
+3. invalid free, any other untracked pointer
+the ring costs one slot write per free, it is read only when the lookup in xfree failed
+*/
+#define MLD_RECENTLY_FREED_SIZE 64
+
+typedef enum {
+    MLD_DOUBLE_FREE,
+    MLD_INTERIOR_FREE,
+    MLD_INVALID_FREE
+} MldFreeErrorKind;
+
+typedef struct MldFreeError {
+    MldFreeErrorKind kind;
+    void *pointer;
+    const char *file; //call site in TRACE builds, NULL otherwise
+    int line;
+    void *caller; //return address of the xfree call, always set
+    const char *structure_name; //double free: type of the freed object, interior free: type of the containing object
+    void *object; //interior free: start of the containing object
+} MldFreeError;
+
+typedef void (*MldFreeErrorHandler)(const MldFreeError *error, void *user_data);
+
+typedef struct MldFreedEntry {
+    void *pointer;
+    StructureDbRecord *structure_record;
+} MldFreedEntry;
+
+//progress of the lazy sweep started by mld_collect, buckets of object db first, then slabs
+typedef struct MldSweep {
+    MldBoolean pending; //objects allocated while pending start visited, so the sweep never takes them
+    MldBoolean active; //a step is running, a finalizer which allocates does not start a nested step
+    unsigned int bucket;
+    unsigned int position; //records of the current bucket already kept
+    unsigned int slab;
+    unsigned int slot;
+    unsigned long freed_objects; //totals over all collections
+    unsigned long freed_bytes;
+} MldSweep;
+
 struct ObjectDb {
-    ObjectDbRecord *object_db_arr[100];
+    ObjectDbRecord **object_db_arr; //table_size buckets, NULL until the first record is added
+    unsigned int table_size; //a power of two, 0 until the first record is added
     StructureDb *struct_db;
     int count;
+    MldGenerations *generations; //NULL unless generational scanning is enabled
+    MldDebugHeap *debug_heap; //NULL unless the debug heap is enabled
+    MldLargeArena *large_arena; //NULL unless the large object arena is enabled
+    MldSlabHeap *slab_heap; //NULL unless the slab heap is enabled
+    MldFreeErrorHandler free_error_handler; //NULL reports on stderr
+    void *free_error_data;
+    unsigned int recently_freed_next;
+    MldFreedEntry recently_freed[MLD_RECENTLY_FREED_SIZE];
+    MldSweep sweep;
+    unsigned int root_sources; //MldRootSource bits, 0 unless root discovery is enabled
 };
 
+void mld_set_free_error_handler(ObjectDb *object_db, MldFreeErrorHandler handler, void *user_data);
+
+/*
+collect mode, reclaims the objects a full scan found unreachable instead of only reporting them
+1. mld_collect runs a full scan & leaves a sweep pending, nothing is freed yet
+2. every later xmalloc/xcalloc/xmalloc_batch/xrealloc sweeps MLD_SWEEP_STEP units of work first, a unit is one record looked at
+   (kept or freed), one empty bucket, one object freed from a slab or one slab bitmap word with nothing to free,
+   so the pause added to an allocation is bounded whatever the heap size & however long a bucket chain is
+   the object xrealloc resizes is kept by the sweep, it is still in use
+3. a reclaimed object is unlinked, its finalizer (if any) is called, then its memory is released
+a finalizer must not free its own object, objects it points to may already be reclaimed,
+any scan first finishes a pending sweep, so reports never see a half swept heap
+the collector is only as good as the roots, an object reachable only from untracked memory (libc blocks, & stacks or globals
+unless root discovery covers them) is reclaimed
+*/
+#define MLD_SWEEP_STEP 64
+
+void mld_set_finalizer(StructureDb *struct_db, char *structure_name, MldFinalizer finalizer);
+
+void mld_collect(ObjectDb *object_db);
+
+MldBoolean mld_sweep_step(ObjectDb *object_db, unsigned int budget); //returns MLD_TRUE while the sweep is still pending
+
+void mld_finish_sweep(ObjectDb *object_db);
+
+/*
+root discovery, conservative roots found by every scan in addition to the registered ones
+1. MLD_ROOTS_DATA, writable PT_LOAD segments (data, bss) of the program & of every loaded library, listed with dl_iterate_phdr
+2. MLD_ROOTS_STACKS, the stack of the scanning thread above the public scan call (MLD's own frames are skipped), callee saved registers spilled first,
+   & the stack of every thread registered with mld_register_thread, such threads are stopped with MLD_SUSPEND_SIGNAL
+   while their stacks are filtered, the kernel saves their registers in the signal frame on their stack, they resume on MLD_RESUME_SIGNAL
+every pointer aligned word of a range goes through the candidate filter, survivors are looked up & marked like pointer fields
+nothing is allocated while threads are stopped, a thread stopped inside malloc can not block the scan,
+room for every word of every registered stack is reserved first, untouched pages of it cost no memory
+marking runs after the threads resume, an object a thread moves from its stack into the heap during the scan may be missed
+a registered thread must call mld_unregister_thread before it exits & must not call into MLD while a scan runs
+*/
+typedef enum {
+    MLD_ROOTS_DATA = 1,
+    MLD_ROOTS_STACKS = 2
+} MldRootSource;
+
+void mld_enable_root_discovery(ObjectDb *object_db, unsigned int sources); //sources is a mask of MldRootSource
+
+void mld_register_thread(void);
+
+void mld_unregister_thread(void);
+
+/*
+generational scanning
+objects start young, a young object which is reachable in promote_after scans is promoted to the old generation
+a minor scan resets & marks young objects only, from young roots plus the remembered set, old objects keep their last full scan state
+the remembered set holds old objects which may point to young objects, it is fed by
+1. MLD_STORE, which logs the object written into whenever a non NULL pointer is stored
+2. promotion, a promoted object which still points to a young object is remembered
+entries which no longer point to any young object are dropped after every scan
+every full_every-th scan of run_mld_algorithm is a full scan, which also finds old objects that became unreachable
+pointer stores into old objects which bypass MLD_STORE are only seen by the next full scan
+*/
+#define MLD_STORE_LOG_SIZE 4096
+
+struct MldGenerations {
+    unsigned int promote_after;
+    unsigned int full_every;
+    unsigned int scans_since_full;
+    ObjectDbRecord *young; //list of young objects, linked through young_prev/young_next
+    unsigned int young_count;
+    ObjectDbRecord **remembered;
+    unsigned int remembered_count;
+    unsigned int remembered_capacity;
+    void *store_log[MLD_STORE_LOG_SIZE]; //objects written into since the last flush, resolved lazily
+    unsigned int store_log_count;
+};
+
+void mld_enable_generations(ObjectDb *object_db, unsigned int promote_after, unsigned int full_every); //all existing objects start young
+
+void mld_disable_generations(ObjectDb *object_db);
+
+void mld_flush_store_log(ObjectDb *object_db); //resolve logged objects, old ones enter the remembered set
+
+void mld_run_minor_scan(ObjectDb *object_db);
+
+void mld_run_full_scan(ObjectDb *object_db);
+
+static inline void mld_remember_store(ObjectDb *object_db, void *object){
+    MldGenerations *generations = object_db->generations;
+    if(generations->store_log_count && generations->store_log[generations->store_log_count - 1] == object) return;
+    generations->store_log[generations->store_log_count++] = object;
+    if(generations->store_log_count == MLD_STORE_LOG_SIZE) mld_flush_store_log(object_db);
+}
+
+//store value into lvalue, a field of the tracked object starting at object, & log the store for the remembered set
+#define MLD_STORE(object_db, object, lvalue, value) \
+    do{ \
+        (lvalue) = (value); \
+        if((object_db)->generations && (lvalue)) mld_remember_store((object_db), (object)); \
+    }while(0)
+
+/*
+debug heap, optional overflow & use after free detection for blocks handed out by xmalloc/xcalloc/xrealloc
+1. blocks below guard_threshold bytes come from malloc with MLD_REDZONE_SIZE canary bytes in front & at least as many behind,
+   canaries are checked on xfree/xrealloc, on every scan & when the block leaves quarantine
+2. blocks of guard_threshold bytes & more get their own mapping, the user bytes end (16 byte aligned) at a PROT_NONE guard page,
+   so an overflow past the end faults at once, the slack in front of & behind the block is canary filled as well
+3. freed blocks are held in a FIFO quarantine of at most MLD_QUARANTINE_SLOTS blocks & quarantine_limit bytes,
+   small blocks are filled with MLD_FREED_BYTE & the fill is checked on eviction, guarded blocks are made PROT_NONE
+corruption is reported on stderr & counted, execution continues
+blocks allocated before the debug heap was enabled are freed as before
+*/
+#define MLD_REDZONE_SIZE 16
+#define MLD_REDZONE_BYTE 0xFA
+#define MLD_FREED_BYTE 0xFD
+#define MLD_QUARANTINE_SLOTS 1024
+
+typedef struct MldQuarantineEntry {
+    void *pointer;
+    size_t size;
+} MldQuarantineEntry;
+
+struct MldDebugHeap {
+    size_t guard_threshold;
+    size_t quarantine_limit;
+    size_t quarantine_bytes; //user bytes currently held
+    size_t page_size;
+    MldQuarantineEntry quarantine[MLD_QUARANTINE_SLOTS]; //ring, oldest entry at quarantine_head
+    unsigned int quarantine_head;
+    unsigned int quarantine_count;
+    unsigned long corruptions; //corrupted canaries & freed fills found so far
+};
+
+void mld_enable_debug_heap(ObjectDb *object_db, size_t guard_threshold, size_t quarantine_limit); //guard_threshold 0 means one page
+
+unsigned long mld_check_redzones(ObjectDb *object_db); //checks every live debug block, returns the number found corrupted
+
+void mld_drain_quarantine(ObjectDb *object_db); //checks & releases every quarantined block
+
+/*
+large object arena, xmalloc/xcalloc/xmalloc_batch blocks of threshold bytes & more get a private anonymous mapping
+1. mappings are zero filled by the kernel, so xcalloc does not touch the memory & untouched pages cost nothing
+2. with huge_pages, blocks of MLD_HUGE_PAGE_SIZE & more are mapped huge page aligned & madvised MADV_HUGEPAGE
+3. xrealloc grows & shrinks a block with mremap, no copy
+4. xfree unmaps at once, the memory goes back to the kernel instead of fragmenting the libc heap
+the arena keeps its own small sorted index of mappings, object records of large blocks live in object db as usual
+the marker scans a large object in chunks of units, each chunk is filtered & marked before the next, so its candidate buffer stays bounded
+debug heap takes precedence, with both enabled every block gets redzones
+*/
+#define MLD_LARGE_OBJECT_THRESHOLD (1u << 20)
+#define MLD_HUGE_PAGE_SIZE (2u << 20)
+
+typedef struct MldLargeRegion {
+    void *pointer; //start of the mapping, also the object address
+    size_t length; //mapped bytes
+} MldLargeRegion;
+
+struct MldLargeArena {
+    size_t threshold;
+    MldBoolean huge_pages;
+    size_t page_size;
+    MldLargeRegion *regions; //sorted by address
+    unsigned int count;
+    unsigned int capacity;
+    size_t mapped_bytes;
+};
+
+void mld_enable_large_arena(ObjectDb *object_db, size_t threshold, MldBoolean huge_pages); //threshold 0 means MLD_LARGE_OBJECT_THRESHOLD
+
+/*
+slab heap, segregated allocator for single unit xmalloc/xcalloc objects, one slab list per structure type
+1. a slab is MLD_SLAB_SIZE bytes, aligned to its size, holding objects of one type back to back, so objects of a type are adjacent
+2. slab objects have no object record, a slab keeps live, marked & root bitmaps instead & its base is found by masking an address,
+   the slab itself is described by an embedded record (capacity units of its type) which is never linked into object db
+3. the marker resolves a candidate inside a slab with one probe of the slab table & a division, no chain walk,
+   leaked objects of a slab are live & ~marked
+4. object_db_lookup & walks of object db (snapshots, graphs, print_object_database) do not see slab objects,
+   object_db->count excludes them, statistics & leak reports include them
+types smaller than a pointer or larger than MLD_SLAB_MAX_OBJECT, multi unit objects & types beyond the statistics slots use libc,
+empty slabs are kept for reuse, debug heap takes precedence, generational scanning & slab heap are exclusive
+*/
+#define MLD_SLAB_SHIFT 16
+#define MLD_SLAB_SIZE (1u << MLD_SLAB_SHIFT)
+#define MLD_SLAB_MAX_OBJECT 2048
+#define MLD_SLAB_BITMAP_WORDS (MLD_SLAB_SIZE / sizeof(void *) / 64)
+#define MLD_SLAB_MAX_TYPES 255 //statistics slots with a single owner, the last slot is shared by overflow types
+
+typedef struct MldSlab MldSlab;
+
+struct MldSlab {
+    ObjectDbRecord record; //pointer is the slab base, units its capacity
+    MldSlab *next_partial; //next slab of the type with a free slot
+    MldBoolean on_partial;
+    unsigned int live_count;
+    unsigned int root_count;
+    unsigned int free_hint; //no free slot below this bitmap word
+    uint64_t live[MLD_SLAB_BITMAP_WORDS]; //bits past capacity are set, so they are never handed out
+    uint64_t marked[MLD_SLAB_BITMAP_WORDS];
+    uint64_t roots[MLD_SLAB_BITMAP_WORDS];
+};
+
+struct MldSlabHeap {
+    MldSlab *partial[MLD_SLAB_MAX_TYPES]; //indexed by StructureDbRecord stats_index
+    MldSlab **slabs;
+    unsigned int slab_count;
+    unsigned int slab_capacity;
+    MldSlab **table; //open addressing on slab base, at most half full
+    unsigned int table_size;
+    unsigned long live_objects;
+};
+
+void mld_enable_slab_heap(ObjectDb *object_db);
+
+unsigned long mld_slab_leaked_objects(ObjectDb *object_db); //after a scan, live & unmarked slab objects
+
+/*
+candidate pointer filter, built from the live object records before a mark pass
+a word survives if it lies in [low, high], has none of the align_mask bits set & its page bit is set,
+only survivors are looked up in object db, so scanning pointer sparse memory costs a few vector ops per word
+the kernel is picked once via cpuid: avx2, sse4.2 or portable scalar, MLD_FILTER_KERNEL=scalar|sse4.2|avx2 overrides it
+*/
+#define MLD_PAGE_BITMAP_MAX_BITS (1u << 22)
+
+typedef struct MldCandidateFilter {
+    uintptr_t low, high; //lowest & highest live object address, high is 0 if there are no objects
+    uintptr_t align_mask; //low address bits which are clear in every live object address
+    unsigned int page_shift; //one bitmap bit per 1 << page_shift bytes from low
+    uint64_t *page_bitmap;
+} MldCandidateFilter;
+
+void mld_candidate_filter_build(ObjectDb *object_db, MldCandidateFilter *filter);
+
+void mld_candidate_filter_free(MldCandidateFilter *filter);
+
+//copies the surviving words of [words, words + count) to out & returns how many, out may be words itself
+size_t mld_filter_candidates(const MldCandidateFilter *filter, const uintptr_t *words, size_t count, uintptr_t *out);
+
+const char *mld_filter_kernel_name(void);
+
+ObjectDbRecord *object_db_lookup(char *structure_name, ObjectDb *object_db, void *pointer);
+
+void object_db_move_record(ObjectDb *object_db, ObjectDbRecord *obj_rec, void *new_pointer);
+
+int xmalloc_batch(ObjectDb *object_db, char *structure_name, int count, void **out_ptrs); //returns number of objects allocated, after a failure out_ptrs[0..returned) are allocated & tracked
+
+void xfree_batch(ObjectDb *object_db, void **ptrs, int count);
+
 void print_object_record(ObjectDbRecord *object_record);
 
 void print_object_database(ObjectDb *object_db);
@@ -148,6 +749,290 @@ void init_primitive_data_types_support(StructureDb *struct_db);
 
 void report_leaked_objects(ObjectDb *object_db);
 
+/*
+streaming machine readable leak report, to be called after run_mld_algorithm
+records are formatted into a large buffer & written to fd with write(2), no stdio on the hot path
+one record per leaked object, or with aggregate one record per structure type (count & bytes)
+field values are dumped only if dump_fields is set, the per object dump is by far the most expensive part
+returns the number of records written, -1 if a write failed
+*/
+
+typedef enum {
+    MLD_REPORT_JSONL,
+    MLD_REPORT_CSV
+} MldReportFormat;
+
+#define MLD_REPORT_BUFFER_SIZE (1 << 20)
+
+long mld_write_leak_report(ObjectDb *object_db, int fd, MldReportFormat format, MldBoolean aggregate, MldBoolean dump_fields);
+
+/*
+exit hook, mld_report_at_exit queues a report which runs a full scan & writes the leak report to fd when the process exits
+1. by default the report is per object (per type with MLD_EXIT_AGGREGATE), then object db is torn down by mld_destroy_object_db
+2. MLD_EXIT_FAST writes the per type report only & skips the teardown, a pending sweep is dropped & no record is freed
+the reports run from one handler registered with atexit by the first call, newest report first, the same handler is also a destructor
+& whichever runs first writes them, stdio is flushed before & after every report, other exit handlers, destructors & stdio are untouched
+exit handlers run in reverse order of registration, call it right after creating object db so the reports run after the application's own
+a process which ends by _exit, _Exit, abort or a fatal signal writes no report
+*/
+typedef enum {
+    MLD_EXIT_AGGREGATE = 1,
+    MLD_EXIT_DUMP_FIELDS = 2,
+    MLD_EXIT_FAST = 4
+} MldExitFlag;
+
+void mld_report_at_exit(ObjectDb *object_db, int fd, MldReportFormat format, unsigned int flags); //flags is a mask of MldExitFlag
+
+//frees every object record & the state of the optional heaps & scanners, tracked objects stay allocated, object db is left empty
+void mld_destroy_object_db(ObjectDb *object_db);
+
+/*heap snapshot begin*/
+
+/*
+flat, offset based snapshot of struct db & object db, all offsets are from the start of the file
+layout: header | structure table | field table | site table | pointer offset table | pointer array table |
+        object table (sorted by address) | object contents (optional)
+the site table holds the distinct allocation sites of TRACE builds, objects without a site have site_index MLD_SNAPSHOT_NO_INDEX
+the pointer offset & pointer array tables hold the flattened pointer offsets & dynamic pointer arrays of every structure,
+the same ones the live marker scans, so nested structures & array elements are followed offline exactly as they are in process
+a reader mmaps the file privately & works on it in place, mark bits are written into the mapped object table
+*/
+
+#define MLD_SNAPSHOT_MAGIC 0x31504E53444C4DULL //"MLDSNP1"
+#define MLD_SNAPSHOT_NO_INDEX 0xFFFFFFFFu
+#define MLD_SNAPSHOT_NO_CONTENTS 0xFFFFFFFFFFFFFFFFULL
+#define MLD_SNAPSHOT_SITE_FILE_LENGTH 256
+
+typedef struct MldSnapshotHeader {
+    uint64_t magic;
+    uint64_t file_size;
+    uint64_t struct_count;
+    uint64_t struct_offset;
+    uint64_t field_count;
+    uint64_t field_offset;
+    uint64_t site_count;
+    uint64_t site_offset;
+    uint64_t pointer_offset_count;
+    uint64_t pointer_offset_offset; //table of uint32_t offsets within one unit
+    uint64_t pointer_array_count;
+    uint64_t pointer_array_offset;
+    uint64_t object_count;
+    uint64_t object_offset;
+    uint64_t contents_size;
+    uint64_t contents_offset;
+} MldSnapshotHeader;
+
+typedef struct MldSnapshotStruct {
+    char structure_name[MAX_STRUCTURE_NAME_LENGTH];
+    uint32_t structure_size;
+    uint32_t field_count;
+    uint32_t first_field; //index into the field table
+    uint32_t pointer_offset_count;
+    uint32_t first_pointer_offset; //index into the pointer offset table
+    uint32_t pointer_array_count;
+    uint32_t first_pointer_array; //index into the pointer array table
+    uint32_t reserved;
+} MldSnapshotStruct;
+
+typedef struct MldSnapshotField {
+    char field_name[MAX_FIELD_NAME_LENGTH];
+    char nested_structure_name[MAX_STRUCTURE_NAME_LENGTH];
+    uint32_t data_type;
+    uint32_t size;
+    uint32_t offset;
+    uint32_t reserved;
+} MldSnapshotField;
+
+//dynamic pointer array of a structure, as MldPointerArrayField
+typedef struct MldSnapshotPointerArray {
+    uint32_t offset;
+    uint32_t length_offset;
+    uint32_t length_size;
+    uint32_t reserved;
+} MldSnapshotPointerArray;
+
+typedef struct MldSnapshotSite {
+    char file[MLD_SNAPSHOT_SITE_FILE_LENGTH]; //a longer file name is cut
+    uint32_t line;
+    uint32_t reserved;
+} MldSnapshotSite;
+
+typedef struct MldSnapshotObject {
+    uint64_t address; //object address in the snapshotted process
+    uint64_t contents; //offset of the object bytes, MLD_SNAPSHOT_NO_CONTENTS if they were not saved
+    uint32_t units;
+    uint32_t struct_index; //index into the structure table
+    uint8_t is_root;
+    uint8_t is_visited;
+    uint8_t reserved[2];
+    uint32_t site_index; //index into the site table, MLD_SNAPSHOT_NO_INDEX if the object has no allocation site
+} MldSnapshotObject;
+
+typedef struct MldSnapshot {
+    void *base;
+    size_t size;
+    MldSnapshotHeader *header;
+    MldSnapshotStruct *structs;
+    MldSnapshotField *fields;
+    MldSnapshotSite *sites;
+    uint32_t *pointer_offsets;
+    MldSnapshotPointerArray *pointer_arrays;
+    MldSnapshotObject *objects;
+} MldSnapshot;
+
+int mld_snapshot_write(ObjectDb *object_db, const char *path, MldBoolean with_contents); //returns 0 on success, -1 on failure
+
+int mld_snapshot_open(const char *path, MldSnapshot *snapshot); //returns 0 on success, -1 on failure
+
+void mld_snapshot_close(MldSnapshot *snapshot);
+
+MldSnapshotObject *mld_snapshot_lookup(MldSnapshot *snapshot, uint64_t address);
+
+unsigned long mld_snapshot_run_mld_algorithm(MldSnapshot *snapshot); //returns the number of leaked objects
+
+/*heap snapshot end*/
+
+/*heap diff begin*/
+
+/*
+an epoch is the set of live objects at one point in time, sorted by address
+it is captured from the live object db or taken from a mapped snapshot, both carry the allocation sites of TRACE builds
+two epochs are compared by a sorted merge over addresses, objects only in the later epoch count as growth,
+objects only in the earlier epoch as shrinkage, a reused address with another type or size counts as both
+*/
+
+typedef struct MldEpochEntry {
+    uint64_t address;
+    uint64_t bytes;
+    const char *structure_name;
+    const char *alloc_file;
+    unsigned int alloc_line;
+} MldEpochEntry;
+
+typedef struct MldHeapEpoch {
+    uint64_t count;
+    MldEpochEntry *entries;
+} MldHeapEpoch;
+
+//one row per structure type (alloc_file NULL) & one per allocation site (alloc_file set)
+typedef struct MldDiffRow {
+    const char *structure_name;
+    const char *alloc_file;
+    unsigned int alloc_line;
+    long count_delta;
+    long bytes_delta;
+} MldDiffRow;
+
+typedef struct MldHeapDiff {
+    unsigned long row_count;
+    MldDiffRow *rows; //sorted by bytes_delta, largest growth first
+} MldHeapDiff;
+
+int mld_epoch_capture(ObjectDb *object_db, MldHeapEpoch *epoch); //returns 0 on success, -1 on failure
+
+int mld_epoch_from_snapshot(MldSnapshot *snapshot, MldHeapEpoch *epoch); //epoch points into the mapping, keep snapshot open while it is used
+
+void mld_epoch_free(MldHeapEpoch *epoch);
+
+void mld_heap_diff(MldHeapEpoch *before, MldHeapEpoch *after, MldHeapDiff *diff);
+
+void print_heap_diff(MldHeapDiff *diff);
+
+void mld_heap_diff_free(MldHeapDiff *diff);
+
+/*heap diff end*/
+
+/*retained size begin*/
+
+/*
+retained size analysis over the object graph formed by the pointer fields of tracked objects
+a virtual root points to every root object, the dominator tree of that graph is computed (Cooper-Harvey-Kennedy),
+the retained size of an object is the size of the objects it dominates, i.e. what would be freed if it were unreachable
+objects unreachable from roots are not part of the tree, they are what report_leaked_objects reports
+nodes are radix sorted by address & children are resolved through an address slot directory, so the cost is a few linear passes,
+about 4s for 10M objects on one core, most of it reading the pointer fields of every object once
+*/
+
+typedef struct MldRetainer {
+    void *pointer;
+    StructureDbRecord *structure_record;
+    uint64_t retained_bytes; //including the object itself
+    uint64_t retained_objects;
+} MldRetainer;
+
+int mld_compute_top_retainers(ObjectDb *object_db, MldRetainer *top, int k); //fills top[0..k) largest first, returns how many were filled
+
+void print_top_retainers(MldRetainer *top, int count);
+
+/*retained size end*/
+
+/*leak clustering begin*/
+
+/*
+leaked objects grouped into clusters, to be called after run_mld_algorithm
+1. the graph of unvisited objects is condensed into strongly connected components (iterative Tarjan), so a cycle is one node
+2. a source component is one no other leaked object points to, it is where the leak lost its last reference
+3. a cluster is a weakly connected set of leaked objects, i.e. every source with everything it reaches,
+   sources which reach shared objects are one cluster, so clusters are disjoint & their bytes add up to the leak
+a leaked list head with its whole list, or a pair of best colleagues, is reported once with its size & bytes,
+entry is the first object of the largest source component of the cluster
+*/
+
+typedef struct MldLeakCluster {
+    void *entry_pointer;
+    StructureDbRecord *entry_structure;
+    uint64_t entry_count; //source components of the cluster
+    uint64_t object_count;
+    uint64_t bytes;
+} MldLeakCluster;
+
+long mld_cluster_leaked_objects(ObjectDb *object_db, MldLeakCluster **clusters); //returns cluster count, largest first, caller frees *clusters
+
+void report_leak_clusters(ObjectDb *object_db);
+
+/*leak clustering end*/
+
+/*leak statistics begin*/
+
+/*
+always-on counters, every thread updates only its own counter block, no lock & no shared cache line on the alloc/free path
+mld_get_stats sums the blocks of all threads, it never touches object db, so it is cheap enough to poll every second
+a thread which frees objects allocated by another thread has negative live counts, only the sum is meaningful
+peak_bytes is the highest live byte count seen by any mld_get_stats call, it is a sampled peak
+the first MLD_MAX_STATS_TYPES - 1 registered types get a slot each, all later types are summed in the last slot,
+which is then reported as MLD_STATS_OVERFLOW_NAME, so totals stay exact however many types there are
+*/
+
+#define MLD_MAX_STATS_TYPES 256
+#define MLD_STATS_OVERFLOW_SLOT (MLD_MAX_STATS_TYPES - 1)
+#define MLD_STATS_OVERFLOW_NAME "(other types)"
+
+typedef struct MldTypeStats {
+    const char *structure_name;
+    long live_objects; //object records, a multi unit object counts once
+    long live_bytes;
+} MldTypeStats;
+
+typedef struct MldStats {
+    unsigned long total_allocs;
+    unsigned long total_frees;
+    long live_objects;
+    long live_bytes;
+    long peak_bytes;
+    unsigned int type_count;
+    MldTypeStats types[MLD_MAX_STATS_TYPES]; //indexed by StructureDbRecord stats_index
+} MldStats;
+
+void mld_get_stats(MldStats *stats);
+
+void mld_stats_record_alloc(StructureDbRecord *struct_rec, unsigned int units);
+
+void mld_stats_record_free(StructureDbRecord *struct_rec, unsigned int units);
+
+void mld_stats_record_resize(StructureDbRecord *struct_rec, unsigned int old_units, unsigned int new_units);
+
+/*leak statistics end*/
+
 #endif
 
 #ifdef TRACE
@@ -167,12 +1052,17 @@ void report_leaked_objects(ObjectDb *object_db);
 #define xfree(structure_name, object_db, pointer) \
     xfree_with_trace(structure_name, object_db, pointer, __FILE__, __LINE__)
 
+#define xrealloc(object_db, structure_name, pointer, new_units) \
+    xrealloc_with_trace(object_db, structure_name, pointer, new_units, __FILE__, __LINE__)
+
 // Trace-enabled prototypes
 void *xcalloc_with_trace(ObjectDb *object_db, char *structure_name, int units, const char *file, int line);
 void add_object_to_object_db_with_trace(char *structure_name, ObjectDb *object_db, void *pointer, unsigned int units, StructureDbRecord *struct_rec, MldBoolean boolean_is_root, const char *file, int line);
 void mld_dump_object_rec_detail_with_trace(ObjectDbRecord *object_record, const char *file, int line);
 void *xmalloc_with_trace(ObjectDb *object_db, char *structure_name, int units, const char *file, int line);
 void xfree_with_trace(char *structure_name, ObjectDb *object_db, void *pointer, const char *file, int line);
+void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *obj_rec, const char *file, int line);
+void *xrealloc_with_trace(ObjectDb *object_db, char *structure_name, void *pointer, int new_units, const char *file, int line);
 
 #else // Non-trace version
 
@@ -181,5 +1071,7 @@ void add_object_to_object_db(char *structure_name, ObjectDb *object_db, void *po
 void mld_dump_object_rec_detail(ObjectDbRecord *object_record);
 void *xmalloc(ObjectDb *object_db, char *structure_name, int units);
 void xfree(char *structure_name, ObjectDb *object_db, void *pointer);
+void delete_object_record_from_object_db(ObjectDb *object_db, ObjectDbRecord *obj_rec);
+void *xrealloc(ObjectDb *object_db, char *structure_name, void *pointer, int new_units); //realloc rules, NULL allocates structure_name, 0 units frees
 
 #endif
\ No newline at end of file
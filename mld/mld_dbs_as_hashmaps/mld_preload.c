@@ -0,0 +1,219 @@
+//transparent malloc/calloc/realloc/free interposition for MLD, built as a shared library and loaded via LD_PRELOAD
+
+/*
+build & use:
+    gcc -shared -fPIC -O2 -o libmld.so mld_preload.c mld.c -ldl -lpthread
+    LD_PRELOAD=./libmld.so ./any_binary
+
+every block handed out by the libc allocator is recorded in a process wide object db as an untyped block,
+struct record "mld_untyped_block" has structure_size 1, so units of the object record is the block size in bytes
+at process exit a summary of blocks which were never freed is written to stderr
+
+reentrancy:
+1. dlsym itself may call calloc before the real allocator is resolved, such requests are served from a small static bootstrap arena
+2. the object db calls calloc/free for its own records, a per thread flag routes those calls straight to libc, so they are never tracked
+*/
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include "mld.h"
+
+#define MLD_BOOTSTRAP_ARENA_SIZE (64 * 1024)
+#define MLD_UNTYPED_BLOCK "mld_untyped_block"
+
+typedef void *(*malloc_fn)(size_t);
+typedef void *(*calloc_fn)(size_t, size_t);
+typedef void *(*realloc_fn)(void *, size_t);
+typedef void (*free_fn)(void *);
+typedef int (*posix_memalign_fn)(void **, size_t, size_t);
+typedef void *(*aligned_alloc_fn)(size_t, size_t);
+
+static malloc_fn real_malloc;
+static calloc_fn real_calloc;
+static realloc_fn real_realloc;
+static free_fn real_free;
+static posix_memalign_fn real_posix_memalign;
+static aligned_alloc_fn real_aligned_alloc;
+
+//bootstrap arena, bump allocated, never reclaimed
+static char bootstrap_arena[MLD_BOOTSTRAP_ARENA_SIZE] __attribute__((aligned(16)));
+static size_t bootstrap_used;
+
+static int mld_resolving;
+static int mld_ready;
+static __thread int mld_in_hook __attribute__((tls_model("initial-exec")));
+
+static pthread_mutex_t mld_lock = PTHREAD_MUTEX_INITIALIZER;
+static StructureDb mld_struct_db;
+static ObjectDb *mld_object_db;
+static StructureDbRecord mld_untyped_record = {.structure_name = MLD_UNTYPED_BLOCK, .structure_size = 1};
+
+static void *bootstrap_alloc(size_t size){
+    size = (size + 15) & ~(size_t)15;
+    if(bootstrap_used + size > MLD_BOOTSTRAP_ARENA_SIZE) return NULL;
+    void *pointer = bootstrap_arena + bootstrap_used;
+    bootstrap_used += size;
+    return pointer;
+}
+
+static int is_bootstrap_pointer(void *pointer){
+    return (char *)pointer >= bootstrap_arena && (char *)pointer < bootstrap_arena + MLD_BOOTSTRAP_ARENA_SIZE;
+}
+
+static void mld_preload_init(void){
+    if(mld_ready || mld_resolving) return;
+    mld_resolving = 1;
+
+    real_malloc = (malloc_fn)dlsym(RTLD_NEXT, "malloc");
+    real_calloc = (calloc_fn)dlsym(RTLD_NEXT, "calloc");
+    real_realloc = (realloc_fn)dlsym(RTLD_NEXT, "realloc");
+    real_free = (free_fn)dlsym(RTLD_NEXT, "free");
+    real_posix_memalign = (posix_memalign_fn)dlsym(RTLD_NEXT, "posix_memalign");
+    real_aligned_alloc = (aligned_alloc_fn)dlsym(RTLD_NEXT, "aligned_alloc");
+
+    //object db is taken from libc, the bootstrap arena is kept for what dlsym needs
+    mld_object_db = real_calloc(1, sizeof(ObjectDb));
+    assert(mld_object_db);
+    mld_object_db->struct_db = &mld_struct_db;
+    add_structure_to_database(&mld_struct_db, &mld_untyped_record);
+
+    mld_resolving = 0;
+    mld_ready = 1;
+}
+
+//record a new block in the object db, calls made by the object db itself pass through untracked
+static void mld_track(void *pointer, size_t size){
+    if(!pointer || !mld_ready) return;
+    pthread_mutex_lock(&mld_lock);
+    mld_in_hook = 1;
+    add_object_to_object_db(MLD_UNTYPED_BLOCK, mld_object_db, pointer, (unsigned int)size, &mld_untyped_record, MLD_FALSE);
+    mld_in_hook = 0;
+    pthread_mutex_unlock(&mld_lock);
+}
+
+static void mld_untrack(void *pointer){
+    if(!pointer || !mld_ready) return;
+    pthread_mutex_lock(&mld_lock);
+    mld_in_hook = 1;
+    ObjectDbRecord *obj_rec = object_db_lookup(MLD_UNTYPED_BLOCK, mld_object_db, pointer);
+    if(obj_rec) delete_object_record_from_object_db(mld_object_db, obj_rec);
+    mld_in_hook = 0;
+    pthread_mutex_unlock(&mld_lock);
+}
+
+void *malloc(size_t size){
+    if(!real_malloc){
+        mld_preload_init();
+        if(!real_malloc) return bootstrap_alloc(size);
+    }
+    if(mld_in_hook) return real_malloc(size);
+
+    void *pointer = real_malloc(size);
+    mld_track(pointer, size);
+    return pointer;
+}
+
+void *calloc(size_t nmemb, size_t size){
+    if(!real_calloc){
+        mld_preload_init();
+        //bootstrap arena is static storage, so it is already zeroed
+        if(!real_calloc) return bootstrap_alloc(nmemb * size);
+    }
+    if(mld_in_hook) return real_calloc(nmemb, size);
+
+    void *pointer = real_calloc(nmemb, size);
+    mld_track(pointer, nmemb * size);
+    return pointer;
+}
+
+void *realloc(void *pointer, size_t size){
+    if(!real_realloc) mld_preload_init();
+
+    if(is_bootstrap_pointer(pointer)){
+        //bootstrap blocks do not remember their size, copy what can be copied & hand out a real block
+        void *new_pointer = malloc(size);
+        if(new_pointer){
+            size_t available = (size_t)(bootstrap_arena + MLD_BOOTSTRAP_ARENA_SIZE - (char *)pointer);
+            memcpy(new_pointer, pointer, size < available ? size : available);
+        }
+        return new_pointer;
+    }
+    if(!real_realloc) return NULL;
+    if(mld_in_hook || !mld_ready) return real_realloc(pointer, size);
+
+    if(!pointer) return malloc(size);
+
+    //lock is held across the libc realloc, so a block released by it cannot be handed to another thread before the record moves
+    pthread_mutex_lock(&mld_lock);
+    mld_in_hook = 1;
+    void *new_pointer = real_realloc(pointer, size);
+    ObjectDbRecord *obj_rec = object_db_lookup(MLD_UNTYPED_BLOCK, mld_object_db, pointer);
+    if(!new_pointer){
+        if(!size && obj_rec) delete_object_record_from_object_db(mld_object_db, obj_rec);
+    }else if(obj_rec){
+        //existing record is resized in place, it is re-indexed only if the block moved
+        mld_stats_record_resize(obj_rec->structure_record, obj_rec->units, (unsigned int)size);
+        obj_rec->units = (unsigned int)size;
+        if(new_pointer != pointer) object_db_move_record(mld_object_db, obj_rec, new_pointer);
+    }else{
+        add_object_to_object_db(MLD_UNTYPED_BLOCK, mld_object_db, new_pointer, (unsigned int)size, &mld_untyped_record, MLD_FALSE);
+    }
+    mld_in_hook = 0;
+    pthread_mutex_unlock(&mld_lock);
+    return new_pointer;
+}
+
+void free(void *pointer){
+    if(!pointer || is_bootstrap_pointer(pointer)) return;
+    if(!real_free) mld_preload_init();
+    if(mld_in_hook){
+        real_free(pointer);
+        return;
+    }
+
+    mld_untrack(pointer);
+    real_free(pointer);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size){
+    if(!real_posix_memalign) mld_preload_init();
+    if(!real_posix_memalign) return ENOMEM;
+    if(mld_in_hook) return real_posix_memalign(memptr, alignment, size);
+
+    int rc = real_posix_memalign(memptr, alignment, size);
+    if(rc == 0) mld_track(*memptr, size);
+    return rc;
+}
+
+void *aligned_alloc(size_t alignment, size_t size){
+    if(!real_aligned_alloc) mld_preload_init();
+    if(!real_aligned_alloc) return NULL;
+    if(mld_in_hook) return real_aligned_alloc(alignment, size);
+
+    void *pointer = real_aligned_alloc(alignment, size);
+    mld_track(pointer, size);
+    return pointer;
+}
+
+//summary of untyped blocks which are still live at exit
+__attribute__((destructor))
+static void mld_preload_report(void){
+    if(!mld_ready) return;
+
+    pthread_mutex_lock(&mld_lock);
+    mld_in_hook = 1;
+
+    unsigned long blocks = 0, bytes = 0;
+    for(unsigned int i = 0; i < mld_object_db->table_size; i++){
+        for(ObjectDbRecord *obj_rec = mld_object_db->object_db_arr[i]; obj_rec; obj_rec = obj_rec->next){
+            blocks++;
+            bytes += obj_rec->units;
+        }
+    }
+    fprintf(stderr, "[MLD] %lu blocks (%lu bytes) still allocated at exit\n", blocks, bytes);
+
+    mld_in_hook = 0;
+    pthread_mutex_unlock(&mld_lock);
+}
@@ -0,0 +1,572 @@
+//offline header scanner, generates StructureDb registration code for every struct defined in the given headers
+
+/*
+build & use:
+    gcc -O2 -o mld_structgen mld_structgen.c mld.c -lm
+    ./mld_structgen -o mld_structs_gen.c appn_types.h other.h
+    gcc -o exe appn.c mld.c mld_structs_gen.c
+
+the generated file includes mld.h & the scanned headers, and defines mld_register_generated_structures()
+which registers every scanned structure & int/float/double, so it replaces init_primitive_data_types_support()
+
+sizes & offsets are not computed here, the generated tables use FIELD_SIZE/OFFSET_OFF, so the compiler lays them out,
+the scanner only has to classify each field:
+1. struct X *p, T *p where T is a scanned struct          OBJECT_pointer_TYPE, nested structure T
+2. void *p, char *p, T **p, function pointers, ...         VOID_pointer_TYPE
+   T *p[8], void *p[8], ...                                OBJECT_pointer_ARRAY_TYPE, every element is followed
+3. struct X s, T s[4] where T is a scanned struct          OBJECT_STRUCT_TYPE, nested structure T
+4. arithmetic types & their arrays                         MLD_DATA_TYPE_OF(type)
+5. any other typedef'd type                                UINT8_TYPE, scanned as opaque bytes
+bit fields, unions & inline anonymous struct definitions are skipped, the generated file lists them in a comment
+a header does not say which field holds the length of a T ** buffer, such fields stay VOID_pointer_TYPE,
+edit them to FIELD_INFO_DYNAMIC_ARRAY by hand if the buffer elements must be followed
+
+records are emitted sorted by name, together with seeds of a minimal perfect hash over the names,
+so struct_db_lookup is one slot probe & one compare, see mld_struct_db_install_perfect_hash
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "mld.h"
+
+#define MAX_TOKEN_LENGTH 128
+
+typedef enum {
+    TOKEN_IDENT,
+    TOKEN_NUMBER,
+    TOKEN_PUNCT,
+    TOKEN_STRING
+} TokenKind;
+
+typedef struct {
+    TokenKind kind;
+    char text[MAX_TOKEN_LENGTH];
+} Token;
+
+typedef struct {
+    char name[MAX_FIELD_NAME_LENGTH];
+    char kind[32]; //DataType enumerator, or MLD_DATA_TYPE_OF(...) for arithmetic fields
+    char c_type[MAX_STRUCTURE_NAME_LENGTH];
+    char nested[MAX_STRUCTURE_NAME_LENGTH];
+} ScannedField;
+
+typedef struct {
+    char tag[MAX_STRUCTURE_NAME_LENGTH]; //struct tag, empty for anonymous structs
+    char name[MAX_STRUCTURE_NAME_LENGTH]; //registered name, typedef name if there is one, else the tag
+    char c_type[MAX_STRUCTURE_NAME_LENGTH + 8]; //type used in sizeof/offsetof
+    int is_union;
+    int is_parsed; //members already read, a struct defined in several headers keeps its first definition
+    ScannedField *fields;
+    int field_count;
+    char skipped[1024]; //fields which could not be described
+} ScannedStruct;
+
+typedef struct {
+    char alias[MAX_STRUCTURE_NAME_LENGTH];
+    char tag[MAX_STRUCTURE_NAME_LENGTH];
+} TypedefAlias;
+
+static Token *tokens;
+static int token_count, token_capacity;
+static ScannedStruct *structs;
+static int struct_count, struct_capacity;
+static TypedefAlias *aliases;
+static int alias_count, alias_capacity;
+static int collect_only; //first pass only records struct names, so members can refer to structs defined later
+
+static void *xgrow(void *array, int *capacity, size_t element_size){
+    *capacity = *capacity ? *capacity * 2 : 64;
+    array = realloc(array, *capacity * element_size);
+    if(!array){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    return array;
+}
+
+static void push_token(TokenKind kind, const char *start, size_t length){
+    if(token_count == token_capacity) tokens = xgrow(tokens, &token_capacity, sizeof(Token));
+    if(length >= MAX_TOKEN_LENGTH) length = MAX_TOKEN_LENGTH - 1;
+    tokens[token_count].kind = kind;
+    memcpy(tokens[token_count].text, start, length);
+    tokens[token_count].text[length] = '\0';
+    token_count++;
+}
+
+//tokenizer, drops comments, preprocessor lines & literal contents
+static void tokenize(const char *src){
+    const char *p = src;
+    int line_start = 1;
+
+    while(*p){
+        if(*p == '\n'){
+            line_start = 1;
+            p++;
+            continue;
+        }
+        if(*p == ' ' || *p == '\t' || *p == '\r' || *p == '\f' || *p == '\v'){
+            p++;
+            continue;
+        }
+        if(p[0] == '/' && p[1] == '/'){
+            while(*p && *p != '\n') p++;
+            continue;
+        }
+        if(p[0] == '/' && p[1] == '*'){
+            p += 2;
+            while(*p && !(p[0] == '*' && p[1] == '/')) p++;
+            if(*p) p += 2;
+            continue;
+        }
+        if(*p == '#' && line_start){
+            //preprocessor directive, honour line continuations
+            while(*p && *p != '\n'){
+                if(p[0] == '\\' && p[1] == '\n') p++;
+                p++;
+            }
+            continue;
+        }
+        line_start = 0;
+
+        if(*p == '"' || *p == '\''){
+            char quote = *p++;
+            while(*p && *p != quote){
+                if(*p == '\\' && p[1]) p++;
+                p++;
+            }
+            if(*p) p++;
+            push_token(TOKEN_STRING, "\"\"", 2);
+            continue;
+        }
+        if(*p == '_' || (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z')){
+            const char *start = p;
+            while(*p == '_' || (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || (*p >= '0' && *p <= '9')) p++;
+            push_token(TOKEN_IDENT, start, p - start);
+            continue;
+        }
+        if(*p >= '0' && *p <= '9'){
+            const char *start = p;
+            while((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') || *p == '.') p++;
+            push_token(TOKEN_NUMBER, start, p - start);
+            continue;
+        }
+        push_token(TOKEN_PUNCT, p, 1);
+        p++;
+    }
+}
+
+static int token_is(int i, const char *text){
+    return i < token_count && strcmp(tokens[i].text, text) == 0;
+}
+
+//index of the token closing the bracket opened at i
+static int matching_close(int i){
+    const char *open = tokens[i].text;
+    const char *close = open[0] == '{' ? "}" : open[0] == '(' ? ")" : "]";
+    int depth = 0;
+    for(; i<token_count; i++){
+        if(token_is(i, open)) depth++;
+        else if(token_is(i, close) && --depth == 0) return i;
+    }
+    return token_count - 1;
+}
+
+static ScannedStruct *find_struct_by_tag(const char *tag){
+    for(int i = 0; i<struct_count; i++){
+        if(structs[i].tag[0] && strcmp(structs[i].tag, tag) == 0) return &structs[i];
+    }
+    return NULL;
+}
+
+static ScannedStruct *find_struct_by_name(const char *name){
+    for(int i = 0; i<struct_count; i++){
+        if(strcmp(structs[i].name, name) == 0) return &structs[i];
+    }
+    for(int i = 0; i<alias_count; i++){
+        if(strcmp(aliases[i].alias, name) == 0) return find_struct_by_tag(aliases[i].tag);
+    }
+    return NULL;
+}
+
+static int is_qualifier(const char *text){
+    return !strcmp(text, "const") || !strcmp(text, "volatile") || !strcmp(text, "restrict") ||
+           !strcmp(text, "static") || !strcmp(text, "extern") || !strcmp(text, "register") ||
+           !strcmp(text, "_Atomic") || !strcmp(text, "__restrict");
+}
+
+static int is_arithmetic_keyword(const char *text){
+    static const char *keywords[] = {"unsigned", "signed", "short", "long", "int", "char", "float", "double", "_Bool", "void"};
+    for(unsigned int i = 0; i<sizeof(keywords) / sizeof(keywords[0]); i++){
+        if(!strcmp(text, keywords[i])) return 1;
+    }
+    return 0;
+}
+
+static int is_arithmetic_typedef(const char *text){
+    static const char *names[] = {"size_t", "ssize_t", "ptrdiff_t", "intptr_t", "uintptr_t", "bool", "off_t",
+        "int8_t", "int16_t", "int32_t", "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t"};
+    for(unsigned int i = 0; i<sizeof(names) / sizeof(names[0]); i++){
+        if(!strcmp(text, names[i])) return 1;
+    }
+    return 0;
+}
+
+static void note_skipped(ScannedStruct *scanned, const char *what){
+    size_t used = strlen(scanned->skipped);
+    snprintf(scanned->skipped + used, sizeof(scanned->skipped) - used, "%s%s", used ? ", " : "", what);
+}
+
+static void add_field(ScannedStruct *scanned, const char *name, const char *kind, const char *c_type, const char *nested){
+    scanned->fields = realloc(scanned->fields, (scanned->field_count + 1) * sizeof(ScannedField));
+    if(!scanned->fields){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    ScannedField *field = &scanned->fields[scanned->field_count++];
+    snprintf(field->name, sizeof(field->name), "%s", name);
+    snprintf(field->kind, sizeof(field->kind), "%s", kind);
+    snprintf(field->c_type, sizeof(field->c_type), "%s", c_type);
+    snprintf(field->nested, sizeof(field->nested), "%s", nested);
+}
+
+//one member declaration, tokens [begin, end) without the ';'
+static void parse_member(ScannedStruct *scanned, int begin, int end){
+    int i = begin;
+
+    for(int j = begin; j<end; j++){
+        if(token_is(j, "{")){
+            //inline definition, the member name follows the closing brace
+            int close = matching_close(j);
+            note_skipped(scanned, close + 1 < end && tokens[close + 1].kind == TOKEN_IDENT ? tokens[close + 1].text : "anonymous member");
+            return;
+        }
+    }
+
+    //function pointer, type (*name)(args)
+    for(int j = begin; j + 2 < end; j++){
+        if(token_is(j, "(") && token_is(j + 1, "*") && tokens[j + 2].kind == TOKEN_IDENT){
+            add_field(scanned, tokens[j + 2].text, "VOID_pointer_TYPE", "", "");
+            return;
+        }
+    }
+
+    while(i < end && is_qualifier(tokens[i].text)) i++;
+
+    //base type
+    char base[MAX_STRUCTURE_NAME_LENGTH] = "";
+    ScannedStruct *base_struct = NULL;
+    int base_is_struct = 0, base_is_union = 0, base_is_arithmetic = 0;
+
+    if(token_is(i, "struct") || token_is(i, "union") || token_is(i, "enum")){
+        base_is_struct = token_is(i, "struct");
+        base_is_union = token_is(i, "union");
+        base_is_arithmetic = token_is(i, "enum");
+        snprintf(base, sizeof(base), "%.8s %.100s", tokens[i].text, i + 1 < end ? tokens[i + 1].text : "");
+        if(base_is_struct && i + 1 < end){
+            base_struct = find_struct_by_tag(tokens[i + 1].text);
+            //forward declared struct not defined in the scanned headers, nested by its tag
+            snprintf(base, sizeof(base), "%s", base_struct ? base_struct->name : tokens[i + 1].text);
+        }
+        i += 2;
+    }else if(i < end && is_arithmetic_keyword(tokens[i].text)){
+        base_is_arithmetic = 1;
+        while(i < end && (is_arithmetic_keyword(tokens[i].text) || is_qualifier(tokens[i].text))){
+            if(!is_qualifier(tokens[i].text)){
+                size_t used = strlen(base);
+                //a spelling longer than base can not name a real type, the rest of it is dropped
+                int wrote = snprintf(base + used, sizeof(base) - used, "%s%s", used ? " " : "", tokens[i].text);
+                if(wrote < 0 || (size_t)wrote >= sizeof(base) - used){
+                    base[used] = '\0';
+                    break;
+                }
+            }
+            i++;
+        }
+    }else if(i < end && tokens[i].kind == TOKEN_IDENT){
+        snprintf(base, sizeof(base), "%s", tokens[i].text);
+        base_struct = find_struct_by_name(tokens[i].text);
+        if(base_struct){
+            base_is_struct = 1;
+            snprintf(base, sizeof(base), "%s", base_struct->name);
+            base_is_union = base_struct->is_union;
+        }
+        base_is_arithmetic = is_arithmetic_typedef(tokens[i].text);
+        i++;
+    }else{
+        note_skipped(scanned, "unparsed member");
+        return;
+    }
+    int base_is_void = !strcmp(base, "void");
+
+    //declarators, separated by commas
+    while(i < end){
+        int depth = 0;
+        char name[MAX_FIELD_NAME_LENGTH] = "";
+        int is_bitfield = 0, is_array = 0;
+
+        for(; i<end && !token_is(i, ","); i++){
+            if(token_is(i, "*")) depth++;
+            else if(token_is(i, "[")){
+                i = matching_close(i);
+                is_array = 1;
+            }
+            else if(token_is(i, ":")) is_bitfield = 1;
+            else if(tokens[i].kind == TOKEN_IDENT && !is_qualifier(tokens[i].text) && !is_bitfield)
+                snprintf(name, sizeof(name), "%s", tokens[i].text);
+        }
+        i++;
+
+        if(!name[0]) continue;
+        if(is_bitfield){
+            note_skipped(scanned, name);
+            continue;
+        }
+
+        if(depth == 1 && is_array){
+            add_field(scanned, name, "OBJECT_pointer_ARRAY_TYPE", "", base_is_struct && !base_is_union ? base : "");
+        }else if(depth >= 2 && is_array){
+            add_field(scanned, name, "OBJECT_pointer_ARRAY_TYPE", "", "");
+        }else if(depth >= 2 || (depth == 1 && (!base_is_struct || base_is_union))){
+            add_field(scanned, name, "VOID_pointer_TYPE", "", "");
+        }else if(depth == 1){
+            add_field(scanned, name, "OBJECT_pointer_TYPE", "", base);
+        }else if(base_is_void){
+            note_skipped(scanned, name);
+        }else if(base_is_union){
+            note_skipped(scanned, name);
+        }else if(base_is_struct){
+            add_field(scanned, name, "OBJECT_STRUCT_TYPE", "", base);
+        }else if(base_is_arithmetic){
+            add_field(scanned, name, "", base, "");
+        }else{
+            add_field(scanned, name, "UINT8_TYPE", "", "");
+        }
+    }
+}
+
+//struct or union definition, i is the struct/union keyword, returns index of the closing brace
+static int parse_definition(int i, int is_typedef){
+    int is_union = token_is(i, "union");
+    int open = i + 1;
+    char tag[MAX_STRUCTURE_NAME_LENGTH] = "";
+
+    if(tokens[open].kind == TOKEN_IDENT){
+        snprintf(tag, sizeof(tag), "%s", tokens[open].text);
+        open++;
+    }
+    int close = matching_close(open);
+
+    //typedef name, first plain declarator after the closing brace
+    char alias[MAX_STRUCTURE_NAME_LENGTH] = "";
+    if(is_typedef && close + 1 < token_count && tokens[close + 1].kind == TOKEN_IDENT)
+        snprintf(alias, sizeof(alias), "%s", tokens[close + 1].text);
+
+    if(!tag[0] && !alias[0]) return close;
+
+    ScannedStruct *scanned = alias[0] ? find_struct_by_name(alias) : find_struct_by_tag(tag);
+    if(collect_only){
+        if(scanned) return close;
+        if(struct_count == struct_capacity) structs = xgrow(structs, &struct_capacity, sizeof(ScannedStruct));
+        scanned = &structs[struct_count++];
+        memset(scanned, 0, sizeof(ScannedStruct));
+        scanned->is_union = is_union;
+        snprintf(scanned->tag, sizeof(scanned->tag), "%s", tag);
+        snprintf(scanned->name, sizeof(scanned->name), "%s", alias[0] ? alias : tag);
+        if(alias[0]) snprintf(scanned->c_type, sizeof(scanned->c_type), "%s", alias);
+        else snprintf(scanned->c_type, sizeof(scanned->c_type), "%s %s", is_union ? "union" : "struct", tag);
+        return close;
+    }
+    if(!scanned || scanned->is_parsed) return close;
+    scanned->is_parsed = 1;
+
+    //members, split on ';' at brace depth 0 of the body
+    int begin = open + 1, depth = 0;
+    for(int j = open + 1; j<close; j++){
+        if(token_is(j, "{") || token_is(j, "(")) depth++;
+        else if(token_is(j, "}") || token_is(j, ")")) depth--;
+        else if(token_is(j, ";") && depth == 0){
+            if(j > begin) parse_member(scanned, begin, j);
+            begin = j + 1;
+        }
+    }
+    return close;
+}
+
+static void scan_tokens(void){
+    for(int i = 0; i<token_count; i++){
+        if(!token_is(i, "struct") && !token_is(i, "union")) continue;
+
+        int is_typedef = i > 0 && token_is(i - 1, "typedef");
+        if(token_is(i + 1, "{") || (tokens[i + 1].kind == TOKEN_IDENT && token_is(i + 2, "{"))){
+            i = parse_definition(i, is_typedef);
+        }else if(collect_only && is_typedef && tokens[i + 1].kind == TOKEN_IDENT && i + 2 < token_count && tokens[i + 2].kind == TOKEN_IDENT){
+            //typedef struct tag alias;
+            if(alias_count == alias_capacity) aliases = xgrow(aliases, &alias_capacity, sizeof(TypedefAlias));
+            snprintf(aliases[alias_count].tag, MAX_STRUCTURE_NAME_LENGTH, "%s", tokens[i + 1].text);
+            snprintf(aliases[alias_count].alias, MAX_STRUCTURE_NAME_LENGTH, "%s", tokens[i + 2].text);
+            alias_count++;
+        }
+    }
+
+    if(!collect_only) return;
+
+    //a struct defined by tag & typedef'd separately is registered under its typedef name
+    for(int i = 0; i<alias_count; i++){
+        ScannedStruct *scanned = find_struct_by_tag(aliases[i].tag);
+        if(scanned && !strcmp(scanned->name, scanned->tag)){
+            snprintf(scanned->name, sizeof(scanned->name), "%s", aliases[i].alias);
+            snprintf(scanned->c_type, sizeof(scanned->c_type), "%s", aliases[i].alias);
+        }
+    }
+}
+
+static int compare_struct_names(const void *a, const void *b){
+    return strcmp(((const ScannedStruct *)a)->name, ((const ScannedStruct *)b)->name);
+}
+
+static char *read_file(const char *path){
+    FILE *file = fopen(path, "rb");
+    if(!file){
+        fprintf(stderr, "mld_structgen: cannot open %s\n", path);
+        exit(1);
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *src = malloc(size + 1);
+    if(!src){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    size_t read = fread(src, 1, size, file);
+    src[read] = '\0';
+    fclose(file);
+    return src;
+}
+
+static void emit(FILE *out, int argc, char **argv, int first_header){
+    static const char *primitives[] = {"int", "float", "double"};
+    int primitive_count = sizeof(primitives) / sizeof(primitives[0]);
+
+    //drop unions, add the primitives, sort by name
+    int count = 0;
+    for(int i = 0; i<struct_count; i++){
+        if(!structs[i].is_union) structs[count++] = structs[i];
+    }
+    struct_count = count;
+    for(int i = 0; i<primitive_count; i++){
+        if(find_struct_by_name(primitives[i])) continue;
+        if(struct_count == struct_capacity) structs = xgrow(structs, &struct_capacity, sizeof(ScannedStruct));
+        memset(&structs[struct_count], 0, sizeof(ScannedStruct));
+        snprintf(structs[struct_count].name, MAX_STRUCTURE_NAME_LENGTH, "%s", primitives[i]);
+        snprintf(structs[struct_count].c_type, MAX_STRUCTURE_NAME_LENGTH, "%s", primitives[i]);
+        struct_count++;
+    }
+    qsort(structs, struct_count, sizeof(ScannedStruct), compare_struct_names);
+
+    fprintf(out, "//generated by mld_structgen, do not edit\n\n#include \"mld.h\"\n");
+    for(int i = first_header; i<argc; i++) fprintf(out, "#include \"%s\"\n", argv[i]);
+    fprintf(out, "\n");
+
+    for(int s = 0; s<struct_count; s++){
+        ScannedStruct *scanned = &structs[s];
+        if(scanned->skipped[0]) fprintf(out, "//%s: not described: %s\n", scanned->name, scanned->skipped);
+        if(!scanned->field_count) continue;
+
+        fprintf(out, "static FieldInfo mld_gen_%s_fields[] = {\n", scanned->name);
+        for(int f = 0; f<scanned->field_count; f++){
+            ScannedField *field = &scanned->fields[f];
+            fprintf(out, "    {.field_name = \"%s\", ", field->name);
+            if(field->kind[0]) fprintf(out, ".data_type = %s, ", field->kind);
+            else fprintf(out, ".data_type = MLD_DATA_TYPE_OF(%s), ", field->c_type);
+            fprintf(out, ".size = FIELD_SIZE(%s, %s), .offset = OFFSET_OFF(%s, %s), .nested_structure_name = \"%s\"}%s\n",
+                    scanned->c_type, field->name, scanned->c_type, field->name, field->nested,
+                    f + 1 < scanned->field_count ? "," : "");
+        }
+        fprintf(out, "};\n\n");
+    }
+
+    fprintf(out, "static StructureDbRecord mld_gen_records[] = {\n");
+    for(int s = 0; s<struct_count; s++){
+        ScannedStruct *scanned = &structs[s];
+        if(scanned->field_count)
+            fprintf(out, "    {.structure_name = \"%s\", .structure_size = sizeof(%s),\n"
+                         "     .field_count = sizeof(mld_gen_%s_fields) / sizeof(FieldInfo), .fields = mld_gen_%s_fields}",
+                    scanned->name, scanned->c_type, scanned->name, scanned->name);
+        else
+            fprintf(out, "    {.structure_name = \"%s\", .structure_size = sizeof(%s)}", scanned->name, scanned->c_type);
+        fprintf(out, "%s\n", s + 1 < struct_count ? "," : "");
+    }
+    fprintf(out, "};\n\n");
+
+    char **names = malloc(struct_count * sizeof(char *));
+    if(!names){
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+    for(int s = 0; s<struct_count; s++) names[s] = structs[s].name;
+
+    int *slots;
+    uint32_t slot_count, *seeds, bucket_count;
+    mld_build_perfect_hash(names, struct_count, &slots, &slot_count, &seeds, &bucket_count);
+
+    fprintf(out, "static StructureDbRecord *mld_gen_slots[%u] = {\n", slot_count);
+    for(uint32_t s = 0; s<slot_count; s++){
+        if(slots[s] < 0) fprintf(out, "    NULL");
+        else fprintf(out, "    &mld_gen_records[%d]", slots[s]);
+        fprintf(out, "%s\n", s + 1 < slot_count ? "," : "");
+    }
+    fprintf(out, "};\n\nstatic const uint32_t mld_gen_seeds[%u] = {", bucket_count);
+    for(uint32_t b = 0; b<bucket_count; b++) fprintf(out, "%s%s%u", b ? "," : "", b % 16 ? " " : "\n    ", seeds[b]);
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out,
+        "void mld_register_generated_structures(StructureDb *struct_db){\n"
+        "    for(unsigned int i = 0; i<sizeof(mld_gen_records) / sizeof(StructureDbRecord); i++){\n"
+        "        if(add_structure_to_database(struct_db, &mld_gen_records[i])){\n"
+        "            assert(0);\n"
+        "        }\n"
+        "    }\n"
+        "    mld_struct_db_install_perfect_hash(struct_db, mld_gen_slots, %u, mld_gen_seeds, %u);\n"
+        "}\n", slot_count, bucket_count);
+
+    free(names);
+    free(slots);
+    free(seeds);
+}
+
+int main(int argc, char **argv){
+    const char *out_path = NULL;
+    int first_header = 1;
+
+    if(argc > 2 && !strcmp(argv[1], "-o")){
+        out_path = argv[2];
+        first_header = 3;
+    }
+    if(first_header >= argc){
+        fprintf(stderr, "usage: %s [-o output.c] header.h...\n", argv[0]);
+        return 1;
+    }
+
+    //all headers are tokenized into one stream, then scanned twice, names first & members second
+    for(int i = first_header; i<argc; i++){
+        char *src = read_file(argv[i]);
+        tokenize(src);
+        free(src);
+    }
+    collect_only = 1;
+    scan_tokens();
+    collect_only = 0;
+    scan_tokens();
+
+    FILE *out = out_path ? fopen(out_path, "w") : stdout;
+    if(!out){
+        fprintf(stderr, "mld_structgen: cannot write %s\n", out_path);
+        return 1;
+    }
+    emit(out, argc, argv, first_header);
+    if(out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,48 @@
+//shared helpers of the MLD tests, every test is a standalone program, tests/run_tests.sh builds & runs them all
+
+#ifndef MLD_TEST_H
+#define MLD_TEST_H
+
+#include <fcntl.h>
+#include <unistd.h>
+#include "../mld.h"
+
+#define CHECK(cond)                                                                   \
+    do{                                                                               \
+        if(!(cond)){                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);  \
+            exit(1);                                                                  \
+        }                                                                             \
+    }while(0)
+
+static inline StructureDb *mld_test_struct_db(void){
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    CHECK(struct_db);
+    init_primitive_data_types_support(struct_db);
+    return struct_db;
+}
+
+static inline ObjectDb *mld_test_object_db(StructureDb *struct_db){
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    CHECK(object_db);
+    object_db->struct_db = struct_db;
+    return object_db;
+}
+
+//leaked objects found by the last scan, the per object report has one record for each
+static inline long mld_test_leaked(ObjectDb *object_db){
+    int fd = open("/dev/null", O_WRONLY);
+    CHECK(fd >= 0);
+    long leaked = mld_write_leak_report(object_db, fd, MLD_REPORT_JSONL, MLD_FALSE, MLD_FALSE);
+    close(fd);
+    CHECK(leaked >= 0);
+    return leaked;
+}
+
+//overwrites the dead stack below the caller, so values left by returned frames can not act as roots
+static __attribute__((noinline, unused)) void mld_test_scrub_stack(void){
+    volatile char scrub[16384];
+    memset((char *)scrub, 0, sizeof(scrub));
+}
+
+#endif
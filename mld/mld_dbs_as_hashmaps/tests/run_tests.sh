@@ -0,0 +1,38 @@
+#!/bin/sh
+#builds & runs every tests/test_*.c against mld.c, run from mld/mld_dbs_as_hashmaps
+#a test asks for extra compiler flags with a "//mld-test-cflags: ..." line, e.g. -DTRACE
+#a "//mld-test-structgen: header.h ..." line runs mld_structgen on the headers & links the generated source in
+
+CC=${CC:-gcc}
+OUT=${OUT:-/tmp/mld_tests}
+mkdir -p "$OUT"
+
+failed=0
+for src in tests/test_*.c; do
+    name=$(basename "$src" .c)
+    cflags=$(sed -n 's,^//mld-test-cflags: *,,p' "$src")
+    headers=$(sed -n 's,^//mld-test-structgen: *,,p' "$src")
+    generated=
+    if [ -n "$headers" ]; then
+        generated="$OUT/${name}_structs.c"
+        if ! $CC -O2 -o "$OUT/mld_structgen" mld_structgen.c mld.c -lm || ! "$OUT/mld_structgen" -o "$generated" $headers; then
+            echo "FAIL $name (structgen)"
+            failed=$((failed + 1))
+            continue
+        fi
+        cflags="$cflags -I."
+    fi
+    if ! $CC -O2 -g $cflags -o "$OUT/$name" "$src" $generated mld.c -lm -lpthread -ldl; then
+        echo "FAIL $name (build)"
+        failed=$((failed + 1))
+        continue
+    fi
+    if "$OUT/$name" > "$OUT/$name.log" 2>&1; then
+        echo "PASS $name"
+    else
+        echo "FAIL $name, output in $OUT/$name.log"
+        grep -h "check failed" "$OUT/$name.log" || tail -n 5 "$OUT/$name.log"
+        failed=$((failed + 1))
+    fi
+done
+exit $failed
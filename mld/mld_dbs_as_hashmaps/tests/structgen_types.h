@@ -0,0 +1,38 @@
+//types scanned by mld_structgen for tests/test_structgen.c
+
+#ifndef STRUCTGEN_TYPES_H
+#define STRUCTGEN_TYPES_H
+
+#include <stdint.h>
+
+typedef struct Point {
+    double x, y;
+} Point;
+
+struct Shape;
+
+typedef struct Segment {
+    char label[7];
+    Point ends[2];
+    struct Segment *next;
+    struct Shape *shape; //defined after its first use
+    void (*draw)(struct Segment *segment);
+    unsigned flags : 3;
+    uint32_t color;
+} Segment;
+
+struct Shape {
+    const char *name;
+    Segment *first, *last;
+    Point origin;
+    Segment *corners[4];
+    Segment **extra;
+    union {
+        int as_int;
+        float as_float;
+    } value;
+    unsigned long area;
+    float scale;
+};
+
+#endif
@@ -0,0 +1,53 @@
+//xmalloc_batch & xfree_batch, including a batch which runs out of memory part way
+
+#include <sys/resource.h>
+#include "mld_test.h"
+
+typedef struct Item {
+    struct Item *next;
+    int value;
+} Item;
+
+typedef struct Huge {
+    char bytes[64 << 20];
+} Huge;
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo item_fields[] = {
+        FIELD_INFO(Item, next, OBJECT_pointer_TYPE, Item),
+        FIELD_INFO(Item, value, INT32_TYPE, 0)
+    };
+    static FieldInfo huge_fields[] = {
+        FIELD_INFO(Huge, bytes, CHAR_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Item, item_fields);
+    REGISTER_STRUCTURE(struct_db, Huge, huge_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    static void *items[1000];
+    CHECK(xmalloc_batch(object_db, "Item", 1000, items) == 1000);
+    CHECK(object_db->count == 1000);
+    for(int i = 0; i < 1000; i++){
+        ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, items[i]);
+        CHECK(obj_rec && obj_rec->units == 1 && obj_rec->pointer == items[i]);
+    }
+    xfree_batch(object_db, items + 1, 999);
+    CHECK(object_db->count == 1);
+    CHECK(object_db_lookup(NULL, object_db, items[0]));
+    CHECK(!object_db_lookup(NULL, object_db, items[1]));
+
+    //address space for a few 64 MiB objects only, the batch stops short & keeps what it got
+    struct rlimit limit = {512ul << 20, 512ul << 20};
+    CHECK(!setrlimit(RLIMIT_AS, &limit));
+    static void *huge[64];
+    int allocated = xmalloc_batch(object_db, "Huge", 64, huge);
+    CHECK(allocated > 0 && allocated < 64);
+    CHECK(object_db->count == 1 + allocated);
+    for(int i = 0; i < allocated; i++) CHECK(object_db_lookup(NULL, object_db, huge[i]));
+    xfree_batch(object_db, huge, allocated);
+    CHECK(object_db->count == 1);
+
+    printf("batch ok\n");
+    return 0;
+}
@@ -0,0 +1,95 @@
+//candidate filter, every kernel keeps exactly the words the filter definition keeps & never drops a live object address
+
+#include <sys/wait.h>
+#include "mld_test.h"
+
+#define OBJECTS 4096
+#define WORDS (OBJECTS * 8)
+
+//survivor definition of mld.h, in range, no align_mask bit set & its page bit set
+static int reference_keeps(const MldCandidateFilter *filter, uintptr_t word){
+    if(word < filter->low || word > filter->high || (word & filter->align_mask)) return 0;
+    uintptr_t page = (word - filter->low) >> filter->page_shift;
+    return (filter->page_bitmap[page >> 6] >> (page & 63)) & 1;
+}
+
+static void check_kernel(const char *kernel){
+    setenv("MLD_FILTER_KERNEL", kernel, 1);
+    StructureDb *struct_db = mld_test_struct_db();
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    static void *objects[OBJECTS];
+    for(int i = 0; i < OBJECTS; i++) objects[i] = xmalloc(object_db, "int", i % 64 ? 4 : 1 << 16);
+    MldCandidateFilter filter;
+    mld_candidate_filter_build(object_db, &filter);
+    CHECK(filter.high);
+
+    //object addresses, interior & misaligned words, words just outside the range & random words
+    static uintptr_t words[WORDS], out[WORDS], expected[WORDS];
+    unsigned long long seed = 88172645463325252ULL;
+    for(int i = 0; i < WORDS; i++){
+        uintptr_t object = (uintptr_t)objects[i % OBJECTS];
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        switch(i % 8){
+            case 0: case 1: words[i] = object; break;
+            case 2: words[i] = object + 1; break;
+            case 3: words[i] = object + 8 * (seed % 4096); break;
+            case 4: words[i] = filter.low - 16; break;
+            case 5: words[i] = filter.high + 16; break;
+            case 6: words[i] = (uintptr_t)seed; break;
+            default: words[i] = filter.low + (seed % (filter.high - filter.low + 1)); break;
+        }
+    }
+    size_t expected_count = 0;
+    for(int i = 0; i < WORDS; i++) if(reference_keeps(&filter, words[i])) expected[expected_count++] = words[i];
+
+    CHECK(!strcmp(mld_filter_kernel_name(), kernel));
+    //every start & tail length around the vector widths
+    for(size_t start = 0; start < 9; start++){
+        for(size_t count = 0; count < 40; count++){
+            size_t kept = mld_filter_candidates(&filter, words + start, count, out), reference = 0;
+            for(size_t i = start; i < start + count; i++){
+                if(!reference_keeps(&filter, words[i])) continue;
+                CHECK(reference < kept && out[reference] == words[i]);
+                reference++;
+            }
+            CHECK(kept == reference);
+        }
+    }
+    size_t kept = mld_filter_candidates(&filter, words, WORDS, out);
+    CHECK(kept == expected_count && !memcmp(out, expected, kept * sizeof(uintptr_t)));
+    for(int i = 0; i < WORDS; i += 8) CHECK(reference_keeps(&filter, words[i]));
+
+    //in place, as the marker filters its own candidate buffer
+    kept = mld_filter_candidates(&filter, words, WORDS, words);
+    CHECK(kept == expected_count && !memcmp(words, expected, kept * sizeof(uintptr_t)));
+
+    mld_candidate_filter_free(&filter);
+    CHECK(mld_filter_candidates(&filter, expected, expected_count, out) == 0);
+}
+
+int main(void){
+    //the kernel is picked once per process, so each one is checked in a child of its own
+    const char *kernels[] = {"scalar", "sse4.2", "avx2"};
+    for(int k = 0; k < 3; k++){
+#if defined(__x86_64__)
+        __builtin_cpu_init();
+        if(k == 1 && !__builtin_cpu_supports("sse4.2")) continue;
+        if(k == 2 && !__builtin_cpu_supports("avx2")) continue;
+#else
+        if(k) continue;
+#endif
+        pid_t pid = fork();
+        CHECK(pid >= 0);
+        if(!pid){
+            check_kernel(kernels[k]);
+            exit(0);
+        }
+        int status;
+        CHECK(waitpid(pid, &status, 0) == pid);
+        CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    return 0;
+}
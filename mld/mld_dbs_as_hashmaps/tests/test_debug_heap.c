@@ -0,0 +1,92 @@
+//debug heap, redzone overflow & underflow, use after free in quarantine, guard page faults & quarantine bounds
+
+#include <signal.h>
+#include <sys/wait.h>
+#include "mld_test.h"
+
+typedef struct Small {
+    char bytes[48];
+} Small;
+
+typedef struct Big {
+    char bytes[65536];
+} Big;
+
+//runs write in a child, returns 1 if the child died of SIGSEGV
+static int faults(volatile char *address){
+    pid_t pid = fork();
+    CHECK(pid >= 0);
+    if(!pid){
+        *address = 1;
+        _exit(0);
+    }
+    int status;
+    CHECK(waitpid(pid, &status, 0) == pid);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo small_fields[] = {FIELD_INFO(Small, bytes, CHAR_TYPE, 0)};
+    REGISTER_STRUCTURE(struct_db, Small, small_fields);
+    static FieldInfo big_fields[] = {FIELD_INFO(Big, bytes, CHAR_TYPE, 0)};
+    REGISTER_STRUCTURE(struct_db, Big, big_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    mld_enable_debug_heap(object_db, 16384, 1 << 20);
+    MldDebugHeap *debug_heap = object_db->debug_heap;
+
+    //in bounds writes are never reported
+    Small *small = xmalloc(object_db, "Small", 2);
+    memset(small, 0x5A, 2 * sizeof(Small));
+    CHECK(mld_check_redzones(object_db) == 0);
+    xfree("Small", object_db, small);
+    mld_drain_quarantine(object_db);
+    CHECK(debug_heap->corruptions == 0);
+
+    //overflow found on xfree, underflow found by a scan
+    small = xmalloc(object_db, "Small", 1);
+    ((char *)small)[sizeof(Small)] = 1;
+    xfree("Small", object_db, small);
+    CHECK(debug_heap->corruptions == 1);
+    small = xmalloc(object_db, "Small", 1);
+    ((char *)small)[-1] = 1;
+    CHECK(mld_check_redzones(object_db) == 1);
+    run_mld_algorithm(object_db);
+    CHECK(debug_heap->corruptions >= 2);
+    xfree("Small", object_db, small);
+    unsigned long corruptions = debug_heap->corruptions;
+
+    //write after free found when the block leaves quarantine
+    small = xmalloc(object_db, "Small", 2);
+    xfree("Small", object_db, small);
+    small->bytes[5] = 7;
+    mld_drain_quarantine(object_db);
+    CHECK(debug_heap->corruptions == corruptions + 1);
+
+    //the redzone follows a block resized by xrealloc
+    small = xcalloc(object_db, "Small", 1);
+    small = xrealloc(object_db, "Small", small, 3);
+    memset(small, 0x5A, 3 * sizeof(Small));
+    CHECK(mld_check_redzones(object_db) == 0);
+    ((char *)small)[3 * sizeof(Small)] = 1;
+    xfree("Small", object_db, small);
+    CHECK(debug_heap->corruptions == corruptions + 2);
+
+    //guarded blocks fault one byte past the end & after free
+    Big *big = xmalloc(object_db, "Big", 1);
+    big->bytes[sizeof(Big) - 1] = 1;
+    CHECK(!faults(big->bytes + sizeof(Big) - 1));
+    CHECK(faults(big->bytes + sizeof(Big)));
+    xfree("Big", object_db, big);
+    CHECK(faults(big->bytes + 10));
+
+    //quarantine stays within its slot & byte bounds
+    for(int i = 0; i < 5000; i++) xfree("Small", object_db, xmalloc(object_db, "Small", 1));
+    CHECK(debug_heap->quarantine_count <= MLD_QUARANTINE_SLOTS);
+    CHECK(debug_heap->quarantine_bytes <= debug_heap->quarantine_limit);
+    mld_drain_quarantine(object_db);
+    CHECK(debug_heap->quarantine_count == 0 && debug_heap->quarantine_bytes == 0);
+    CHECK(debug_heap->corruptions == corruptions + 2);
+    CHECK(object_db->count == 0);
+    return 0;
+}
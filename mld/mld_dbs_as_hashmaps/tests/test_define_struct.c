@@ -0,0 +1,75 @@
+//MLD_DEFINE_STRUCT, the generated FieldInfo table & pointer map must match the layout the compiler chose
+
+#include <stddef.h>
+#include "mld_test.h"
+
+MLD_DEFINE_STRUCT(Inner,
+    FIELD(char, tag),
+    FIELD(double, weight));
+
+MLD_DEFINE_STRUCT(Node,
+    FIELD(char, name, 13),
+    PTR(Node, next),
+    FIELD(unsigned int, id),
+    NESTED(Inner, inner),
+    VOID_PTR(data),
+    FIELD(float, score),
+    PTR(Inner, owner));
+
+static FieldInfo *field(StructureDbRecord *struct_rec, const char *field_name){
+    for(unsigned int i = 0; i < struct_rec->field_count; i++){
+        if(strcmp(struct_rec->fields[i].field_name, field_name) == 0) return &struct_rec->fields[i];
+    }
+    return NULL;
+}
+
+#define CHECK_FIELD(struct_rec, s, member, type, nested)                                          \
+    do{                                                                                          \
+        FieldInfo *info = field(struct_rec, #member);                                            \
+        CHECK(info && info->offset == offsetof(s, member) && info->size == sizeof(((s *)0)->member)); \
+        CHECK(info->data_type == (type) && strcmp(info->nested_structure_name, nested) == 0);  \
+    }while(0)
+
+static int pointer_bit(StructureDbRecord *struct_rec, size_t offset){
+    size_t word = offset / sizeof(void *);
+    return (struct_rec->pointer_map[word / 64] >> (word % 64)) & 1;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    MLD_REGISTER_DEFINED_STRUCTURE(struct_db, Inner);
+    MLD_REGISTER_DEFINED_STRUCTURE(struct_db, Node);
+
+    StructureDbRecord *inner_rec = struct_db_lookup(struct_db, "Inner");
+    CHECK(inner_rec && inner_rec->structure_size == sizeof(Inner) && inner_rec->field_count == 2);
+    CHECK_FIELD(inner_rec, Inner, tag, CHAR_TYPE, "");
+    CHECK_FIELD(inner_rec, Inner, weight, DOUBLE_TYPE, "");
+
+    StructureDbRecord *node_rec = struct_db_lookup(struct_db, "Node");
+    CHECK(node_rec && node_rec->structure_size == sizeof(Node) && node_rec->field_count == 7);
+    CHECK_FIELD(node_rec, Node, name, CHAR_TYPE, "");
+    CHECK(field(node_rec, "name")->size == 13);
+    CHECK_FIELD(node_rec, Node, next, OBJECT_pointer_TYPE, "Node");
+    CHECK_FIELD(node_rec, Node, id, UINT32_TYPE, "");
+    CHECK_FIELD(node_rec, Node, inner, OBJECT_STRUCT_TYPE, "Inner");
+    CHECK_FIELD(node_rec, Node, data, VOID_pointer_TYPE, "");
+    CHECK_FIELD(node_rec, Node, score, FLOAT_TYPE, "");
+    CHECK_FIELD(node_rec, Node, owner, OBJECT_pointer_TYPE, "Inner");
+
+    //pointer map has exactly the pointer fields set
+    CHECK(inner_rec->pointer_map[0] == 0);
+    int pointers = 0;
+    for(size_t offset = 0; offset < sizeof(Node); offset += sizeof(void *)) pointers += pointer_bit(node_rec, offset);
+    CHECK(pointers == 3);
+    CHECK(pointer_bit(node_rec, offsetof(Node, next)));
+    CHECK(pointer_bit(node_rec, offsetof(Node, data)));
+    CHECK(pointer_bit(node_rec, offsetof(Node, owner)));
+
+    //the members are ordinary struct members
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    Node *node = xcalloc(object_db, "Node", 1);
+    node->next = node;
+    node->inner.weight = 2.5;
+    CHECK(object_db_lookup(NULL, object_db, node)->structure_record == node_rec);
+    return 0;
+}
@@ -0,0 +1,79 @@
+//exit hook, the report follows buffered stdio, earlier exit handlers still run & the exit status is kept in both modes
+
+#include <sys/wait.h>
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+static void earlier_handler(void){
+    printf("earlier handler\n");
+}
+
+//child leaks three objects & exits with status 3, everything it writes goes to one pipe
+static void exiting_child(int fd, unsigned int flags){
+    CHECK(dup2(fd, STDOUT_FILENO) == STDOUT_FILENO);
+    CHECK(atexit(earlier_handler) == 0);
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    mld_report_at_exit(object_db, STDOUT_FILENO, MLD_REPORT_JSONL, flags);
+    for(int i = 0; i < 3; i++) xcalloc(object_db, "Node", 1);
+    mld_test_scrub_stack();
+    printf("application output\n");
+    exit(3);
+}
+
+//output of the child in order, the exit status must be 3
+static char *run_child(unsigned int flags){
+    int fds[2];
+    CHECK(pipe(fds) == 0);
+    pid_t pid = fork();
+    CHECK(pid >= 0);
+    if(!pid){
+        close(fds[0]);
+        exiting_child(fds[1], flags);
+    }
+    close(fds[1]);
+    static char output[65536];
+    size_t size = 0;
+    ssize_t got;
+    while((got = read(fds[0], output + size, sizeof(output) - 1 - size)) > 0) size += got;
+    output[size] = 0;
+    close(fds[0]);
+    int status;
+    CHECK(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 3);
+    return output;
+}
+
+static int count(const char *haystack, const char *needle){
+    int found = 0;
+    for(const char *at = strstr(haystack, needle); at; at = strstr(at + 1, needle)) found++;
+    return found;
+}
+
+int main(void){
+    //per object report, the report comes after the application output & before the handler registered earlier
+    char *output = run_child(0);
+    char *report = strstr(output, "Node");
+    CHECK(report);
+    CHECK(strstr(output, "application output") < report);
+    CHECK(strstr(output, "earlier handler") > report);
+    CHECK(count(output, "{\"type\":\"Node\"") == 3);
+
+    //fast mode, one per type record & the handler registered earlier still runs
+    output = run_child(MLD_EXIT_FAST);
+    report = strstr(output, "Node");
+    CHECK(report);
+    CHECK(strstr(output, "application output") < report);
+    CHECK(strstr(output, "earlier handler") > report);
+    CHECK(count(output, "Node") == 1);
+    return 0;
+}
@@ -0,0 +1,71 @@
+//frozen struct db, lookups return the registered records, so settings made after the freeze reach older objects too
+
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+#define BEFORE 100
+#define AFTER 100
+
+static int finalized;
+
+static void count_finalized(void *object, StructureDbRecord *structure_record, unsigned int units){
+    finalized++;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    StructureDbRecord *node_rec = struct_db_lookup(struct_db, "Node");
+    StructureDbRecord *int_rec = struct_db_lookup(struct_db, "int");
+    CHECK(node_rec && int_rec);
+
+    for(int i = 0; i < BEFORE; i++) xcalloc(object_db, "Node", 1);
+    int *number = xcalloc(object_db, "int", 1);
+    CHECK(object_db_lookup(NULL, object_db, number)->structure_record == int_rec);
+
+    mld_struct_db_freeze(struct_db);
+    CHECK(struct_db->frozen && struct_db->perfect_slots);
+    CHECK(struct_db_lookup(struct_db, "Node") == node_rec);
+    CHECK(struct_db_lookup(struct_db, "int") == int_rec);
+    CHECK(!struct_db_lookup(struct_db, "Missing"));
+
+    //the bucket chains still hold the same records
+    int chained = 0;
+    for(int i = 0; i < TABLE_SIZE; i++){
+        for(StructureDbRecord *record = struct_db->structutre_db_arr[i]; record; record = record->next){
+            CHECK(struct_db_lookup(struct_db, record->structure_name) == record);
+            chained++;
+        }
+    }
+    CHECK(chained == struct_db->count);
+
+    static StructureDbRecord late = {0};
+    strncpy(late.structure_name, "Late", MAX_STRUCTURE_NAME_LENGTH);
+    late.structure_size = sizeof(int);
+    CHECK(add_structure_to_database(struct_db, &late) == -1);
+    CHECK(!struct_db_lookup(struct_db, "Late"));
+
+    //objects allocated before & after the freeze share one record
+    for(int i = 0; i < AFTER; i++){
+        Node *node = xcalloc(object_db, "Node", 1);
+        CHECK(object_db_lookup(NULL, object_db, node)->structure_record == node_rec);
+    }
+
+    //a finalizer set after the freeze runs on every reclaimed object
+    mld_set_finalizer(struct_db, "Node", count_finalized);
+    CHECK(node_rec->finalizer == count_finalized);
+    mld_test_scrub_stack();
+    mld_collect(object_db);
+    mld_finish_sweep(object_db);
+    CHECK(finalized == BEFORE + AFTER);
+    return 0;
+}
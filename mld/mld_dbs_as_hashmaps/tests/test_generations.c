@@ -0,0 +1,90 @@
+//generational scanning, minor scans see young leaks & stores logged by MLD_STORE, only full scans see old leaks
+
+#include "mld_test.h"
+
+#define OLD_OBJECTS 1023
+
+typedef struct Node {
+    struct Node *left, *right, *young;
+    int value;
+} Node;
+
+static ObjectDbRecord *record(ObjectDb *object_db, void *pointer){
+    ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, pointer);
+    CHECK(obj_rec);
+    return obj_rec;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, left, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, right, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, young, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    //complete binary tree from one root, promoted by two scans
+    static Node *tree[OLD_OBJECTS];
+    for(int i = 0; i < OLD_OBJECTS; i++){
+        tree[i] = xcalloc(object_db, "Node", 1);
+        if(i && i % 2) tree[(i - 1) / 2]->left = tree[i];
+        else if(i) tree[(i - 1) / 2]->right = tree[i];
+    }
+    set_dynamic_object_as_root("Node", object_db, tree[0]);
+    mld_enable_generations(object_db, 2, 1000);
+    CHECK(object_db->generations->young_count == OLD_OBJECTS);
+    mld_run_minor_scan(object_db);
+    mld_run_minor_scan(object_db);
+    CHECK(object_db->generations->young_count == 0);
+    for(int i = 0; i < OLD_OBJECTS; i++) CHECK(record(object_db, tree[i])->is_old);
+
+    //young objects, one stored into an old node, one chained from a young root & one leaked
+    Node *stored = xcalloc(object_db, "Node", 1);
+    MLD_STORE(object_db, tree[700], tree[700]->young, stored);
+    Node *young_root = xcalloc(object_db, "Node", 1);
+    set_dynamic_object_as_root("Node", object_db, young_root);
+    Node *chained = xcalloc(object_db, "Node", 1);
+    young_root->young = chained;
+    Node *leaked = xcalloc(object_db, "Node", 1);
+    CHECK(object_db->generations->young_count == 4);
+
+    mld_run_minor_scan(object_db);
+    CHECK(record(object_db, stored)->is_visited);
+    CHECK(record(object_db, young_root)->is_visited && record(object_db, chained)->is_visited);
+    CHECK(!record(object_db, leaked)->is_visited);
+    CHECK(mld_test_leaked(object_db) == 1);
+
+    //an old subtree dropped without a barrier, a minor scan keeps the old state, a full scan finds it
+    Node *dropped = tree[1]->left;
+    tree[1]->left = NULL;
+    mld_run_minor_scan(object_db);
+    CHECK(record(object_db, dropped)->is_visited);
+    CHECK(mld_test_leaked(object_db) == 1);
+    mld_run_full_scan(object_db);
+    CHECK(!record(object_db, dropped)->is_visited);
+    CHECK(mld_test_leaked(object_db) == 1 + 255);
+    tree[1]->left = dropped;
+    mld_run_full_scan(object_db);
+    CHECK(mld_test_leaked(object_db) == 1);
+
+    //an object promoted while it points to a young object enters the remembered set
+    xfree("Node", object_db, leaked);
+    Node *parent = xcalloc(object_db, "Node", 1);
+    MLD_STORE(object_db, tree[3], tree[3]->young, parent);
+    mld_run_minor_scan(object_db);
+    Node *child = xcalloc(object_db, "Node", 1);
+    parent->young = child;
+    mld_run_minor_scan(object_db);
+    CHECK(record(object_db, parent)->is_old && !record(object_db, child)->is_old);
+    tree[3]->young = NULL; //parent is still reached by the last full scan, child only through the remembered set
+    mld_run_minor_scan(object_db);
+    CHECK(record(object_db, child)->is_visited);
+
+    mld_disable_generations(object_db);
+    run_mld_algorithm(object_db);
+    CHECK(!record(object_db, parent)->is_visited && !record(object_db, child)->is_visited);
+    return 0;
+}
@@ -0,0 +1,104 @@
+//heap diff, growth per structure & per allocation site, sites survive a snapshot, long sites are printed whole & aligned
+//mld-test-cflags: -DTRACE
+
+#include "mld_test.h"
+
+#define LONG_SITE "src/subsystem/with/a/deeply/nested/path/allocations_of_nodes.c"
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+//defined last, its #line directive renames the rest of the file
+static void *allocate_at_long_site(ObjectDb *object_db);
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    void *kept = xmalloc(object_db, "Node", 1), *dropped = xmalloc(object_db, "Node", 2);
+    MldHeapEpoch before, after;
+    CHECK(mld_epoch_capture(object_db, &before) == 0);
+    for(int i = 0; i < 3; i++) CHECK(allocate_at_long_site(object_db));
+    xfree("Node", object_db, dropped);
+    CHECK(mld_epoch_capture(object_db, &after) == 0);
+
+    MldHeapDiff diff;
+    mld_heap_diff(&before, &after, &diff);
+    int site_rows = 0, type_rows = 0;
+    for(unsigned long i = 0; i < diff.row_count; i++){
+        MldDiffRow *row = &diff.rows[i];
+        CHECK(!strcmp(row->structure_name, "Node"));
+        if(!row->alloc_file){
+            type_rows++;
+            CHECK(row->count_delta == 3 - 1 && row->bytes_delta == (long)sizeof(Node) * (3 - 2));
+        }else if(!strcmp(row->alloc_file, LONG_SITE)){
+            site_rows++;
+            CHECK(row->alloc_line == 4242 && row->count_delta == 3 && row->bytes_delta == 3 * (long)sizeof(Node));
+        }
+    }
+    CHECK(type_rows == 1 && site_rows == 1);
+
+    //a snapshot carries the allocation sites, diffing against it gives the same rows
+    const char *path = "/tmp/mld_test_heap_diff.bin";
+    CHECK(mld_snapshot_write(object_db, path, MLD_FALSE) == 0);
+    MldSnapshot snapshot;
+    CHECK(mld_snapshot_open(path, &snapshot) == 0);
+    CHECK(snapshot.header->site_count == 2);
+    MldHeapEpoch mapped;
+    CHECK(mld_epoch_from_snapshot(&snapshot, &mapped) == 0);
+    MldHeapDiff mapped_diff;
+    mld_heap_diff(&before, &mapped, &mapped_diff);
+    CHECK(mapped_diff.row_count == diff.row_count);
+    for(unsigned long i = 0; i < diff.row_count; i++){
+        MldDiffRow *row = &diff.rows[i], *mapped_row = &mapped_diff.rows[i];
+        CHECK(row->count_delta == mapped_row->count_delta && row->bytes_delta == mapped_row->bytes_delta);
+        CHECK(row->alloc_line == mapped_row->alloc_line && !row->alloc_file == !mapped_row->alloc_file);
+        if(row->alloc_file) CHECK(!strcmp(row->alloc_file, mapped_row->alloc_file));
+    }
+    mld_heap_diff_free(&mapped_diff);
+    mld_epoch_free(&mapped);
+    mld_snapshot_close(&snapshot);
+    unlink(path);
+
+    //the printed table keeps the whole site & every line has the same width
+    fflush(stdout);
+    FILE *table = tmpfile();
+    CHECK(table);
+    int saved_stdout = dup(1);
+    CHECK(saved_stdout >= 0 && dup2(fileno(table), 1) == 1);
+    print_heap_diff(&diff);
+    fflush(stdout);
+    CHECK(dup2(saved_stdout, 1) == 1);
+    close(saved_stdout);
+
+    rewind(table);
+    char line[512];
+    size_t width = 0;
+    int lines = 0, found = 0;
+    while(fgets(line, sizeof(line), table)){
+        if(!width) width = strlen(line);
+        CHECK(strlen(line) == width);
+        found |= strstr(line, LONG_SITE ":4242 ") != NULL;
+        lines++;
+    }
+    CHECK(found && lines == 2 + (int)diff.row_count);
+    fclose(table);
+
+    mld_heap_diff_free(&diff);
+    mld_epoch_free(&before);
+    mld_epoch_free(&after);
+    xfree("Node", object_db, kept);
+    return 0;
+}
+
+static void *allocate_at_long_site(ObjectDb *object_db){
+#line 4242 LONG_SITE
+    return xmalloc(object_db, "Node", 1);
+}
@@ -0,0 +1,74 @@
+//large object arena, mappings for large blocks, mremap on resize, unmap on free & marking through large objects
+
+#include "mld_test.h"
+
+#define SLOTS (1 << 18) //2 MiB of pointers
+#define NODES 1024
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+typedef struct Slot {
+    Node *node;
+} Slot;
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    static FieldInfo slot_fields[] = {FIELD_INFO(Slot, node, OBJECT_pointer_TYPE, Node)};
+    REGISTER_STRUCTURE(struct_db, Slot, slot_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    mld_enable_large_arena(object_db, 0, MLD_TRUE);
+    MldLargeArena *arena = object_db->large_arena;
+
+    //small blocks stay with libc
+    Node *nodes[NODES];
+    for(int i = 0; i < NODES; i++) nodes[i] = xcalloc(object_db, "Node", 1);
+    CHECK(arena->count == 0);
+
+    //a large block is its own zero filled, huge page aligned mapping
+    Slot *slots = xcalloc(object_db, "Slot", SLOTS);
+    CHECK(arena->count == 1 && arena->mapped_bytes >= SLOTS * sizeof(Slot));
+    CHECK(((uintptr_t)slots & (MLD_HUGE_PAGE_SIZE - 1)) == 0);
+    for(int i = 0; i < SLOTS; i++) CHECK(!slots[i].node);
+
+    //every pointer of a large object is followed, across the chunks the marker scans it in
+    for(int i = 0; i < SLOTS; i += SLOTS / (NODES / 2)) slots[i].node = nodes[i / (SLOTS / (NODES / 2))];
+    slots[SLOTS - 1].node = nodes[NODES - 1];
+    set_dynamic_object_as_root("Slot", object_db, slots);
+    run_mld_algorithm(object_db);
+    for(int i = 0; i < NODES; i++)
+        CHECK(object_db_lookup(NULL, object_db, nodes[i])->is_visited == (i < NODES / 2 || i == NODES - 1));
+    CHECK(mld_test_leaked(object_db) == NODES / 2 - 1);
+
+    //growing keeps the contents & zero fills the tail, the record follows the block
+    slots = xrealloc(object_db, "Slot", slots, 3 * SLOTS);
+    CHECK(arena->count == 1);
+    CHECK(slots[0].node == nodes[0] && slots[SLOTS - 1].node == nodes[NODES - 1]);
+    for(int i = SLOTS; i < 3 * SLOTS; i++) CHECK(!slots[i].node);
+    ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, slots);
+    CHECK(obj_rec && obj_rec->units == 3 * SLOTS && obj_rec->is_root);
+    run_mld_algorithm(object_db);
+    CHECK(mld_test_leaked(object_db) == NODES / 2 - 1);
+
+    //shrinking keeps the head
+    slots = xrealloc(object_db, "Slot", slots, SLOTS / 2);
+    CHECK(arena->count == 1 && slots[0].node == nodes[0]);
+    CHECK(object_db_lookup(NULL, object_db, slots)->units == SLOTS / 2);
+
+    //xfree unmaps at once
+    Slot *other = xmalloc(object_db, "Slot", SLOTS);
+    CHECK(arena->count == 2);
+    xfree("Slot", object_db, slots);
+    xfree("Slot", object_db, other);
+    CHECK(arena->count == 0 && arena->mapped_bytes == 0);
+    for(int i = 0; i < NODES; i++) xfree("Node", object_db, nodes[i]);
+    CHECK(object_db->count == 0);
+    return 0;
+}
@@ -0,0 +1,92 @@
+//leak clusters, a leaked list or cycle is one cluster with its sources as entries, shared leaked objects join clusters
+
+#include "mld_test.h"
+
+#define LIST 100
+
+typedef struct Node {
+    struct Node *next, *other;
+    int value;
+} Node;
+
+static Node *node(ObjectDb *object_db, Node *next, Node *other){
+    Node *n = xcalloc(object_db, "Node", 1);
+    n->next = next;
+    n->other = other;
+    return n;
+}
+
+static MldLeakCluster *find(MldLeakCluster *clusters, long count, uint64_t objects){
+    MldLeakCluster *found = NULL;
+    for(long i = 0; i < count; i++){
+        if(clusters[i].object_count != objects) continue;
+        CHECK(!found); //sizes are picked to be unique
+        found = &clusters[i];
+    }
+    CHECK(found);
+    return found;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, other, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    //reachable objects, one of them pointed to by a leak, are in no cluster
+    Node *live = node(object_db, node(object_db, NULL, NULL), NULL);
+    set_dynamic_object_as_root("Node", object_db, live);
+
+    //a leaked list of LIST objects, its head is the only source
+    Node *list = NULL;
+    for(int i = 0; i < LIST; i++) list = node(object_db, list, NULL);
+    //two heads sharing a tail of 3
+    Node *shared = node(object_db, node(object_db, node(object_db, NULL, NULL), NULL), NULL);
+    Node *first_head = node(object_db, shared, NULL), *second_head = node(object_db, shared, live);
+    //a cycle of 4 feeding a tail of 3, the cycle is the source
+    Node *tail = node(object_db, node(object_db, node(object_db, NULL, NULL), NULL), NULL);
+    Node *cycle[4];
+    for(int i = 0; i < 4; i++) cycle[i] = node(object_db, NULL, NULL);
+    for(int i = 0; i < 4; i++) cycle[i]->next = cycle[(i + 1) % 4];
+    cycle[2]->other = tail;
+    //a pair of best colleagues & a lone object
+    Node *pair = node(object_db, NULL, NULL);
+    pair->next = node(object_db, pair, NULL);
+    node(object_db, NULL, NULL);
+
+    run_mld_algorithm(object_db);
+    long leaked = mld_test_leaked(object_db);
+    CHECK(leaked == LIST + 5 + 7 + 2 + 1);
+
+    MldLeakCluster *clusters = NULL;
+    long count = mld_cluster_leaked_objects(object_db, &clusters);
+    CHECK(count == 5);
+    uint64_t objects = 0;
+    for(long i = 0; i < count; i++){
+        objects += clusters[i].object_count;
+        CHECK(clusters[i].bytes == clusters[i].object_count * sizeof(Node));
+        CHECK(clusters[i].entry_structure && !strcmp(clusters[i].entry_structure->structure_name, "Node"));
+        if(i) CHECK(clusters[i - 1].bytes >= clusters[i].bytes);
+    }
+    CHECK(objects == (uint64_t)leaked);
+
+    MldLeakCluster *cluster = find(clusters, count, LIST);
+    CHECK(cluster->entry_pointer == list && cluster->entry_count == 1);
+    cluster = find(clusters, count, 5);
+    CHECK((cluster->entry_pointer == first_head || cluster->entry_pointer == second_head) && cluster->entry_count == 2);
+    cluster = find(clusters, count, 7);
+    int in_cycle = 0;
+    for(int i = 0; i < 4; i++) in_cycle |= cluster->entry_pointer == cycle[i];
+    CHECK(in_cycle && cluster->entry_count == 1);
+    cluster = find(clusters, count, 2);
+    CHECK((cluster->entry_pointer == pair || cluster->entry_pointer == pair->next) && cluster->entry_count == 1);
+    CHECK(find(clusters, count, 1)->entry_count == 1);
+    free(clusters);
+
+    report_leak_clusters(object_db);
+    return 0;
+}
@@ -0,0 +1,49 @@
+//aggregated leak report, one record per structure type however many types are registered
+
+#include "mld_test.h"
+
+#define TYPE_COUNT 300
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    char name[MAX_STRUCTURE_NAME_LENGTH];
+    for(int i = 0; i < TYPE_COUNT; i++){
+        StructureDbRecord *record = calloc(1, sizeof(StructureDbRecord));
+        CHECK(record);
+        snprintf(record->structure_name, sizeof(record->structure_name), "Type%d", i);
+        record->structure_size = 8 * (i + 1);
+        CHECK(!add_structure_to_database(struct_db, record));
+    }
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    //type i leaks i % 3 + 1 objects
+    for(int i = 0; i < TYPE_COUNT; i++){
+        snprintf(name, sizeof(name), "Type%d", i);
+        for(int n = 0; n <= i % 3; n++) xcalloc(object_db, name, 1);
+    }
+    run_mld_algorithm(object_db);
+    CHECK(mld_test_leaked(object_db) == object_db->count);
+
+    FILE *report = tmpfile();
+    CHECK(report);
+    CHECK(mld_write_leak_report(object_db, fileno(report), MLD_REPORT_CSV, MLD_TRUE, MLD_FALSE) == TYPE_COUNT);
+    rewind(report);
+
+    char line[256];
+    int seen[TYPE_COUNT] = {0};
+    CHECK(fgets(line, sizeof(line), report) && !strcmp(line, "type,leaked_objects,leaked_bytes\n"));
+    while(fgets(line, sizeof(line), report)){
+        int type;
+        unsigned long objects, bytes;
+        CHECK(sscanf(line, "Type%d,%lu,%lu", &type, &objects, &bytes) == 3);
+        CHECK(type >= 0 && type < TYPE_COUNT && !seen[type]);
+        seen[type] = 1;
+        CHECK(objects == (unsigned long)(type % 3 + 1));
+        CHECK(bytes == objects * 8 * (type + 1));
+    }
+    for(int i = 0; i < TYPE_COUNT; i++) CHECK(seen[i]);
+    fclose(report);
+
+    printf("leak report ok\n");
+    return 0;
+}
@@ -0,0 +1,96 @@
+//mark loop, reachability of a random graph with multi unit objects, cycles & deep chains matches a plain bfs
+
+#include "mld_test.h"
+
+#define OBJECTS 20000
+#define ARRAY_UNITS 8
+
+typedef struct Node {
+    struct Node *left, *right;
+    int value;
+} Node;
+
+static unsigned long long seed = 88172645463325252ULL;
+
+static unsigned int next_random(void){
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return (unsigned int)(seed >> 11);
+}
+
+static Node *objects[OBJECTS];
+static int units[OBJECTS];
+
+static int object_index(Node *pointer){
+    for(int lo = 0, hi = OBJECTS - 1; lo <= hi;){
+        int mid = (lo + hi) / 2;
+        if(objects[mid] == pointer) return mid;
+        if(objects[mid] < pointer) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+static int compare_objects(const void *a, const void *b){
+    Node *x = *(Node * const *)a, *y = *(Node * const *)b;
+    return (x > y) - (x < y);
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, left, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, right, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    for(int i = 0; i < OBJECTS; i++) objects[i] = xcalloc(object_db, "Node", i % 97 ? 1 : ARRAY_UNITS);
+    qsort(objects, OBJECTS, sizeof(Node *), compare_objects);
+    for(int i = 0; i < OBJECTS; i++) units[i] = object_db_lookup(NULL, object_db, objects[i])->units;
+
+    //sparse random edges, a long chain through every 7th object & a few self loops & duplicate edges
+    for(int i = 0; i < OBJECTS; i++){
+        for(int u = 0; u < units[i]; u++){
+            if(next_random() % 4 == 0) objects[i][u].left = objects[next_random() % OBJECTS];
+            if(next_random() % 4 == 0) objects[i][u].right = objects[i][u].left;
+        }
+        if(i % 7 == 0 && i + 7 < OBJECTS) objects[i][units[i] - 1].right = objects[i + 7];
+        if(i % 501 == 0) objects[i]->left = objects[i];
+    }
+    for(int r = 0; r < 5; r++) set_dynamic_object_as_root("Node", object_db, objects[next_random() % OBJECTS]);
+    set_dynamic_object_as_root("Node", object_db, objects[0]);
+
+    //reference bfs over the same edges
+    static unsigned char reached[OBJECTS];
+    static int queue[OBJECTS];
+    int head = 0, tail = 0;
+    for(int i = 0; i < OBJECTS; i++){
+        if(object_db_lookup(NULL, object_db, objects[i])->is_root){
+            reached[i] = 1;
+            queue[tail++] = i;
+        }
+    }
+    while(head < tail){
+        int i = queue[head++];
+        for(int u = 0; u < units[i]; u++){
+            Node *children[2] = {objects[i][u].left, objects[i][u].right};
+            for(int c = 0; c < 2; c++){
+                int j = children[c] ? object_index(children[c]) : -1;
+                if(j < 0 || reached[j]) continue;
+                reached[j] = 1;
+                queue[tail++] = j;
+            }
+        }
+    }
+    CHECK(tail > OBJECTS / 10 && tail < OBJECTS);
+
+    for(int pass = 0; pass < 2; pass++){
+        run_mld_algorithm(object_db);
+        for(int i = 0; i < OBJECTS; i++) CHECK(object_db_lookup(NULL, object_db, objects[i])->is_visited == reached[i]);
+        CHECK(mld_test_leaked(object_db) == OBJECTS - tail);
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+//object db index, grows with the number of records & keeps every record reachable by its address
+
+#include "mld_test.h"
+
+#define OBJECTS 200000
+
+static int free_errors;
+
+static void count_free_error(const MldFreeError *error, void *user_data){
+    free_errors++;
+}
+
+static int is_power_of_two(unsigned int value){
+    return value && !(value & (value - 1));
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    mld_set_free_error_handler(object_db, count_free_error, NULL);
+
+    //nothing is tracked yet, lookups & frees must cope with the missing table
+    int untracked;
+    CHECK(!object_db_lookup(NULL, object_db, &untracked));
+    void *stray = &untracked;
+    xfree_batch(object_db, &stray, 1);
+    CHECK(free_errors == 1);
+    run_mld_algorithm(object_db);
+
+    static int *objects[OBJECTS];
+    for(int i = 0; i < OBJECTS; i++){
+        objects[i] = xmalloc(object_db, "int", 1);
+        *objects[i] = i;
+        CHECK(object_db->table_size >= (unsigned int)object_db->count && is_power_of_two(object_db->table_size));
+    }
+    for(int i = 0; i < OBJECTS; i++){
+        ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, objects[i]);
+        CHECK(obj_rec && obj_rec->pointer == objects[i]);
+    }
+
+    //a moved record is found at its new address only
+    int *old = objects[0];
+    objects[0] = xrealloc(object_db, "int", objects[0], 4096);
+    CHECK(object_db_lookup(NULL, object_db, objects[0]));
+    CHECK(objects[0] == old || !object_db_lookup(NULL, object_db, old));
+
+    for(int i = 0; i < OBJECTS; i += 2) xfree("int", object_db, objects[i]);
+    CHECK(object_db->count == OBJECTS / 2);
+    for(int i = 0; i < OBJECTS; i++) CHECK(!object_db_lookup(NULL, object_db, objects[i]) == !(i & 1));
+
+    //a pending sweep walks buckets by index, the table keeps its size until the sweep is done
+    mld_collect(object_db);
+    unsigned int size = object_db->table_size;
+    for(int i = 0; i < OBJECTS; i += 2) objects[i] = xmalloc(object_db, "int", 1);
+    if(object_db->sweep.pending) CHECK(object_db->table_size == size);
+    mld_finish_sweep(object_db);
+    CHECK(object_db->count == OBJECTS / 2);
+    xmalloc(object_db, "int", 1);
+    CHECK(object_db->table_size >= (unsigned int)object_db->count);
+
+    mld_destroy_object_db(object_db);
+    CHECK(!object_db->table_size && !object_db->object_db_arr && !object_db->count);
+    printf("object index ok\n");
+    return 0;
+}
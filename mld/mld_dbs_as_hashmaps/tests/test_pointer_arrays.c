@@ -0,0 +1,83 @@
+//fixed & dynamic pointer array fields, elements are followed, the element count is capped at a tracked buffer
+//& an untracked buffer or a garbage length is never read
+
+#include <sys/mman.h>
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+typedef struct Holder {
+    Node *fixed[3];
+    Node **children;
+    unsigned int child_count;
+} Holder;
+
+static Node *node(ObjectDb *object_db){
+    return xcalloc(object_db, "Node", 1);
+}
+
+static Holder *root_holder(ObjectDb *object_db){
+    Holder *holder = xcalloc(object_db, "Holder", 1);
+    set_dynamic_object_as_root("Holder", object_db, holder);
+    return holder;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    static FieldInfo holder_fields[] = {
+        FIELD_INFO(Holder, fixed, OBJECT_pointer_ARRAY_TYPE, Node),
+        FIELD_INFO_DYNAMIC_ARRAY(Holder, children, Node, child_count),
+        FIELD_INFO(Holder, child_count, UINT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Holder, holder_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    //every element of a fixed array & of a tracked buffer is followed, the buffer is typed without pointer fields
+    Holder *holder = root_holder(object_db);
+    for(int i = 0; i < 3; i++) holder->fixed[i] = node(object_db);
+    holder->children = xcalloc(object_db, "double", 4);
+    for(int i = 0; i < 4; i++) holder->children[i] = node(object_db);
+    holder->child_count = 4;
+
+    //length beyond a tracked buffer is capped at the buffer size
+    Holder *capped = root_holder(object_db);
+    capped->children = xcalloc(object_db, "double", 2);
+    capped->children[0] = node(object_db);
+    capped->children[1] = node(object_db);
+    capped->child_count = 1u << 30;
+
+    //untracked buffer right below an inaccessible page, a large length must not read past it, its elements are not followed
+    long page = sysconf(_SC_PAGESIZE);
+    char *pages = mmap(NULL, 2 * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    CHECK(pages != MAP_FAILED);
+    CHECK(mprotect(pages + page, page, PROT_NONE) == 0);
+    Holder *untracked = root_holder(object_db);
+    untracked->children = (Node **)(pages + page - 2 * sizeof(Node *));
+    untracked->children[0] = node(object_db);
+    untracked->child_count = 1u << 20;
+
+    //uninitialized fields, buffer address & length are garbage
+    Holder *garbage = root_holder(object_db);
+    memset(garbage, 0xA5, sizeof(Holder));
+
+    node(object_db);
+    mld_test_scrub_stack();
+
+    run_mld_algorithm(object_db);
+    for(int i = 0; i < 3; i++) CHECK(object_db_lookup(NULL, object_db, holder->fixed[i])->is_visited);
+    CHECK(object_db_lookup(NULL, object_db, holder->children)->is_visited);
+    for(int i = 0; i < 4; i++) CHECK(object_db_lookup(NULL, object_db, holder->children[i])->is_visited);
+    CHECK(object_db_lookup(NULL, object_db, capped->children[0])->is_visited);
+    CHECK(object_db_lookup(NULL, object_db, capped->children[1])->is_visited);
+    CHECK(!object_db_lookup(NULL, object_db, untracked->children[0])->is_visited);
+    CHECK(mld_test_leaked(object_db) == 2);
+    return 0;
+}
@@ -0,0 +1,96 @@
+//mld_preload.c interposition, the library is compiled into the test so its malloc family replaces libc's like LD_PRELOAD does
+//mld-test-cflags: -fno-builtin
+
+#include "../mld_preload.c"
+#include "mld_test.h"
+
+#define THREADS 4
+#define THREAD_BLOCKS 1000
+
+static ObjectDbRecord *tracked(void *pointer){
+    pthread_mutex_lock(&mld_lock);
+    ObjectDbRecord *obj_rec = object_db_lookup(MLD_UNTYPED_BLOCK, mld_object_db, pointer);
+    pthread_mutex_unlock(&mld_lock);
+    return obj_rec;
+}
+
+static void *churn(void *arg){
+    static __thread void *blocks[THREAD_BLOCKS];
+    for(int i = 0; i < THREAD_BLOCKS; i++) blocks[i] = malloc(16 + i);
+    for(int i = 0; i < THREAD_BLOCKS; i += 2) blocks[i] = realloc(blocks[i], 4096 + i);
+    for(int i = 0; i < THREAD_BLOCKS; i++){
+        if(!tracked(blocks[i])) return (void *)1;
+        free(blocks[i]);
+        if(tracked(blocks[i])) return (void *)1;
+    }
+    return NULL;
+}
+
+int main(void){
+    //the first allocation resolves the real allocator
+    char *block = malloc(100);
+    CHECK(block && mld_ready && !is_bootstrap_pointer(block));
+    ObjectDbRecord *obj_rec = tracked(block);
+    CHECK(obj_rec && obj_rec->units == 100 && obj_rec->structure_record == &mld_untyped_record);
+    memset(block, 'a', 100);
+
+    //a resized block keeps its record, which follows the block when it moves
+    uintptr_t old_address = (uintptr_t)block;
+    char *grown = realloc(block, 1 << 20);
+    CHECK(grown && grown[99] == 'a');
+    CHECK(tracked(grown) == obj_rec && obj_rec->units == 1 << 20);
+    if((uintptr_t)grown != old_address) CHECK(!tracked((void *)old_address));
+    char *shrunk = realloc(grown, 10);
+    CHECK(shrunk && tracked(shrunk) == obj_rec && obj_rec->units == 10);
+
+    //realloc of NULL allocates, free & realloc to zero drop the record
+    char *fresh = realloc(NULL, 64);
+    CHECK(fresh && tracked(fresh) && tracked(fresh)->units == 64);
+    free(fresh);
+    CHECK(!tracked(fresh));
+    CHECK(!realloc(shrunk, 0));
+    CHECK(!tracked(shrunk));
+
+    int *zeroed = calloc(8, sizeof(int));
+    CHECK(zeroed && !zeroed[7] && tracked(zeroed)->units == 8 * sizeof(int));
+    free(zeroed);
+    CHECK(!tracked(zeroed));
+
+    void *aligned = NULL;
+    CHECK(posix_memalign(&aligned, 256, 300) == 0 && ((uintptr_t)aligned & 255) == 0);
+    CHECK(tracked(aligned) && tracked(aligned)->units == 300);
+    free(aligned);
+    aligned = aligned_alloc(64, 128);
+    CHECK(aligned && tracked(aligned) && tracked(aligned)->units == 128);
+    free(aligned);
+    CHECK(!tracked(aligned));
+
+    //a bootstrap block handed out while dlsym ran moves to a tracked libc block, its bytes are copied
+    char *early = bootstrap_alloc(32);
+    CHECK(early && is_bootstrap_pointer(early));
+    memcpy(early, "bootstrap", 10);
+    char *moved = realloc(early, 4096);
+    CHECK(moved && !is_bootstrap_pointer(moved) && strcmp(moved, "bootstrap") == 0);
+    CHECK(tracked(moved) && tracked(moved)->units == 4096);
+    CHECK(!tracked(early));
+    free(moved);
+    CHECK(!tracked(moved));
+    char *kept = bootstrap_alloc(16);
+    free(kept);
+    CHECK(is_bootstrap_pointer(kept) && !tracked(kept));
+
+    //the object db's own records never show up as blocks
+    unsigned int count = mld_object_db->count;
+    char *one = malloc(1);
+    CHECK(tracked(one) && mld_object_db->count == count + 1);
+    free(one);
+    CHECK(mld_object_db->count == count);
+
+    pthread_t threads[THREADS];
+    for(int i = 0; i < THREADS; i++) CHECK(pthread_create(&threads[i], NULL, churn, NULL) == 0);
+    for(int i = 0; i < THREADS; i++){
+        void *failed;
+        CHECK(pthread_join(threads[i], &failed) == 0 && !failed);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+//xrealloc follows realloc, NULL allocates the named type, 0 units frees, for record & slab objects
+
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+static int free_errors;
+
+static void count_free_error(const MldFreeError *error, void *user_data){
+    free_errors++;
+}
+
+static long live_objects(void){
+    MldStats stats;
+    mld_get_stats(&stats);
+    return stats.live_objects;
+}
+
+static void check_realloc(ObjectDb *object_db){
+    long live = live_objects();
+    unsigned int count = object_db->count;
+
+    //NULL & 0 units is a no-op
+    CHECK(xrealloc(object_db, "Node", NULL, 0) == NULL);
+    CHECK(live_objects() == live && object_db->count == count);
+
+    //NULL allocates a tracked object of the named type
+    Node *nodes = xrealloc(object_db, "Node", NULL, 4);
+    CHECK(nodes);
+    ObjectDbRecord *obj_rec = object_db_lookup(NULL, object_db, nodes);
+    CHECK(obj_rec && obj_rec->units == 4 && !strcmp(obj_rec->structure_record->structure_name, "Node"));
+    CHECK(live_objects() == live + 1);
+    for(int i = 0; i < 4; i++) nodes[i].value = i;
+
+    //grow & shrink keep the contents
+    nodes = xrealloc(object_db, "Node", nodes, 64);
+    for(int i = 0; i < 4; i++) CHECK(nodes[i].value == i);
+    CHECK(object_db_lookup(NULL, object_db, nodes)->units == 64);
+    nodes = xrealloc(object_db, "Node", nodes, 2);
+    CHECK(nodes[0].value == 0 && nodes[1].value == 1);
+
+    //0 units frees the object & drops its record, a second free is a double free
+    CHECK(xrealloc(object_db, "Node", nodes, 0) == NULL);
+    CHECK(!object_db_lookup(NULL, object_db, nodes));
+    CHECK(live_objects() == live && object_db->count == count);
+    CHECK(free_errors == 0);
+    xfree("Node", object_db, nodes);
+    CHECK(free_errors == 1);
+
+    //a single unit object, from a slab when the slab heap is enabled
+    Node *node = xcalloc(object_db, "Node", 1);
+    CHECK(live_objects() == live + 1);
+    CHECK(xrealloc(object_db, "Node", node, 1) == node);
+    CHECK(xrealloc(object_db, "Node", node, 0) == NULL);
+    CHECK(live_objects() == live && object_db->count == count);
+    CHECK(free_errors == 1);
+    xfree("Node", object_db, node);
+    CHECK(free_errors == 2);
+
+    run_mld_algorithm(object_db);
+    CHECK(mld_test_leaked(object_db) == 0);
+    free_errors = 0;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    mld_set_free_error_handler(object_db, count_free_error, NULL);
+    check_realloc(object_db);
+
+    ObjectDb *slab_db = mld_test_object_db(struct_db);
+    mld_enable_slab_heap(slab_db);
+    mld_set_free_error_handler(slab_db, count_free_error, NULL);
+    check_realloc(slab_db);
+    Node *node = xcalloc(slab_db, "Node", 1);
+    CHECK(!object_db_lookup(NULL, slab_db, node));
+    CHECK(xrealloc(slab_db, "Node", node, 0) == NULL);
+    CHECK(mld_slab_leaked_objects(slab_db) == 0);
+    return 0;
+}
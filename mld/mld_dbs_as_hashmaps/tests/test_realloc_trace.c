@@ -0,0 +1,4 @@
+//test_realloc.c against the TRACE build of mld.c
+//mld-test-cflags: -DTRACE
+
+#include "test_realloc.c"
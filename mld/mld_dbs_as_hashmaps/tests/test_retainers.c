@@ -0,0 +1,75 @@
+//retained sizes, dominators of a small known graph & of a long chain spread over a sparse address range
+
+#include "mld_test.h"
+
+#define CHAIN 50000
+#define BIG_BLOCKS 64
+
+typedef struct Node {
+    struct Node *left, *right;
+    int value;
+} Node;
+
+static Node *node(ObjectDb *object_db, Node *left, Node *right){
+    Node *n = xmalloc(object_db, "Node", 1);
+    n->left = left;
+    n->right = right;
+    return n;
+}
+
+static int find(MldRetainer *top, int count, void *pointer){
+    for(int i = 0; i < count; i++) if(top[i].pointer == pointer) return i;
+    return -1;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, left, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, right, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+
+    /*
+    r -> a, b   a -> c, d   b -> d   c -> e   e -> c
+    d has two parents so its idom is r, c & e are only reachable through a
+    */
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    Node *e = node(object_db, NULL, NULL), *c = node(object_db, e, NULL), *d = node(object_db, NULL, NULL);
+    e->left = c;
+    Node *a = node(object_db, c, d), *b = node(object_db, d, NULL), *r = node(object_db, a, b);
+    node(object_db, a, r); //unreachable, not part of the tree
+    set_dynamic_object_as_root("Node", object_db, r);
+
+    MldRetainer top[16];
+    int count = mld_compute_top_retainers(object_db, top, 16);
+    CHECK(count == 6);
+    for(int i = 1; i < count; i++) CHECK(top[i - 1].retained_bytes >= top[i].retained_bytes);
+    CHECK(top[0].pointer == r && top[0].retained_objects == 6 && top[0].retained_bytes == 6 * sizeof(Node));
+    CHECK(top[1].pointer == a && top[1].retained_objects == 3);
+    CHECK(top[2].pointer == c && top[2].retained_objects == 2);
+    CHECK(top[find(top, count, b)].retained_objects == 1);
+    CHECK(top[find(top, count, d)].retained_objects == 1);
+    CHECK(top[find(top, count, e)].retained_objects == 1);
+    CHECK(mld_compute_top_retainers(object_db, top, 2) == 2 && top[1].pointer == a);
+
+    //large untyped blocks between the chain links stretch the address span far beyond the node count
+    ObjectDb *chain_db = mld_test_object_db(struct_db);
+    static Node *links[CHAIN];
+    for(int i = 0; i < CHAIN; i++){
+        links[i] = node(chain_db, NULL, NULL);
+        if(i) links[i - 1]->left = links[i];
+        if(i % (CHAIN / BIG_BLOCKS) == 0) CHECK(xmalloc(chain_db, "int", 1 << 18));
+    }
+    set_dynamic_object_as_root("Node", chain_db, links[0]);
+
+    count = mld_compute_top_retainers(chain_db, top, 3);
+    CHECK(count == 3);
+    for(int i = 0; i < count; i++){
+        CHECK(top[i].pointer == links[i]);
+        CHECK(top[i].retained_objects == (uint64_t)(CHAIN - i));
+        CHECK(top[i].retained_bytes == (uint64_t)(CHAIN - i) * sizeof(Node));
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+//root discovery, objects held by globals & stacks are kept, every unreachable object is reported
+
+#include <pthread.h>
+#include <semaphore.h>
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    long value;
+} Node;
+
+static ObjectDb *object_db;
+static Node *global_head;
+static sem_t worker_ready;
+static volatile int worker_done;
+
+static __attribute__((noinline)) void allocate_unreachable(int count){
+    for(int i = 0; i < count; i++){
+        int *value = xmalloc(object_db, "int", 1);
+        *value = i;
+    }
+}
+
+static Node *new_node(Node *next){
+    Node *node = xmalloc(object_db, "Node", 1);
+    node->next = next;
+    node->value = 0;
+    return node;
+}
+
+static void *worker(void *arg){
+    mld_register_thread();
+    Node *volatile held = new_node(new_node(NULL));
+    sem_post(&worker_ready);
+    while(!worker_done);
+    (void)held;
+    mld_unregister_thread();
+    return NULL;
+}
+
+//stopped at any point of malloc & free, the scan must still complete
+static void *allocating_worker(void *arg){
+    mld_register_thread();
+    while(!worker_done) free(malloc(64 + (rand() & 1023)));
+    mld_unregister_thread();
+    return NULL;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    object_db = mld_test_object_db(struct_db);
+    mld_enable_root_discovery(object_db, MLD_ROOTS_DATA | MLD_ROOTS_STACKS);
+
+    //the workers are started first, so no register they inherit holds an object
+    sem_init(&worker_ready, 0, 0);
+    pthread_t thread;
+    CHECK(!pthread_create(&thread, NULL, worker, NULL));
+    sem_wait(&worker_ready);
+    pthread_t allocating;
+    CHECK(!pthread_create(&allocating, NULL, allocating_worker, NULL));
+    global_head = new_node(new_node(NULL));
+    Node *volatile local = new_node(NULL);
+
+    //the scan's own state must not keep the lowest & highest of the unreachable objects alive
+    allocate_unreachable(5);
+    mld_test_scrub_stack();
+    run_mld_algorithm(object_db);
+    CHECK(object_db->count == 10);
+    CHECK(mld_test_leaked(object_db) == 5);
+    CHECK(object_db_lookup(NULL, object_db, global_head->next)->is_visited);
+    CHECK(object_db_lookup(NULL, object_db, local)->is_visited);
+
+    mld_test_scrub_stack();
+    mld_run_full_scan(object_db);
+    CHECK(mld_test_leaked(object_db) == 5);
+
+    for(int i = 0; i < 50; i++){
+        mld_run_full_scan(object_db);
+        CHECK(mld_test_leaked(object_db) == 5);
+    }
+
+    worker_done = 1;
+    pthread_join(thread, NULL);
+    pthread_join(allocating, NULL);
+    (void)local;
+    printf("root discovery ok\n");
+    return 0;
+}
@@ -0,0 +1,103 @@
+//slab heap, per type slabs, marking across slab & record objects, free errors on slab objects & xrealloc out of a slab
+
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+typedef struct Holder {
+    Node **children;
+    unsigned int child_count;
+} Holder;
+
+static MldFreeError last_error;
+static int free_errors;
+
+static void record_free_error(const MldFreeError *error, void *user_data){
+    last_error = *error;
+    free_errors++;
+}
+
+static int same_slab(void *a, void *b){
+    return ((uintptr_t)a >> MLD_SLAB_SHIFT) == ((uintptr_t)b >> MLD_SLAB_SHIFT);
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    static FieldInfo holder_fields[] = {
+        FIELD_INFO_DYNAMIC_ARRAY(Holder, children, Node, child_count),
+        FIELD_INFO(Holder, child_count, UINT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Holder, holder_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    mld_enable_slab_heap(object_db);
+    mld_set_free_error_handler(object_db, record_free_error, NULL);
+
+    //single unit objects of a type share a slab & have no object record, multi unit objects keep a record
+    Node *root = xcalloc(object_db, "Node", 1);
+    set_dynamic_object_as_root("Node", object_db, root);
+    Node *a = xcalloc(object_db, "Node", 1);
+    root->next = a;
+    Node *array = xcalloc(object_db, "Node", 3);
+    a->next = array;
+    Node *b = xcalloc(object_db, "Node", 1);
+    array[2].next = b;
+    Node *leaked_to_root = xcalloc(object_db, "Node", 1);
+    leaked_to_root->next = root;
+    Node *moved = xcalloc(object_db, "Node", 1);
+    CHECK(same_slab(root, a) && same_slab(a, b));
+    CHECK(!object_db_lookup(NULL, object_db, a) && object_db_lookup(NULL, object_db, array));
+    CHECK(object_db->count == 1);
+
+    //free errors on slab objects
+    Node *freed = xcalloc(object_db, "Node", 1);
+    xfree("Node", object_db, freed);
+    xfree("Node", object_db, freed);
+    CHECK(free_errors == 1 && last_error.kind == MLD_DOUBLE_FREE && last_error.pointer == freed);
+    xfree("Node", object_db, (char *)a + 8);
+    CHECK(free_errors == 2 && last_error.kind == MLD_INTERIOR_FREE && last_error.object == a);
+    CHECK(!strcmp(last_error.structure_name, "Node"));
+
+    //a single unit xrealloc stays in place, a larger one moves the object into a record
+    CHECK(xrealloc(object_db, "Node", moved, 1) == moved);
+    moved->value = 42;
+    moved = xrealloc(object_db, "Node", moved, 4);
+    CHECK(moved->value == 42);
+    ObjectDbRecord *moved_rec = object_db_lookup(NULL, object_db, moved);
+    CHECK(moved_rec && moved_rec->units == 4);
+    CHECK(object_db->count == 2);
+
+    //marks flow slab -> record -> slab, leaks are found in both
+    run_mld_algorithm(object_db);
+    CHECK(object_db_lookup(NULL, object_db, array)->is_visited);
+    CHECK(!moved_rec->is_visited);
+    CHECK(mld_slab_leaked_objects(object_db) == 1);
+    CHECK(mld_test_leaked(object_db) == 2);
+
+    //freed slab slots are reused & a rescan forgets the freed leaks
+    xfree("Node", object_db, leaked_to_root);
+    xfree("Node", object_db, moved);
+    run_mld_algorithm(object_db);
+    CHECK(mld_slab_leaked_objects(object_db) == 0 && mld_test_leaked(object_db) == 0);
+    Node *reused = xcalloc(object_db, "Node", 1);
+    CHECK(same_slab(reused, root) && !reused->next);
+
+    //a single unit buffer of a dynamic pointer array lives in a slab, its element is followed & its length capped at the slot
+    Holder *holder = xcalloc(object_db, "Holder", 2);
+    set_dynamic_object_as_root("Holder", object_db, holder);
+    holder->children = xcalloc(object_db, "double", 1);
+    holder->children[0] = xcalloc(object_db, "Node", 1);
+    holder->child_count = 1000;
+    CHECK(!object_db_lookup(NULL, object_db, holder->children));
+    run_mld_algorithm(object_db);
+    CHECK(mld_slab_leaked_objects(object_db) == 1);
+    CHECK(free_errors == 2);
+    return 0;
+}
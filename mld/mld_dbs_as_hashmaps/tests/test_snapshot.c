@@ -0,0 +1,158 @@
+//heap snapshots, written & reopened, marked in place, corrupt files refused
+
+#include <stddef.h>
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    struct Node *kids[2];
+    int value;
+} Node;
+
+typedef struct Inner {
+    int tag;
+    Node *child;
+} Inner;
+
+typedef struct Outer {
+    int tag;
+    Inner inner[2];
+} Outer;
+
+typedef struct Holder {
+    Node **children;
+    unsigned int child_count;
+} Holder;
+
+static const char *path = "/tmp/mld_test_snapshot.bin";
+static const char *corrupt_path = "/tmp/mld_test_snapshot_corrupt.bin";
+
+static void read_file(const char *name, char **data, size_t *size){
+    FILE *file = fopen(name, "rb");
+    CHECK(file);
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    rewind(file);
+    *data = malloc(*size);
+    CHECK(*data && fread(*data, 1, *size, file) == *size);
+    fclose(file);
+}
+
+//writes a copy of the snapshot with size bytes at offset replaced by value, returns whether it still opens
+static int opens_with(const char *data, size_t size, size_t offset, const void *value, size_t value_size){
+    FILE *file = fopen(corrupt_path, "wb");
+    CHECK(file);
+    CHECK(fwrite(data, 1, size, file) == size);
+    CHECK(!fseek(file, offset, SEEK_SET) && fwrite(value, 1, value_size, file) == value_size);
+    fclose(file);
+    MldSnapshot snapshot;
+    int opened = !mld_snapshot_open(corrupt_path, &snapshot);
+    if(opened) mld_snapshot_close(&snapshot);
+    return opened;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, kids, OBJECT_pointer_ARRAY_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    static FieldInfo inner_fields[] = {
+        FIELD_INFO(Inner, tag, INT32_TYPE, 0),
+        FIELD_INFO(Inner, child, OBJECT_pointer_TYPE, Node)
+    };
+    REGISTER_STRUCTURE(struct_db, Inner, inner_fields);
+    static FieldInfo outer_fields[] = {
+        FIELD_INFO(Outer, tag, INT32_TYPE, 0),
+        FIELD_INFO(Outer, inner, OBJECT_STRUCT_TYPE, Inner)
+    };
+    REGISTER_STRUCTURE(struct_db, Outer, outer_fields);
+    static FieldInfo holder_fields[] = {
+        FIELD_INFO_DYNAMIC_ARRAY(Holder, children, Node, child_count),
+        FIELD_INFO(Holder, child_count, UINT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Holder, holder_fields);
+
+    //a name of the maximum length is kept NUL terminated
+    StructureDbRecord *long_name = calloc(1, sizeof(StructureDbRecord));
+    CHECK(long_name);
+    memset(long_name->structure_name, 'x', MAX_STRUCTURE_NAME_LENGTH - 1);
+    long_name->structure_size = 8;
+    CHECK(!add_structure_to_database(struct_db, long_name));
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    Node *root = xcalloc(object_db, "Node", 1);
+    set_dynamic_object_as_root("Node", object_db, root);
+    root->next = xcalloc(object_db, "Node", 1);
+    root->kids[1] = xcalloc(object_db, "Node", 2);
+    root->kids[1][1].next = xcalloc(object_db, "Node", 1);
+    Node *lost = xcalloc(object_db, "Node", 1);
+    lost->next = xcalloc(object_db, "Node", 1);
+    xcalloc(object_db, long_name->structure_name, 1);
+
+    //nested structures are followed offline as they are in process
+    Outer *outer = xcalloc(object_db, "Outer", 2);
+    set_dynamic_object_as_root("Outer", object_db, outer);
+    outer[1].inner[1].child = xcalloc(object_db, "Node", 1);
+
+    //elements of a dynamic pointer array too, the length is capped at the buffer
+    Holder *holder = xcalloc(object_db, "Holder", 1);
+    set_dynamic_object_as_root("Holder", object_db, holder);
+    holder->children = xcalloc(object_db, "double", 2);
+    holder->children[1] = xcalloc(object_db, "Node", 1);
+    holder->child_count = 1u << 30;
+    run_mld_algorithm(object_db);
+    long leaked = mld_test_leaked(object_db);
+    CHECK(leaked == 3);
+
+    CHECK(!mld_snapshot_write(object_db, path, MLD_TRUE));
+    MldSnapshot snapshot;
+    CHECK(!mld_snapshot_open(path, &snapshot));
+    CHECK(snapshot.header->object_count == (uint64_t)object_db->count);
+    CHECK(mld_snapshot_run_mld_algorithm(&snapshot) == (unsigned long)leaked);
+    MldSnapshotObject *found = mld_snapshot_lookup(&snapshot, (uintptr_t)lost->next);
+    CHECK(found && !found->is_visited);
+    found = mld_snapshot_lookup(&snapshot, (uintptr_t)root->kids[1][1].next);
+    CHECK(found && found->is_visited);
+    found = mld_snapshot_lookup(&snapshot, (uintptr_t)outer[1].inner[1].child);
+    CHECK(found && found->is_visited);
+    found = mld_snapshot_lookup(&snapshot, (uintptr_t)holder->children[1]);
+    CHECK(found && found->is_visited);
+    for(uint64_t i = 0; i < snapshot.header->struct_count; i++)
+        CHECK(strlen(snapshot.structs[i].structure_name) < MAX_STRUCTURE_NAME_LENGTH);
+    MldSnapshotHeader header = *snapshot.header;
+    mld_snapshot_close(&snapshot);
+
+    //corrupt copies are refused
+    char *data;
+    size_t size;
+    read_file(path, &data, &size);
+    uint64_t huge = 1ull << 40;
+    uint32_t bad_index = (uint32_t)header.struct_count, bad_offset = 1u << 30;
+    CHECK(opens_with(data, size, 0, &header.magic, sizeof(header.magic)));
+    CHECK(!opens_with(data, size, offsetof(MldSnapshotHeader, object_count), &huge, sizeof(huge)));
+    CHECK(!opens_with(data, size, offsetof(MldSnapshotHeader, field_offset), &huge, sizeof(huge)));
+    CHECK(!opens_with(data, size, header.object_offset + offsetof(MldSnapshotObject, struct_index), &bad_index, sizeof(bad_index)));
+    CHECK(!opens_with(data, size, header.object_offset + offsetof(MldSnapshotObject, contents), &huge, sizeof(huge)));
+    CHECK(!opens_with(data, size, header.object_offset + offsetof(MldSnapshotObject, site_index), &bad_offset, sizeof(bad_offset)));
+    CHECK(!opens_with(data, size, header.struct_offset + offsetof(MldSnapshotStruct, first_field), &bad_offset, sizeof(bad_offset)));
+    CHECK(!opens_with(data, size, header.field_offset + offsetof(MldSnapshotField, offset), &bad_offset, sizeof(bad_offset)));
+    CHECK(header.pointer_offset_count && !opens_with(data, size, header.pointer_offset_offset, &bad_offset, sizeof(bad_offset)));
+    uint32_t bad_length_size = 3;
+    CHECK(header.pointer_array_count && !opens_with(data, size, header.pointer_array_offset + offsetof(MldSnapshotPointerArray, length_size),
+                                                    &bad_length_size, sizeof(bad_length_size)));
+
+    //truncated file
+    FILE *file = fopen(corrupt_path, "wb");
+    CHECK(file && fwrite(data, 1, size / 2, file) == size / 2);
+    fclose(file);
+    CHECK(mld_snapshot_open(corrupt_path, &snapshot));
+
+    free(data);
+    unlink(path);
+    unlink(corrupt_path);
+    printf("snapshot ok\n");
+    return 0;
+}
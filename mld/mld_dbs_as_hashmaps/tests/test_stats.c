@@ -0,0 +1,101 @@
+//leak statistics, per thread counters polled while other threads allocate & the overflow slot shared past MLD_MAX_STATS_TYPES
+
+#include <pthread.h>
+#include "mld_test.h"
+
+#define THREADS 4
+#define ROUNDS 20000
+#define EXTRA_TYPES (MLD_MAX_STATS_TYPES + 44)
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+static int running;
+
+//every thread has its own object db, the counters they update are shared by all of them
+static void *churn(void *arg){
+    ObjectDb *object_db = mld_test_object_db(arg);
+    Node *kept[8] = {0};
+    for(int i = 0; i < ROUNDS; i++){
+        Node *node = xcalloc(object_db, "Node", 1);
+        if(i % 8 == 0 && !kept[i / 8 % 8]) kept[i / 8 % 8] = node;
+        else xfree("Node", object_db, node);
+    }
+    return NULL;
+}
+
+//polls race with the counter updates, their sums are only approximate, but types & names never change under them
+static void *poll_stats(void *arg){
+    const MldStats *before = arg;
+    static MldStats stats;
+    while(__atomic_load_n(&running, __ATOMIC_ACQUIRE)){
+        mld_get_stats(&stats);
+        if(stats.type_count != before->type_count) return (void *)1;
+        for(unsigned int i = 0; i < stats.type_count; i++){
+            if(strcmp(stats.types[i].structure_name, before->types[i].structure_name) != 0) return (void *)1;
+        }
+    }
+    return NULL;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    StructureDbRecord *node_rec = struct_db_lookup(struct_db, "Node");
+
+    static MldStats before;
+    mld_get_stats(&before);
+    CHECK(before.type_count < MLD_MAX_STATS_TYPES);
+    CHECK(strcmp(before.types[node_rec->stats_index].structure_name, "Node") == 0);
+
+    __atomic_store_n(&running, 1, __ATOMIC_RELEASE);
+    pthread_t poller, threads[THREADS];
+    CHECK(pthread_create(&poller, NULL, poll_stats, &before) == 0);
+    for(int i = 0; i < THREADS; i++) CHECK(pthread_create(&threads[i], NULL, churn, struct_db) == 0);
+    for(int i = 0; i < THREADS; i++) CHECK(pthread_join(threads[i], NULL) == 0);
+    __atomic_store_n(&running, 0, __ATOMIC_RELEASE);
+    void *failed;
+    CHECK(pthread_join(poller, &failed) == 0 && !failed);
+
+    //objects freed by their own thread cancel out, 8 nodes are kept by each thread
+    static MldStats after;
+    mld_get_stats(&after);
+    CHECK(after.total_allocs - before.total_allocs == THREADS * ROUNDS);
+    CHECK(after.total_frees - before.total_frees == THREADS * (ROUNDS - 8));
+    CHECK(after.types[node_rec->stats_index].live_objects == THREADS * 8);
+    CHECK(after.types[node_rec->stats_index].live_bytes == THREADS * 8 * (long)sizeof(Node));
+
+    //types past the owned slots share the overflow slot, totals still add up
+    static StructureDbRecord extra[EXTRA_TYPES];
+    for(int i = 0; i < EXTRA_TYPES; i++){
+        snprintf(extra[i].structure_name, MAX_STRUCTURE_NAME_LENGTH, "Extra%d", i);
+        extra[i].structure_size = 16;
+        CHECK(add_structure_to_database(struct_db, &extra[i]) == 0);
+        CHECK(extra[i].stats_index <= MLD_STATS_OVERFLOW_SLOT);
+    }
+    StructureDbRecord *last = &extra[EXTRA_TYPES - 1];
+    CHECK(last->stats_index == MLD_STATS_OVERFLOW_SLOT);
+    CHECK(extra[EXTRA_TYPES - 2].stats_index == MLD_STATS_OVERFLOW_SLOT);
+
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    xcalloc(object_db, last->structure_name, 3);
+    xcalloc(object_db, extra[EXTRA_TYPES - 2].structure_name, 1);
+    void *owned = xcalloc(object_db, extra[0].structure_name, 1);
+    static MldStats full;
+    mld_get_stats(&full);
+    CHECK(full.type_count == MLD_MAX_STATS_TYPES);
+    CHECK(strcmp(full.types[MLD_STATS_OVERFLOW_SLOT].structure_name, MLD_STATS_OVERFLOW_NAME) == 0);
+    CHECK(full.types[MLD_STATS_OVERFLOW_SLOT].live_objects == 2);
+    CHECK(full.types[MLD_STATS_OVERFLOW_SLOT].live_bytes == 4 * 16);
+    CHECK(strcmp(full.types[extra[0].stats_index].structure_name, "Extra0") == 0);
+    CHECK(full.types[extra[0].stats_index].live_objects == 1);
+    CHECK(full.live_objects == after.live_objects + 3);
+    xfree(extra[0].structure_name, object_db, owned);
+    return 0;
+}
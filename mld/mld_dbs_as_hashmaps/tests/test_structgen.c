@@ -0,0 +1,72 @@
+//mld_structgen output for tests/structgen_types.h, every generated record must match the compiler's layout
+//mld-test-structgen: tests/structgen_types.h
+
+#include <stddef.h>
+#include "mld_test.h"
+#include "structgen_types.h"
+
+static FieldInfo *field(StructureDbRecord *struct_rec, const char *field_name){
+    for(unsigned int i = 0; i < struct_rec->field_count; i++){
+        if(strcmp(struct_rec->fields[i].field_name, field_name) == 0) return &struct_rec->fields[i];
+    }
+    return NULL;
+}
+
+#define CHECK_FIELD(struct_rec, s, member, type, nested)                                          \
+    do{                                                                                          \
+        FieldInfo *info = field(struct_rec, #member);                                            \
+        CHECK(info && info->offset == offsetof(s, member) && info->size == sizeof(((s *)0)->member)); \
+        CHECK(info->data_type == (type) && strcmp(info->nested_structure_name, nested) == 0);  \
+    }while(0)
+
+int main(void){
+    //the generated registration replaces init_primitive_data_types_support
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    CHECK(struct_db);
+    mld_register_generated_structures(struct_db);
+    CHECK(struct_db->count == 6 && struct_db->perfect_slots && struct_db->perfect_count == struct_db->count);
+    CHECK(struct_db_lookup(struct_db, "int")->structure_size == sizeof(int));
+    CHECK(struct_db_lookup(struct_db, "double")->structure_size == sizeof(double));
+    CHECK(!struct_db_lookup(struct_db, "Missing"));
+
+    StructureDbRecord *point_rec = struct_db_lookup(struct_db, "Point");
+    CHECK(point_rec && point_rec->structure_size == sizeof(Point) && point_rec->field_count == 2);
+    CHECK_FIELD(point_rec, Point, x, DOUBLE_TYPE, "");
+    CHECK_FIELD(point_rec, Point, y, DOUBLE_TYPE, "");
+
+    //bit fields are left out, function pointers are opaque pointers
+    StructureDbRecord *segment_rec = struct_db_lookup(struct_db, "Segment");
+    CHECK(segment_rec && segment_rec->structure_size == sizeof(Segment) && segment_rec->field_count == 6);
+    CHECK_FIELD(segment_rec, Segment, label, CHAR_TYPE, "");
+    CHECK_FIELD(segment_rec, Segment, ends, OBJECT_STRUCT_TYPE, "Point");
+    CHECK_FIELD(segment_rec, Segment, next, OBJECT_pointer_TYPE, "Segment");
+    CHECK_FIELD(segment_rec, Segment, shape, OBJECT_pointer_TYPE, "Shape");
+    CHECK_FIELD(segment_rec, Segment, draw, VOID_pointer_TYPE, "");
+    CHECK_FIELD(segment_rec, Segment, color, UINT32_TYPE, "");
+    CHECK(!field(segment_rec, "flags"));
+
+    //an untypedef'd struct is registered under its tag, unions are left out
+    StructureDbRecord *shape_rec = struct_db_lookup(struct_db, "Shape");
+    CHECK(shape_rec && shape_rec->structure_size == sizeof(struct Shape) && shape_rec->field_count == 8);
+    CHECK_FIELD(shape_rec, struct Shape, name, VOID_pointer_TYPE, "");
+    CHECK_FIELD(shape_rec, struct Shape, first, OBJECT_pointer_TYPE, "Segment");
+    CHECK_FIELD(shape_rec, struct Shape, last, OBJECT_pointer_TYPE, "Segment");
+    CHECK_FIELD(shape_rec, struct Shape, origin, OBJECT_STRUCT_TYPE, "Point");
+    CHECK_FIELD(shape_rec, struct Shape, corners, OBJECT_pointer_ARRAY_TYPE, "Segment");
+    CHECK_FIELD(shape_rec, struct Shape, extra, VOID_pointer_TYPE, "");
+    CHECK_FIELD(shape_rec, struct Shape, scale, FLOAT_TYPE, "");
+    CHECK(field(shape_rec, "area") && field(shape_rec, "area")->offset == offsetof(struct Shape, area));
+    CHECK(!field(shape_rec, "value"));
+
+    //a shape reached only through a segment's pointer field is not a leak
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+    Segment *segment = xcalloc(object_db, "Segment", 1);
+    segment->shape = xcalloc(object_db, "Shape", 1);
+    segment->shape->corners[3] = xcalloc(object_db, "Segment", 1);
+    set_dynamic_object_as_root("Segment", object_db, segment);
+    segment = NULL;
+    mld_test_scrub_stack();
+    run_mld_algorithm(object_db);
+    CHECK(mld_test_leaked(object_db) == 0);
+    return 0;
+}
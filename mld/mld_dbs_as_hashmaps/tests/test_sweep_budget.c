@@ -0,0 +1,84 @@
+//lazy sweep budget, every record looked at costs a unit, steps free at most their budget & xrealloc steps the sweep
+
+#include "mld_test.h"
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+#define KEPT 3000
+#define GARBAGE 5000
+
+static unsigned int empty_buckets(ObjectDb *object_db){
+    unsigned int empty = 0;
+    for(unsigned int i = 0; i < object_db->table_size; i++){
+        if(!object_db->object_db_arr[i]) empty++;
+    }
+    return empty;
+}
+
+int main(void){
+    StructureDb *struct_db = mld_test_struct_db();
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = mld_test_object_db(struct_db);
+
+    Node *root = xcalloc(object_db, "Node", 1);
+    set_dynamic_object_as_root("Node", object_db, root);
+    Node *tail = root;
+    for(int i = 0; i < KEPT; i++){
+        tail->next = xcalloc(object_db, "Node", 1);
+        tail = tail->next;
+    }
+    for(int i = 0; i < GARBAGE; i++) xcalloc(object_db, "Node", 1);
+    mld_test_scrub_stack();
+
+    //budget of one, a step looks at one record or one empty bucket, kept records cost as much as freed ones
+    unsigned int expected_steps = (unsigned int)object_db->count + empty_buckets(object_db);
+    mld_collect(object_db);
+    unsigned int steps = 0;
+    unsigned long freed = object_db->sweep.freed_objects;
+    while(object_db->sweep.pending){
+        mld_sweep_step(object_db, 1);
+        CHECK(object_db->sweep.freed_objects - freed <= 1);
+        freed = object_db->sweep.freed_objects;
+        steps++;
+    }
+    CHECK(steps == expected_steps);
+    CHECK(object_db->sweep.freed_objects == GARBAGE);
+    CHECK(object_db->count == KEPT + 1);
+
+    //larger budgets free at most their budget per step & the sweep still completes
+    for(int i = 0; i < GARBAGE; i++) xcalloc(object_db, "Node", 1);
+    mld_test_scrub_stack();
+    mld_collect(object_db);
+    freed = object_db->sweep.freed_objects;
+    while(object_db->sweep.pending){
+        mld_sweep_step(object_db, MLD_SWEEP_STEP);
+        CHECK(object_db->sweep.freed_objects - freed <= MLD_SWEEP_STEP);
+        freed = object_db->sweep.freed_objects;
+    }
+    CHECK(object_db->sweep.freed_objects == 2 * GARBAGE);
+    CHECK(object_db->count == KEPT + 1);
+
+    //xrealloc takes a sweep step, the object it resizes is kept even though no root reaches it
+    Node *unreachable = xcalloc(object_db, "Node", 1);
+    unreachable->value = 7;
+    for(int i = 0; i < GARBAGE; i++) xcalloc(object_db, "Node", 1);
+    mld_test_scrub_stack();
+    mld_collect(object_db);
+    freed = object_db->sweep.freed_objects;
+    unreachable = xrealloc(object_db, "Node", unreachable, 2);
+    CHECK(object_db->sweep.freed_objects > freed);
+    CHECK(unreachable->value == 7);
+    mld_finish_sweep(object_db);
+    CHECK(object_db_lookup(NULL, object_db, unreachable));
+    CHECK(object_db->count == KEPT + 2);
+    CHECK(object_db->sweep.freed_objects == 3 * GARBAGE);
+
+    return 0;
+}
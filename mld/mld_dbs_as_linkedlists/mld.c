@@ -104,6 +104,22 @@ ObjectDbRecord *object_db_lookup(ObjectDb *object_db, void *pointer){
     return NULL;
 }
 
+//same as object_db_lookup, but a pointer to any unit of a pool chunk resolves to the chunk record
+ObjectDbRecord *object_db_lookup_containing(ObjectDb *object_db, void *pointer){
+    for(ObjectDbRecord *head = object_db->head; head; head = head->next){
+        if(head->pointer == pointer)
+            return head;
+        if(head->live_slots &&
+           (char *)pointer > (char *)head->pointer &&
+           (char *)pointer < (char *)head->pointer + head->units * head->structure_record->structure_size)
+            return head;
+    }
+    return NULL;
+}
+
+#define MLD_SLOT_IS_LIVE(obj_rec, index) \
+    (!(obj_rec)->live_slots || ((obj_rec)->live_slots[(index) >> 3] & (1u << ((index) & 7))))
+
 #ifdef TRACE
 
 void add_object_to_object_db_with_trace(
@@ -385,6 +401,9 @@ void mld_explore_objects_recursively(ObjectDb *object_db, ObjectDbRecord *parent
     */
 
     for(int i = 0; i < parent_obj_rec->units; i++){
+        //free units of a pool chunk hold stale data, they are not scanned
+        if(!MLD_SLOT_IS_LIVE(parent_obj_rec, i)) continue;
+
         char *parent_obj_ptr = (char *)(parent_obj_rec->pointer) + (i * parent_obj_rec->structure_record->structure_size);
         /*
         explanation of the above code:
@@ -401,7 +420,7 @@ void mld_explore_objects_recursively(ObjectDb *object_db, ObjectDbRecord *parent
 
                 if(!child_obj_address) continue;
 
-                ObjectDbRecord *child_obj_rec = object_db_lookup(object_db, child_obj_address);
+                ObjectDbRecord *child_obj_rec = object_db_lookup_containing(object_db, child_obj_address);
                 assert(child_obj_rec);
 
                 if(!child_obj_rec->is_visited){
@@ -475,6 +494,8 @@ void mld_dump_object_rec_detail(ObjectDbRecord *object_record) {
     int units = object_record->units, obj_index = 0;
 
     for (; obj_index < units; obj_index++) {
+        if(!MLD_SLOT_IS_LIVE(object_record, obj_index)) continue;
+
         char *current_object_ptr = (char *)(object_record->pointer) +
                                    (obj_index * object_record->structure_record->structure_size);
 
@@ -536,3 +557,98 @@ void init_primitive_data_types_support(StructureDb *struct_db){
     REGISTER_STRUCTURE(struct_db, float, NULL);
     REGISTER_STRUCTURE(struct_db, double, NULL);
 }
+
+/*typed object pools*/
+
+MldPool *mld_pool_create(ObjectDb *object_db, char *structure_name, unsigned int chunk_units){
+    StructureDbRecord *structure_record = struct_db_lookup(object_db->struct_db, structure_name);
+    assert(structure_record);
+    assert(chunk_units);
+
+    MldPool *pool = calloc(1, sizeof(MldPool));
+    pool->object_db = object_db;
+    pool->structure_record = structure_record;
+    pool->chunk_units = chunk_units;
+    return pool;
+}
+
+static MldPoolChunk *mld_pool_add_chunk(MldPool *pool){
+    void *units = calloc(pool->chunk_units, pool->structure_record->structure_size);
+    if(!units) {
+        printf("Memory allocation failed.\n");
+        exit(1);
+    }
+
+    //one object record for the whole chunk
+    add_object_to_object_db(pool->object_db, units, pool->chunk_units, pool->structure_record, MLD_FALSE);
+
+    MldPoolChunk *chunk = calloc(1, sizeof(MldPoolChunk));
+    chunk->object_record = pool->object_db->head;
+    chunk->object_record->live_slots = calloc((pool->chunk_units + 7) / 8, 1);
+
+    chunk->next = pool->chunks;
+    pool->chunks = chunk;
+    return chunk;
+}
+
+void *mld_pool_alloc(MldPool *pool){
+    MldPoolChunk *chunk = pool->chunks;
+    for(; chunk && chunk->live_count == pool->chunk_units; chunk = chunk->next);
+    if(!chunk) chunk = mld_pool_add_chunk(pool);
+
+    unsigned char *live_slots = chunk->object_record->live_slots;
+    unsigned int slot = 0;
+
+    //skip full bytes of the bitmap, then find the free bit
+    while(live_slots[slot >> 3] == 0xFF) slot += 8;
+    while(live_slots[slot >> 3] & (1u << (slot & 7))) slot++;
+    assert(slot < pool->chunk_units);
+
+    live_slots[slot >> 3] |= (1u << (slot & 7));
+    chunk->live_count++;
+
+    char *pointer = (char *)chunk->object_record->pointer + slot * pool->structure_record->structure_size;
+    memset(pointer, 0, pool->structure_record->structure_size);
+    return pointer;
+}
+
+//releases the chunk object & unlinks the chunk, link points at the chunk in the pool list
+static void mld_pool_release_chunk(MldPool *pool, MldPoolChunk **link){
+    MldPoolChunk *chunk = *link;
+    *link = chunk->next;
+    free(chunk->object_record->live_slots);
+    chunk->object_record->live_slots = NULL;
+    xfree(pool->object_db, chunk->object_record->pointer);
+    free(chunk);
+}
+
+void mld_pool_free(MldPool *pool, void *pointer){
+    if(!pointer) return;
+
+    unsigned int size = pool->structure_record->structure_size;
+    MldPoolChunk **link = &pool->chunks;
+
+    for(; *link; link = &(*link)->next){
+        char *first = (*link)->object_record->pointer;
+        if((char *)pointer >= first && (char *)pointer < first + pool->chunk_units * size)
+            break;
+    }
+    MldPoolChunk *chunk = *link;
+    assert(chunk);
+
+    unsigned int slot = ((char *)pointer - (char *)chunk->object_record->pointer) / size;
+    assert(chunk->object_record->live_slots[slot >> 3] & (1u << (slot & 7)));
+
+    chunk->object_record->live_slots[slot >> 3] &= ~(1u << (slot & 7));
+    chunk->live_count--;
+
+    //an empty chunk is unreachable by construction, kept it would be reported as a leak
+    if(!chunk->live_count) mld_pool_release_chunk(pool, link);
+}
+
+void mld_pool_destroy(MldPool *pool){
+    if(!pool) return;
+
+    while(pool->chunks) mld_pool_release_chunk(pool, &pool->chunks);
+    free(pool);
+}
@@ -112,6 +112,7 @@ struct ObjectDbRecord {
     StructureDbRecord *structure_record; //pointer to the struct record of the object
     MldBoolean is_visited; //used for graph traversal
     MldBoolean is_root; //is this object a root object?
+    unsigned char *live_slots; //pool chunks only, bit i is set if unit i is handed out, NULL for ordinary objects
 };
 
 struct ObjectDb {
@@ -167,6 +168,43 @@ void report_leaked_objects(ObjectDb *object_db);
 
 // void mld_dump_object_rec_detail(ObjectDbRecord *object_record);
 
+/* Typed Object Pool Definition Begin */
+
+/*
+a pool hands out single objects of one structure type from chunks of chunk_units units
+each chunk is one multi-unit object in object db, objects inside it have no object record of their own
+chunk record carries a live slot bitmap, mld algorithm scans only the live units of a chunk
+a chunk is marked as a unit, so it is reported as leaked only if none of its objects is reachable
+a chunk is released as soon as its last object is freed, so an empty chunk is never reported
+*/
+
+typedef struct MldPoolChunk MldPoolChunk;
+
+typedef struct MldPool MldPool;
+
+struct MldPoolChunk {
+    MldPoolChunk *next;
+    ObjectDbRecord *object_record; //chunk object record, pointer is the first unit
+    unsigned int live_count;
+};
+
+struct MldPool {
+    ObjectDb *object_db;
+    StructureDbRecord *structure_record;
+    unsigned int chunk_units;
+    MldPoolChunk *chunks;
+};
+
+MldPool *mld_pool_create(ObjectDb *object_db, char *structure_name, unsigned int chunk_units);
+
+void *mld_pool_alloc(MldPool *pool);
+
+void mld_pool_free(MldPool *pool, void *pointer);
+
+void mld_pool_destroy(MldPool *pool); //frees all chunks, including objects still live in them
+
+/* Typed Object Pool Definition Ends */
+
 #endif
 
 #ifdef TRACE
@@ -0,0 +1,24 @@
+#!/bin/sh
+#builds & runs every tests/test_*.c against mld.c, run from mld/mld_dbs_as_linkedlists
+
+CC=${CC:-gcc}
+OUT=${OUT:-/tmp/mld_linkedlists_tests}
+mkdir -p "$OUT"
+
+failed=0
+for src in tests/test_*.c; do
+    name=$(basename "$src" .c)
+    if ! $CC -O2 -g -o "$OUT/$name" "$src" mld.c; then
+        echo "FAIL $name (build)"
+        failed=$((failed + 1))
+        continue
+    fi
+    if "$OUT/$name" > "$OUT/$name.log" 2>&1; then
+        echo "PASS $name"
+    else
+        echo "FAIL $name, output in $OUT/$name.log"
+        grep -h "check failed" "$OUT/$name.log" || tail -n 5 "$OUT/$name.log"
+        failed=$((failed + 1))
+    fi
+done
+exit $failed
@@ -0,0 +1,90 @@
+//typed object pools, only live slots of a chunk are scanned & a chunk emptied by mld_pool_free is released, not reported
+
+#include "../mld.h"
+
+#define CHECK(cond)                                                                   \
+    do{                                                                               \
+        if(!(cond)){                                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);  \
+            exit(1);                                                                  \
+        }                                                                             \
+    }while(0)
+
+typedef struct Node {
+    struct Node *next;
+    int value;
+} Node;
+
+//record holding pointer, any unit of a pool chunk resolves to the chunk
+static ObjectDbRecord *record_of(ObjectDb *object_db, void *pointer){
+    for(ObjectDbRecord *obj_rec = object_db->head; obj_rec; obj_rec = obj_rec->next){
+        char *first = obj_rec->pointer;
+        if((char *)pointer >= first && (char *)pointer < first + obj_rec->units * obj_rec->structure_record->structure_size)
+            return obj_rec;
+    }
+    return NULL;
+}
+
+static int unvisited(ObjectDb *object_db){
+    int count = 0;
+    for(ObjectDbRecord *obj_rec = object_db->head; obj_rec; obj_rec = obj_rec->next) count += !obj_rec->is_visited;
+    return count;
+}
+
+int main(void){
+    StructureDb *struct_db = calloc(1, sizeof(StructureDb));
+    CHECK(struct_db);
+    init_primitive_data_types_support(struct_db);
+    static FieldInfo node_fields[] = {
+        FIELD_INFO(Node, next, OBJECT_pointer_TYPE, Node),
+        FIELD_INFO(Node, value, INT32_TYPE, 0)
+    };
+    REGISTER_STRUCTURE(struct_db, Node, node_fields);
+    ObjectDb *object_db = calloc(1, sizeof(ObjectDb));
+    CHECK(object_db);
+    object_db->struct_db = struct_db;
+
+    Node *root = xcalloc(object_db, "Node", 1);
+    set_dynamic_object_as_root(object_db, root);
+    MldPool *pool = mld_pool_create(object_db, "Node", 4);
+
+    //a live slot is followed, a freed slot keeps a stale pointer which is not
+    Node *live = mld_pool_alloc(pool);
+    Node *freed = mld_pool_alloc(pool);
+    root->next = live;
+    live->next = xcalloc(object_db, "Node", 1);
+    Node *stale_target = xcalloc(object_db, "Node", 1);
+    freed->next = stale_target;
+    mld_pool_free(pool, freed);
+    CHECK(freed->next == stale_target);
+    CHECK(pool->chunks && pool->chunks->live_count == 1);
+
+    run_mld_algorithm(object_db);
+    CHECK(record_of(object_db, live)->is_visited);
+    CHECK(record_of(object_db, live->next)->is_visited);
+    CHECK(!record_of(object_db, stale_target)->is_visited);
+    CHECK(unvisited(object_db) == 1);
+
+    //a chunk whose last object is freed is released, so it is neither kept nor reported
+    MldPool *emptied = mld_pool_create(object_db, "Node", 2);
+    unsigned int count = object_db->count;
+    Node *first = mld_pool_alloc(emptied);
+    Node *second = mld_pool_alloc(emptied);
+    Node *third = mld_pool_alloc(emptied);
+    CHECK(object_db->count == count + 2);
+    mld_pool_free(emptied, first);
+    mld_pool_free(emptied, second);
+    CHECK(object_db->count == count + 1 && !record_of(object_db, first));
+    mld_pool_free(emptied, third);
+    CHECK(object_db->count == count && !emptied->chunks);
+    run_mld_algorithm(object_db);
+    CHECK(unvisited(object_db) == 1);
+
+    //an emptied pool still hands out objects
+    Node *reused = mld_pool_alloc(emptied);
+    CHECK(reused && object_db->count == count + 1);
+    mld_pool_destroy(emptied);
+    mld_pool_destroy(pool);
+    CHECK(object_db->count == count - 1);
+    return 0;
+}